@@ -0,0 +1,399 @@
+#!/usr/bin/env python3
+"""
+Throughput and latency benchmark for the ST7735 bitmap protocol
+
+Drives the Arduino through BitmapSender over a matrix of display targets,
+frame sizes, encodings, status modes and write chunk sizes, and writes the
+results as JSON so runs against different firmware versions can be compared.
+
+For every case it measures, on the host:
+- time to first pixel: start marker sent until the first flow-control credit
+  comes back (the Arduino returns one per row it has drawn)
+- frame latency: start marker sent until COMPLETE
+- bytes/s of a single frame transfer, and pixels/s actually drawn (delta frames
+  count only their dirty rectangles)
+- sustained fps of a STREAM session running as fast as the link allows
+and reads the Arduino's own counters (CMD:STATS) for the same transfers,
+reset before each case with CMD:STATS_RESET.
+
+Encodings:
+    raw    Full frames, uncompressed
+    rle    Full frames, run-length encoded (SIZE option RLE)
+    delta  Dirty rectangles against the previous frame, run-length encoded
+
+Usage:
+    python3 benchmark.py [serial_port] [options]
+
+Example:
+    python3 benchmark.py /dev/ttyACM0 --targets DueLCD01,DueLCD02 --output fw-3.1.json
+    python3 benchmark.py /dev/ttyACM0 --sizes full --chunk-rows 0,1,8 --status binary,text
+    python3 benchmark.py /dev/ttyACM0 --output new.json --compare fw-3.1.json
+"""
+
+import sys
+import io
+import json
+import time
+import random
+import platform
+import argparse
+import statistics
+import contextlib
+
+from bitmap_sender import BitmapSender
+from st7735_tools.config_loader import get_config_by_device_name
+
+RESULTS_FORMAT = 1
+ENCODINGS = ('raw', 'rle', 'delta')
+STATUS_MODES = ('binary', 'text')
+STATS_TIMEOUT = 3
+
+
+def make_frames(width, height, pattern, seed=1):
+    """
+    Two big-endian RGB565 frames that differ in a box in the middle
+
+    'bars' are vertical color bars (long runs, RLE friendly), 'noise' is
+    random pixels (incompressible). The second frame swaps the box for its
+    inverse, a quarter of the frame size, which delta frames send alone.
+    """
+    if pattern == 'noise':
+        rng = random.Random(seed)
+        frame = bytearray(rng.getrandbits(8) for _ in range(width * height * 2))
+    else:
+        colors = (0xFFFF, 0xFFE0, 0x07FF, 0x07E0, 0xF81F, 0xF800, 0x001F, 0x0000)
+        row = bytearray()
+        for x in range(width):
+            row += colors[x * len(colors) // width].to_bytes(2, 'big')
+        frame = bytearray(row * height)
+
+    changed = bytearray(frame)
+    box_w, box_h = max(1, width // 4), max(1, height // 4)
+    left, top = (width - box_w) // 2, (height - box_h) // 2
+    for y in range(top, top + box_h):
+        start = (y * width + left) * 2
+        changed[start:start + box_w * 2] = bytes(b ^ 0xFF for b in frame[start:start + box_w * 2])
+    return bytes(frame), bytes(changed)
+
+
+def parse_sizes(text):
+    """'full,64x48' -> [None, (64, 48)]; None stands for the usable area"""
+    sizes = []
+    for item in text.split(','):
+        item = item.strip().lower()
+        if item == 'full':
+            sizes.append(None)
+            continue
+        width, height = (int(v) for v in item.split('x'))
+        if width <= 0 or height <= 0:
+            raise ValueError(f"invalid frame size '{item}'")
+        sizes.append((width, height))
+    return sizes
+
+
+def summarize(samples):
+    """min/median/max of a list of numbers (None when empty)"""
+    if not samples:
+        return None
+    return {
+        'min': round(min(samples), 3),
+        'median': round(statistics.median(samples), 3),
+        'max': round(max(samples), 3),
+    }
+
+
+def read_stats(sender):
+    """
+    Read the Arduino's performance counters
+
+    Returns:
+        dict: CMD:STATS counters by name (integers where numeric), or None
+    """
+    connection = sender.connection
+    connection.reset_input_buffer()
+    connection.write(b"CMD:STATS\n")
+    connection.flush()
+
+    stats = None
+    deadline = time.time() + STATS_TIMEOUT
+    while time.time() < deadline:
+        line = connection.readline().decode('utf-8', errors='ignore').strip()
+        if not line:
+            continue
+        if line.endswith("OK:STATS"):
+            stats = {}
+        elif line.startswith("ERROR"):
+            return None
+        elif line == "END_STATS":
+            return stats
+        elif stats is not None and ':' in line:
+            key, value = line.split(':', 1)
+            stats[key] = int(value) if value.isdigit() else value
+    return None
+
+
+def send_command(sender, command, reply):
+    """Send a CMD: line and wait for its reply; returns True if it came"""
+    connection = sender.connection
+    connection.write(f"{command}\n".encode('utf-8'))
+    connection.flush()
+    deadline = time.time() + STATS_TIMEOUT
+    while time.time() < deadline:
+        line = connection.readline().decode('utf-8', errors='ignore').strip()
+        if line.endswith(reply):
+            return True
+    return False
+
+
+class Benchmark:
+    def __init__(self, args):
+        self.args = args
+        self.quiet = not args.verbose
+
+    def log(self, message):
+        print(message, file=sys.stderr)
+
+    @contextlib.contextmanager
+    def sender_output(self):
+        """BitmapSender reports every step; keep that off the terminal unless --verbose"""
+        if self.quiet:
+            with contextlib.redirect_stdout(io.StringIO()):
+                yield
+        else:
+            yield
+
+    def connect(self, target, config, binary_status):
+        group = target[6:] if target.startswith("GROUP:") else None
+        with self.sender_output():
+            sender = BitmapSender(self.args.serial_port, display_config=config, group=group,
+                                  binary_status=binary_status)
+            if not sender.connect():
+                return None
+        # An earlier session may have left a display selected
+        if not send_command(sender, "CMD:RESET", "OK:Protocol reset"):
+            return None
+        return sender
+
+    def run_case(self, sender, case, frames):
+        """Time one case on an open connection; returns its result dict"""
+        width, height = case['width'], case['height']
+        delta = case['encoding'] == 'delta'
+        compress = case['encoding'] != 'raw'
+        sender.write_chunk_rows = case['chunk_rows'] or None
+
+        # First transfer selects the display and gives delta frames a reference
+        with self.sender_output():
+            if not sender.send_frame(width, height, frames[1], delta=False, compress=compress):
+                return dict(case, error="warm-up transfer failed")
+        stats_reset = send_command(sender, "CMD:STATS_RESET", "OK:Stats reset")
+
+        ttfp, latency, rates, pixel_rates, bytes_sent = [], [], [], [], []
+        for index in range(self.args.repeat):
+            pixel_bytes = frames[index % 2]
+            with self.sender_output():
+                ok = sender.send_frame(width, height, pixel_bytes, delta=delta, compress=compress)
+            marks = sender.timings
+            if not ok or 'complete' not in marks:
+                return dict(case, error=f"transfer {index + 1} failed")
+
+            elapsed = marks['complete'] - marks['start']
+            latency.append(elapsed * 1000)
+            if 'first_credit' in marks:
+                ttfp.append((marks['first_credit'] - marks['start']) * 1000)
+            rates.append(sender.last_bytes_sent / elapsed)
+            bytes_sent.append(sender.last_bytes_sent)
+            # Delta frames only draw their dirty rectangles
+            pixel_rates.append(sender.last_pixels_sent / elapsed)
+
+        fps = None
+        if self.args.stream_frames and not sender.group:
+            stream = [frames[index % 2] for index in range(self.args.stream_frames)]
+            start = time.perf_counter()
+            with self.sender_output():
+                ok = sender.send_stream(width, height, stream, 0, delta=delta, compress=compress)
+            if ok:
+                fps = round(len(stream) / (time.perf_counter() - start), 2)
+
+        device = read_stats(sender) if stats_reset else None
+        result = dict(case)
+        result.update({
+            'ttfp_ms': summarize(ttfp),
+            'latency_ms': summarize(latency),
+            'bytes_per_frame': round(statistics.mean(bytes_sent)),
+            'bytes_per_s': round(statistics.median(rates)),
+            'pixels_per_s': round(statistics.median(pixel_rates)),
+            'stream_fps': fps,
+            'device': device,
+        })
+        return result
+
+    def run(self):
+        args = self.args
+        results = []
+        targets = [t.strip() for t in args.targets.split(',') if t.strip()]
+        devices = [t for t in targets if not t.startswith("GROUP:")]
+
+        for target in targets:
+            # A group is sized from the first device benchmarked with it
+            config = get_config_by_device_name(devices[0] if target.startswith("GROUP:") and devices
+                                               else target)
+            if not config:
+                self.log(f"Error: No configuration found for '{target}'")
+                return None
+            sizes = []
+            for size in parse_sizes(args.sizes):
+                width, height = size or (config.usable_width, config.usable_height)
+                if 0 < width <= config.usable_width and 0 < height <= config.usable_height:
+                    sizes.append((width, height))
+                else:
+                    self.log(f"Skipping {width}x{height} on {target}: usable area is "
+                             f"{config.usable_width}x{config.usable_height}")
+
+            for status in args.status.split(','):
+                sender = self.connect(target, config, status == 'binary')
+                if not sender:
+                    self.log(f"Error: Could not connect to {args.serial_port}")
+                    return None
+                try:
+                    for width, height in sizes:
+                        frames = make_frames(width, height, args.pattern)
+                        for encoding in args.encodings.split(','):
+                            for chunk_rows in (int(v) for v in args.chunk_rows.split(',')):
+                                case = {
+                                    'target': target, 'width': width, 'height': height,
+                                    'encoding': encoding, 'status': status,
+                                    'chunk_rows': chunk_rows, 'pattern': args.pattern,
+                                }
+                                result = self.run_case(sender, case, frames)
+                                results.append(result)
+                                self.log(format_result(result))
+                finally:
+                    with self.sender_output():
+                        sender.disconnect()
+        return results
+
+
+def case_key(result):
+    return (result['target'], result['width'], result['height'], result['encoding'],
+            result['status'], result['chunk_rows'], result.get('pattern'))
+
+
+def format_result(result):
+    name = "{target} {width}x{height} {encoding}/{status} chunk={chunk_rows}".format(**result)
+    if 'error' in result:
+        return f"{name}: {result['error']}"
+    ttfp = result['ttfp_ms']['median'] if result['ttfp_ms'] else float('nan')
+    fps = f"{result['stream_fps']:.1f} fps" if result['stream_fps'] else "-"
+    return (f"{name}: first pixel {ttfp:.1f} ms, frame {result['latency_ms']['median']:.1f} ms, "
+            f"{result['bytes_per_s'] / 1024:.1f} KB/s, {fps}")
+
+
+def compare(results, baseline, tolerance):
+    """
+    Print the change of every case against a baseline run
+
+    Returns:
+        int: Number of cases whose frame latency or stream fps got worse by
+             more than tolerance percent
+    """
+    previous = {case_key(r): r for r in baseline.get('results', []) if 'error' not in r}
+    regressions = 0
+    for result in results:
+        old = previous.get(case_key(result))
+        if 'error' in result or not old:
+            continue
+        name = "{target} {width}x{height} {encoding}/{status} chunk={chunk_rows}".format(**result)
+        latency = (result['latency_ms']['median'] / old['latency_ms']['median'] - 1) * 100
+        changes = [f"frame {latency:+.1f}%"]
+        worse = latency > tolerance
+        if result['stream_fps'] and old.get('stream_fps'):
+            fps = (result['stream_fps'] / old['stream_fps'] - 1) * 100
+            changes.append(f"fps {fps:+.1f}%")
+            worse = worse or fps < -tolerance
+        if worse:
+            regressions += 1
+        print(f"{'REGRESSION' if worse else 'ok':10} {name}: {', '.join(changes)}", file=sys.stderr)
+    return regressions
+
+
+def main():
+    parser = argparse.ArgumentParser(
+        description="Benchmark bitmap transfers to the Arduino Due ST7735 displays",
+        formatter_class=argparse.RawDescriptionHelpFormatter,
+        epilog=__doc__.split("Usage:")[1],
+    )
+    parser.add_argument('serial_port', nargs='?', default='/dev/ttyACM0',
+                        help='Serial port (default: /dev/ttyACM0)')
+    parser.add_argument('--targets', default='DueLCD01',
+                        help='Comma-separated displays and GROUP:<name> targets (default: DueLCD01)')
+    parser.add_argument('--sizes', default='full,64x48',
+                        help="Comma-separated WxH frame sizes, 'full' for the usable area (default: full,64x48)")
+    parser.add_argument('--encodings', default=','.join(ENCODINGS),
+                        help=f"Comma-separated encodings from {', '.join(ENCODINGS)} (default: all)")
+    parser.add_argument('--status', default='binary',
+                        help='Comma-separated status modes: binary, text (default: binary)')
+    parser.add_argument('--chunk-rows', default='0',
+                        help='Comma-separated rows per serial write, 0 = all the credits allow (default: 0)')
+    parser.add_argument('--repeat', type=int, default=5,
+                        help='Timed transfers per case (default: 5)')
+    parser.add_argument('--stream-frames', type=int, default=30,
+                        help='Frames in the sustained-fps stream, 0 to skip (default: 30)')
+    parser.add_argument('--pattern', choices=('bars', 'noise'), default='bars',
+                        help='Frame content (default: bars)')
+    parser.add_argument('--label', default='',
+                        help='Free-form tag stored with the results, e.g. the firmware version')
+    parser.add_argument('--output', '-o',
+                        help='Write the JSON results here (default: stdout)')
+    parser.add_argument('--compare', metavar='BASELINE',
+                        help='Compare against an earlier results file; exit 1 on regressions')
+    parser.add_argument('--tolerance', type=float, default=10.0,
+                        help='Allowed slowdown in percent for --compare (default: 10)')
+    parser.add_argument('--verbose', '-v', action='store_true',
+                        help="Show BitmapSender's progress output")
+    args = parser.parse_args()
+
+    for encoding in args.encodings.split(','):
+        if encoding not in ENCODINGS:
+            parser.error(f"unknown encoding '{encoding}'")
+    for status in args.status.split(','):
+        if status not in STATUS_MODES:
+            parser.error(f"unknown status mode '{status}'")
+    try:
+        parse_sizes(args.sizes)
+    except ValueError:
+        parser.error(f"invalid --sizes '{args.sizes}' (expected e.g. full,64x48)")
+
+    results = Benchmark(args).run()
+    if results is None:
+        return 1
+
+    report = {
+        'format': RESULTS_FORMAT,
+        'label': args.label,
+        'timestamp': time.strftime('%Y-%m-%dT%H:%M:%S%z'),
+        'host': platform.node(),
+        'python': platform.python_version(),
+        'serial_port': args.serial_port,
+        'repeat': args.repeat,
+        'stream_frames': args.stream_frames,
+        'results': results,
+    }
+    text = json.dumps(report, indent=2)
+    if args.output:
+        with open(args.output, 'w') as f:
+            f.write(text + "\n")
+        print(f"Results written to {args.output}", file=sys.stderr)
+    else:
+        print(text)
+
+    if args.compare:
+        with open(args.compare) as f:
+            regressions = compare(results, json.load(f), args.tolerance)
+        if regressions:
+            print(f"{regressions} case(s) slower than {args.tolerance:g}% tolerance", file=sys.stderr)
+            return 1
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
@@ -13,25 +13,36 @@ Requirements:
 Usage:
     python3 bitmap_sender.py <image_file> [serial_port]
     python3 bitmap_sender.py --gui              # Open file picker GUI
+    python3 bitmap_sender.py --batch manifest.json  # Many boards at once
     
 Example:
     python3 bitmap_sender.py image.jpg /dev/ttyACM1
     python3 bitmap_sender.py --gui --device DueLCD01
 """
 
+import re
 import sys
 import time
 import argparse
 from pathlib import Path
 import serial
-from PIL import Image, ImageOps
+from PIL import Image, ImageOps, ImageSequence
 import struct
 import os
 import json
+import binascii
+from concurrent.futures import ProcessPoolExecutor, ThreadPoolExecutor
+
+# NumPy makes image conversion a handful of array operations (optional)
+try:
+    import numpy as np
+except ImportError:
+    np = None
 
 # Import config loader from st7735_tools
 try:
     from st7735_tools.config_loader import load_display_config, find_config_files, get_config_by_device_name
+    from st7735_tools.frame_cache import FrameCache
 except ImportError:
     print("Error: st7735_tools module not found. Make sure config_loader.py exists.")
     sys.exit(1)
@@ -42,12 +53,394 @@ DISPLAY_HEIGHT = 126  # Usable height (calibrated)
 SERIAL_BAUDRATE = 115200
 TIMEOUT_SECONDS = 10
 
+# Delta (dirty-rectangle) updates
+DELTA_TILE_SIZE = 16        # Frames are compared in tiles of this many pixels square
+DELTA_MAX_FRACTION = 0.6    # Above this share of changed pixels a full frame is cheaper
+
+# Run-length encoding (SIZE option RLE)
+ZERO_BYTES = re.compile(rb'\x00+')  # Repeated pixels in a row XORed with itself (pixel_runs)
+
+# Checked tiles (SIZE option TILE)
+TILE_SIZE = 16              # Tile edge in pixels, as TILE_SIZE in SerialProtocol.h
+TILE_SYNC = 0xA5            # First byte of a tile packet
+TILE_MAX_ROUNDS = 5         # BMPEnd rounds before a tiled transfer gives up
+TILE_REPLY_TIMEOUT = 2      # Seconds without a reply before BMPEnd is sent again
+
+# On-device primitives (DRAW:)
+DRAW_MAX_BYTES = 1024       # Longest list per DRAW: command (MAX_DRAW_BYTES)
+
+# Binary status packets (SIZE option BINARY): STATUS_SYNC, type, uint16 value (LE)
+STATUS_SYNC = 0xFF
+STATUS_ERRORS = {
+    1: "unexpected command",
+    2: "unknown or conflicting option",
+    3: "bitmap does not fit",
+    4: "no display",
+    5: "malformed RLE packet",
+    6: "bad RECT",
+    7: "bad MULTI slot",
+    8: "image store full or write failed",
+    9: "timeout",
+}
+
 # GUI settings file
 SETTINGS_FILE = Path.home() / '.st7735_bitmap_sender.json'
 DEFAULT_IMAGE_DIR = Path.home() / 'Pictures'
 
+def compute_dirty_rects(old_bytes, new_bytes, width, height, tile=DELTA_TILE_SIZE):
+    """
+    Find the regions that differ between two RGB565 frames of the same size
+    
+    The frames are compared tile by tile; changed tiles in a band of tile rows
+    are merged into horizontal runs, and runs spanning the same columns in
+    consecutive bands are merged into taller rectangles.
+    
+    Args:
+        old_bytes, new_bytes (bytes): Big-endian RGB565 data, row-major
+        width, height (int): Frame dimensions
+        tile (int): Tile edge length in pixels
+        
+    Returns:
+        list: (x, y, w, h) rectangles in bitmap coordinates
+    """
+    row_size = width * 2
+    rects = []
+    open_rects = {}  # (x, w) -> index into rects of the rectangle ending at the previous band
+    
+    for band_y in range(0, height, tile):
+        band_h = min(tile, height - band_y)
+        dirty = [False] * ((width + tile - 1) // tile)
+        
+        for y in range(band_y, band_y + band_h):
+            row_start = y * row_size
+            if old_bytes[row_start:row_start + row_size] == new_bytes[row_start:row_start + row_size]:
+                continue
+            for t in range(len(dirty)):
+                if dirty[t]:
+                    continue
+                start = row_start + t * tile * 2
+                end = min(start + tile * 2, row_start + row_size)
+                if old_bytes[start:end] != new_bytes[start:end]:
+                    dirty[t] = True
+        
+        band_rects = {}
+        t = 0
+        while t < len(dirty):
+            if not dirty[t]:
+                t += 1
+                continue
+            run_start = t
+            while t < len(dirty) and dirty[t]:
+                t += 1
+            x = run_start * tile
+            w = min(t * tile, width) - x
+            
+            if (x, w) in open_rects:
+                index = open_rects[(x, w)]
+                rx, ry, rw, rh = rects[index]
+                rects[index] = (rx, ry, rw, rh + band_h)
+            else:
+                index = len(rects)
+                rects.append((x, band_y, w, band_h))
+            band_rects[(x, w)] = index
+        
+        open_rects = band_rects
+    
+    return rects
+
+def image_to_rgb565(img):
+    """
+    Convert an RGB image to big-endian RGB565 in one contiguous buffer
+    
+    Uses NumPy when available; otherwise walks the raw RGB888 bytes from
+    Image.tobytes(), which still avoids per-pixel getpixel() calls.
+    
+    Args:
+        img (PIL.Image): Image in RGB mode
+        
+    Returns:
+        bytes: width * height * 2 bytes, row-major, ready to send
+    """
+    if np is not None:
+        rgb = np.asarray(img, dtype=np.uint16)
+        rgb565 = ((rgb[..., 0] & 0xF8) << 8) | ((rgb[..., 1] & 0xFC) << 3) | (rgb[..., 2] >> 3)
+        return rgb565.astype('>u2').tobytes()
+    
+    data = img.tobytes()
+    out = bytearray(len(data) // 3 * 2)
+    for i in range(len(data) // 3):
+        r, g, b = data[3 * i], data[3 * i + 1], data[3 * i + 2]
+        out[2 * i] = (r & 0xF8) | (g >> 5)
+        out[2 * i + 1] = ((g & 0x1C) << 3) | (b >> 3)
+    return bytes(out)
+
+def pixel_runs(row_bytes):
+    """
+    Find the runs of two or more equal RGB565 pixels in a row
+    
+    XORing the row with itself shifted by one pixel zeroes every word whose
+    pixel repeats the next one, so the runs are the word-aligned stretches of
+    zero bytes; the scan runs in C instead of a Python loop per pixel.
+    
+    Args:
+        row_bytes (bytes): One row of pixel data
+        
+    Yields:
+        tuple: (first pixel, run length)
+    """
+    if len(row_bytes) < 4:
+        return
+    shifted = int.from_bytes(row_bytes[2:], 'big') ^ int.from_bytes(row_bytes[:-2], 'big')
+    for match in ZERO_BYTES.finditer(shifted.to_bytes(len(row_bytes) - 2, 'big')):
+        start, end = (match.start() + 1) & ~1, match.end() & ~1
+        if end > start:
+            yield start // 2, (end - start) // 2 + 1
+
+def encode_rle_row(row_bytes):
+    """
+    Run-length encode one row of big-endian RGB565 pixels (SIZE option RLE)
+    
+    Packets never span rows. A header with bit 7 set is followed by one pixel
+    repeated (header & 0x7F) + 1 times; otherwise it is followed by header + 1
+    literal pixels.
+    
+    Args:
+        row_bytes (bytes): One row of pixel data
+        
+    Returns:
+        bytes: Encoded row
+    """
+    out = bytearray()
+    literal_start = 0
+    
+    def flush_literal(end):
+        start = literal_start
+        while start < end:
+            count = min(128, end - start)
+            out.append(count - 1)
+            out.extend(row_bytes[start * 2:(start + count) * 2])
+            start += count
+    
+    for offset, run in pixel_runs(row_bytes):
+        flush_literal(offset)
+        pixel = row_bytes[offset * 2:offset * 2 + 2]
+        while run >= 2:
+            count = min(128, run)
+            out.append(0x80 | (count - 1))
+            out.extend(pixel)
+            offset += count
+            run -= count
+        # A single pixel left over from a long run starts the next literal
+        literal_start = offset
+    
+    flush_literal(len(row_bytes) // 2)
+    return bytes(out)
+
+def build_palette(pixel_bytes, max_colors=256):
+    """
+    Collect the distinct RGB565 colors of a frame (SIZE option BPP)
+    
+    Args:
+        pixel_bytes (bytes): Big-endian RGB565 data
+        max_colors (int): Largest palette wanted
+        
+    Returns:
+        list: Two-byte colors in order of appearance, or None if there are
+              more than max_colors
+    """
+    palette = {}
+    for i in range(0, len(pixel_bytes), 2):
+        color = pixel_bytes[i:i + 2]
+        if color not in palette:
+            if len(palette) >= max_colors:
+                return None
+            palette[color] = len(palette)
+    return list(palette)
+
+def indexed_depth(color_count):
+    """Fewest bits per pixel (1, 2, 4 or 8) that index color_count colors"""
+    for bpp in (1, 2, 4, 8):
+        if color_count <= 1 << bpp:
+            return bpp
+    raise ValueError(f"{color_count} colors need more than 8 bits per pixel")
+
+def encode_indexed_row(row_bytes, lookup, bpp):
+    """
+    Pack one row of RGB565 pixels as palette indices (SIZE option BPP)
+    
+    The leftmost pixel goes in the most significant bits; the row is padded
+    to a whole byte.
+    
+    Args:
+        row_bytes (bytes): One row of big-endian RGB565 data
+        lookup (dict): Palette index of each two-byte color
+        bpp (int): Bits per pixel (1, 2, 4 or 8)
+        
+    Returns:
+        bytes: Packed row
+    """
+    indices = [lookup[row_bytes[i:i + 2]] for i in range(0, len(row_bytes), 2)]
+    if bpp == 8:
+        return bytes(indices)
+    per_byte = 8 // bpp
+    out = bytearray((len(indices) + per_byte - 1) // per_byte)
+    for x, index in enumerate(indices):
+        out[x // per_byte] |= index << (8 - bpp * (x % per_byte + 1))
+    return bytes(out)
+
+def encode_tile(pixel_bytes, width, height, seq, tile=TILE_SIZE):
+    """
+    Build the packet of one tile (SIZE option TILE)
+    
+    Tiles are numbered row by row; edge tiles are cut to the bitmap. The
+    packet is TILE_SYNC, seq (uint16 LE), the tile's pixels row by row and
+    the CRC-16/CCITT-FALSE of seq and pixels (uint16 LE).
+    
+    Args:
+        pixel_bytes (bytes): Big-endian RGB565 data of the whole bitmap
+        width, height (int): Bitmap dimensions
+        seq (int): Tile number
+        
+    Returns:
+        bytes: Wire packet
+    """
+    columns = (width + tile - 1) // tile
+    x = (seq % columns) * tile
+    y = (seq // columns) * tile
+    w = min(tile, width - x)
+    h = min(tile, height - y)
+    row_size = width * 2
+    header = struct.pack('<H', seq)
+    pixels = b''.join(pixel_bytes[row * row_size + x * 2:row * row_size + (x + w) * 2]
+                      for row in range(y, y + h))
+    crc = binascii.crc_hqx(header + pixels, 0xFFFF)
+    return bytes([TILE_SYNC]) + header + pixels + struct.pack('<H', crc)
+
+def fit_image(img, display_width, display_height, verbose=True):
+    """
+    Scale an RGB image to fit the display, keeping the aspect ratio
+    
+    The image fills at least one dimension completely; anything still larger
+    than the display is cropped around the center.
+    
+    Args:
+        img (PIL.Image): Image in RGB mode
+        display_width, display_height (int): Usable area to fit
+        verbose (bool): Print the chosen scale and size
+        
+    Returns:
+        PIL.Image: The fitted image
+    """
+    log = print if verbose else (lambda *args: None)
+    
+    # Calculate scaling to fit display while maintaining aspect ratio
+    # No rotation needed - display rotation will handle orientation
+    img_width, img_height = img.size
+    
+    scale_x = display_width / img_width
+    scale_y = display_height / img_height
+    
+    # Try to fill at least one dimension completely
+    scale_max = max(scale_x, scale_y)
+    scale_min = min(scale_x, scale_y)
+    
+    # Calculate what the size would be with max scale
+    test_width = int(img_width * scale_max)
+    test_height = int(img_height * scale_max)
+    
+    # If max scale fits within display bounds, use it; otherwise fall back to min scale
+    if test_width <= display_width and test_height <= display_height:
+        scale = scale_max
+        log(f"Using max scale to fill dimension: {scale:.3f}")
+    else:
+        scale = scale_min
+        log(f"Using min scale to fit display: {scale:.3f}")
+    
+    # Calculate final size
+    final_width = int(img_width * scale)
+    final_height = int(img_height * scale)
+    
+    log(f"Scaling to: {final_width}x{final_height}")
+    
+    # Resize image (no rotation needed)
+    fitted = img.resize((final_width, final_height), Image.Resampling.LANCZOS)
+    
+    new_width, new_height = fitted.size
+    log(f"Final size: ({new_width}, {new_height})")
+    
+    # Final bounds check and crop if necessary
+    if new_width > display_width or new_height > display_height:
+        log(f"Cropping to fit display: {display_width}x{display_height}")
+        # Calculate crop box to center the image
+        left = max(0, (new_width - display_width) // 2)
+        top = max(0, (new_height - display_height) // 2)
+        right = left + min(new_width, display_width)
+        bottom = top + min(new_height, display_height)
+        
+        fitted = fitted.crop((left, top, right, bottom))
+        log(f"Final cropped size: {fitted.size[0]}x{fitted.size[1]}")
+    
+    return fitted
+
+class DisplayList:
+    """
+    Primitive drawing ops rendered by the Arduino (DRAW:)
+    
+    Coordinates are display coordinates, colors RGB565 values. Send with
+    BitmapSender.send_draw(); a counter update is a box and a text op, a few
+    dozen bytes instead of a frame.
+    """
+    
+    def __init__(self):
+        self.ops = []
+    
+    def _add(self, op, *fields):
+        self.ops.append(op.encode('ascii') + struct.pack(f'<{len(fields)}h', *[
+            value - 0x10000 if value > 0x7FFF else value for value in fields]))
+        return self
+    
+    def fill(self, color):
+        """Fill the whole screen"""
+        return self._add('F', color)
+    
+    def rect(self, x, y, width, height, color):
+        """Rectangle outline"""
+        return self._add('R', x, y, width, height, color)
+    
+    def fill_rect(self, x, y, width, height, color):
+        """Filled rectangle"""
+        return self._add('B', x, y, width, height, color)
+    
+    def line(self, x0, y0, x1, y1, color):
+        """Line between two points"""
+        return self._add('L', x0, y0, x1, y1, color)
+    
+    def text(self, x, y, text, color, background=None, size=1):
+        """
+        Text in the 6x8 GFX font scaled by size, without wrapping
+        
+        With a background color each character cell is painted first, so an
+        updated counter overwrites the previous one.
+        """
+        data = text.encode('ascii', errors='replace')[:255]
+        self._add('T', x, y, color, color if background is None else background)
+        self.ops[-1] += bytes([size, len(data)]) + data
+        return self
+    
+    def batches(self, limit=DRAW_MAX_BYTES):
+        """Op bytes split at op boundaries into lists of at most limit bytes"""
+        batch = b''
+        for op in self.ops:
+            if batch and len(batch) + len(op) > limit:
+                yield batch
+                batch = b''
+            batch += op
+        if batch:
+            yield batch
+
 class BitmapSender:
-    def __init__(self, serial_port='/dev/ttyACM0', baudrate=SERIAL_BAUDRATE, display_config=None):
+    def __init__(self, serial_port='/dev/ttyACM0', baudrate=SERIAL_BAUDRATE, display_config=None, group=None,
+                 frame_cache=None, binary_status=True):
         """
         Initialize the bitmap sender
         
@@ -55,11 +448,33 @@ class BitmapSender:
             serial_port (str): Serial port path (e.g., '/dev/ttyACM0')
             baudrate (int): Serial communication baud rate
             display_config: DisplayConfig object (optional, uses defaults if None)
+            group (str): Display group to mirror to (DISPLAY:GROUP:<name>); images
+                         are still sized from display_config
+            frame_cache: FrameCache for prepared frames (optional)
+            binary_status (bool): Ask for 4-byte status packets instead of text
+                                  progress lines (SIZE option BINARY)
         """
         self.serial_port = serial_port
         self.baudrate = baudrate
         self.connection = None
         self.display_config = display_config
+        self.group = group
+        self.frame_cache = frame_cache
+        self.binary_status = binary_status
+        self.selected_display = None
+        
+        # Last frame sent to each display, the reference for delta updates
+        self.last_frames = {}
+        
+        # Most rows send_pixel_rows() puts in one write (None = all the credits allow)
+        self.write_chunk_rows = None
+        
+        # time.perf_counter() marks of the last send_frame(): 'start' (start marker
+        # sent), 'ready', 'first_credit' (the Arduino finished its first row),
+        # 'sent' (last pixel byte written) and 'complete'; see benchmark.py
+        self.timings = {}
+        self.last_bytes_sent = 0
+        self.last_pixels_sent = 0
         
         # Set display dimensions from config or use defaults
         if display_config:
@@ -114,6 +529,8 @@ class BitmapSender:
         if self.connection and self.connection.is_open:
             self.connection.close()
             print("Disconnected from Arduino")
+        self.selected_display = None
+        self.last_frames = {}
     
     def wait_for_response(self, expected_response=None, timeout=5):
         """
@@ -136,6 +553,8 @@ class BitmapSender:
                     if line:
                         print(f"Arduino: {line}")
                         response = line
+                        if line.startswith("CREDIT:"):
+                            self.mark_credit()
                         
                         if expected_response is None or expected_response in line:
                             return response
@@ -145,6 +564,222 @@ class BitmapSender:
         
         return None
     
+    def wait_for_credits(self, timeout=5):
+        """
+        Wait for the flow-control credit advertisement that follows READY
+        
+        Returns:
+            int: Number of rows the Arduino can accept ahead, or None if timeout
+        """
+        response = self.wait_for_response("CREDITS:", timeout=timeout)
+        if not response or not response.startswith("CREDITS:"):
+            return None
+        return int(response.split(':', 1)[1])
+    
+    def wait_for_ready(self):
+        """
+        Wait for READY after SIZE/MULTI, as a text line or a status packet
+        
+        Returns:
+            int: Flow-control credits, or None (after printing why) on failure
+        """
+        if self.binary_status:
+            credits = self.wait_for_status('R', timeout=5)
+            if credits is None:
+                print("Error: Arduino did not confirm ready state")
+            return credits
+        
+        response = self.wait_for_response("READY", timeout=5)
+        if not response or "READY" not in response:
+            print("Error: Arduino did not confirm ready state")
+            return None
+        credits = self.wait_for_credits()
+        if credits is None:
+            print("Error: Arduino did not advertise flow-control credits")
+        return credits
+    
+    def wait_for_complete(self):
+        """
+        Wait for COMPLETE after BMPEnd
+        
+        Returns:
+            bool: True if the Arduino confirmed the transfer
+        """
+        if self.binary_status:
+            millis = self.wait_for_status('K', timeout=10)
+            if millis is not None:
+                print(f"Arduino: COMPLETE ({millis} ms)")
+            return millis is not None
+        response = self.wait_for_response("COMPLETE", timeout=10)
+        return response is not None and "COMPLETE" in response
+    
+    def read_status(self, timeout=5):
+        """
+        Read the next binary status packet
+        
+        Text lines met on the way (debug output, or replies sent before the
+        transfer switched to BINARY) are printed and skipped.
+        
+        Returns:
+            tuple: (type, value), e.g. ('C', 1), or None if timeout
+        """
+        deadline = time.time() + timeout
+        while time.time() < deadline:
+            byte = self.connection.read(1)
+            if not byte:
+                continue
+            if byte[0] == STATUS_SYNC:
+                packet = self.connection.read(3)
+                if len(packet) < 3:
+                    return None
+                if packet[0] == ord('C'):
+                    self.mark_credit()
+                return chr(packet[0]), packet[1] | (packet[2] << 8)
+            line = (byte + self.connection.readline()).decode('utf-8', errors='ignore').strip()
+            if line:
+                print(f"Arduino: {line}")
+        return None
+    
+    def wait_for_status(self, expected, timeout=5):
+        """
+        Wait for a binary status packet of the expected type
+        
+        Other packets (credits, progress) are skipped; an error packet raises.
+        
+        Returns:
+            int: Value of the packet, or None if timeout
+        """
+        while True:
+            status = self.read_status(timeout)
+            if status is None:
+                return None
+            kind, value = status
+            if kind == 'E':
+                raise RuntimeError(f"Arduino error {value}: {STATUS_ERRORS.get(value, 'unknown')}")
+            if kind == expected:
+                return value
+    
+    def mark_credit(self):
+        """Note when the first returned credit of a transfer arrived"""
+        if 'start' in self.timings:
+            self.timings.setdefault('first_credit', time.perf_counter())
+    
+    def send_pixel_rows(self, rows, credits, show_progress=True):
+        """
+        Stream pixel rows under credit-based flow control
+        
+        All rows covered by the available credits go out in one write; when
+        credits run out, the sender blocks on the "CREDIT:<n>" lines (or 'C'
+        status packets) the Arduino returns as it consumes rows. No fixed
+        delays are needed.
+        
+        Args:
+            rows (list): Wire data of each row (raw or RLE encoded)
+            credits (int): Credits currently available
+            show_progress (bool): Print progress every 16 rows
+            
+        Returns:
+            tuple: (bytes_sent, credits_remaining)
+        """
+        height = len(rows)
+        bytes_sent = 0
+        row = 0
+        
+        while row < height:
+            while credits <= 0 and self.binary_status:
+                status = self.read_status(timeout=TIMEOUT_SECONDS)
+                if status is None:
+                    raise TimeoutError(f"No flow-control credit received (row {row}/{height})")
+                kind, value = status
+                if kind == 'C':
+                    credits += value
+                    self.mark_credit()
+                elif kind == 'E':
+                    raise RuntimeError(f"Arduino error {value}: {STATUS_ERRORS.get(value, 'unknown')}")
+            
+            while credits <= 0:
+                line = self.connection.readline().decode('utf-8', errors='ignore').strip()
+                if not line:
+                    raise TimeoutError(f"No flow-control credit received (row {row}/{height})")
+                if line.startswith("CREDIT:"):
+                    credits += int(line.split(':', 1)[1])
+                    self.mark_credit()
+                else:
+                    print(f"Arduino: {line}")
+                    if line.startswith("ERROR"):
+                        raise RuntimeError(line)
+            
+            count = min(credits, height - row)
+            if self.write_chunk_rows:
+                count = min(count, self.write_chunk_rows)
+            chunk = b''.join(rows[row:row + count])
+            self.connection.write(chunk)
+            credits -= count
+            bytes_sent += len(chunk)
+            previous_row = row
+            row += count
+            
+            # Progress indication
+            if show_progress and (row // 16 != previous_row // 16 or row == height):
+                progress = row / height * 100
+                print(f"Progress: {progress:.1f}% ({row}/{height} rows, {bytes_sent} bytes)")
+        
+        self.connection.flush()
+        return bytes_sent, credits
+    
+    def target_name(self):
+        """Name the Arduino knows the target by: display name or GROUP:<name>"""
+        if self.group:
+            return f"GROUP:{self.group}"
+        return self.display_config.name if self.display_config else None
+    
+    def select_display(self):
+        """
+        Select the configured display (or group), once per connection
+        
+        Returns:
+            bool: True if selected (or no config given), False otherwise
+        """
+        target = self.target_name()
+        if not target:
+            return True
+        if self.selected_display == target:
+            return True
+        
+        # DISPLAY: is only accepted in display selection, not after a transfer
+        if self.selected_display is not None and not self.reset_protocol():
+            print("Error: Arduino did not confirm CMD:RESET")
+            return False
+        
+        print(f"Selecting display: {target}...")
+        display_command = f"DISPLAY:{target}\n"
+        self.connection.write(display_command.encode('utf-8'))
+        self.connection.flush()
+        
+        # Wait for DISPLAY_READY response
+        response = self.wait_for_response("DISPLAY_READY", timeout=3)
+        if not response or "DISPLAY_READY" not in response:
+            if response and "DISPLAY_ERROR" in response:
+                print(f"Error: {response}")
+            else:
+                print("Error: Arduino did not confirm display selection")
+            return False
+        print(f"✓ Display {target} selected")
+        self.selected_display = target
+        return True
+        
+    def reset_protocol(self, timeout=3):
+        """
+        Return the Arduino to display selection (CMD:RESET)
+        
+        Returns:
+            bool: True if the Arduino confirmed the reset
+        """
+        self.selected_display = None
+        self.connection.write(b"\nCMD:RESET\n")
+        self.connection.flush()
+        return self.wait_for_response("OK:Protocol reset", timeout=timeout) is not None
+        
     def rgb888_to_rgb565(self, r, g, b):
         """
         Convert RGB888 (24-bit) to RGB565 (16-bit)
@@ -164,17 +799,35 @@ class BitmapSender:
         rgb565 = (r5 << 11) | (g6 << 5) | b5
         return rgb565
     
-    def prepare_image(self, image_path):
+    def prepare_image(self, image_path, display_config=None):
         """
         Load and prepare image for display
         
+        With a frame cache, an image already prepared for the same geometry is
+        read back from disk instead of being decoded and resampled again.
+        
         Args:
             image_path (str): Path to image file
+            display_config: DisplayConfig to fit, defaults to this sender's display
             
         Returns:
-            tuple: (width, height, pixel_data) or None if error
+            tuple: (width, height, pixel_bytes) or None if error
         """
+        if display_config:
+            display_width, display_height = display_config.usable_width, display_config.usable_height
+        else:
+            display_config = self.display_config
+            display_width, display_height = self.display_width, self.display_height
+        
+        cache_key = None
         try:
+            if self.frame_cache:
+                cache_key = self.frame_cache.key(image_path, (display_width, display_height), display_config)
+                cached = self.frame_cache.load(cache_key)
+                if cached:
+                    print(f"Using cached frame: {cached[0]}x{cached[1]}")
+                    return cached
+            
             print(f"Loading image: {image_path}")
             
             # Open and convert image
@@ -187,82 +840,66 @@ class BitmapSender:
                     print("Converting image to RGB...")
                     img = img.convert('RGB')
                 
-                # Calculate scaling to fit display while maintaining aspect ratio
-                # No rotation needed - display rotation will handle orientation
-                img_width, img_height = img.size
-                
-                scale_x = self.display_width / img_width
-                scale_y = self.display_height / img_height
-                
-                # Try to fill at least one dimension completely
-                scale_max = max(scale_x, scale_y)
-                scale_min = min(scale_x, scale_y)
-                
-                # Calculate what the size would be with max scale
-                test_width = int(img_width * scale_max)
-                test_height = int(img_height * scale_max)
-                
-                # If max scale fits within display bounds, use it; otherwise fall back to min scale
-                if test_width <= self.display_width and test_height <= self.display_height:
-                    scale = scale_max
-                    print(f"Using max scale to fill dimension: {scale:.3f}")
-                else:
-                    scale = scale_min
-                    print(f"Using min scale to fit display: {scale:.3f}")
-                
-                # Calculate final size
-                final_width = int(img_width * scale)
-                final_height = int(img_height * scale)
-                
-                print(f"Scaling to: {final_width}x{final_height}")
-                
-                # Resize image (no rotation needed)
-                img_resized = img.resize((final_width, final_height), Image.Resampling.LANCZOS)
-                
-                new_width, new_height = img_resized.size
-                print(f"Final size: ({new_width}, {new_height})")
-                
-                # Update dimensions after rotation
+                img_resized = fit_image(img, display_width, display_height)
                 new_width, new_height = img_resized.size
                 
-                # Final bounds check and crop if necessary
-                if new_width > self.display_width or new_height > self.display_height:
-                    print(f"Cropping to fit display: {self.display_width}x{self.display_height}")
-                    # Calculate crop box to center the image
-                    left = max(0, (new_width - self.display_width) // 2)
-                    top = max(0, (new_height - self.display_height) // 2)
-                    right = left + min(new_width, self.display_width)
-                    bottom = top + min(new_height, self.display_height)
-                    
-                    img_resized = img_resized.crop((left, top, right, bottom))
-                    new_width, new_height = img_resized.size
-                    print(f"Final cropped size: {new_width}x{new_height}")
-                
-                # Convert to RGB565 pixel data
+                # Convert to big-endian RGB565 pixel data
                 print("Converting to RGB565 format...")
-                pixel_data = []
-                
-                for y in range(new_height):
-                    for x in range(new_width):
-                        r, g, b = img_resized.getpixel((x, y))
-                        rgb565 = self.rgb888_to_rgb565(r, g, b)
-                        
-                        # Pack as big-endian 16-bit value
-                        pixel_data.append(struct.pack('>H', rgb565))
+                pixel_bytes = image_to_rgb565(img_resized)
                 
-                print(f"Prepared {len(pixel_data)} pixels")
-                return new_width, new_height, pixel_data
+                print(f"Prepared {len(pixel_bytes) // 2} pixels")
+                if cache_key:
+                    self.frame_cache.store(cache_key, new_width, new_height, pixel_bytes)
+                return new_width, new_height, pixel_bytes
                 
         except Exception as e:
             print(f"Error preparing image: {e}")
             return None
     
-    def send_bitmap(self, image_path):
+    def prepare_animation(self, image_path):
+        """
+        Load every frame of an animated image (GIF, APNG, WebP) for send_stream()
+        
+        Frames are fitted to this sender's display like prepare_image() does
+        for a still image; a still image gives a single frame.
+        
+        Returns:
+            tuple: (width, height, [pixel_bytes, ...]) or None if error
+        """
+        try:
+            frames = []
+            with Image.open(image_path) as img:
+                print(f"Loading animation: {image_path} ({getattr(img, 'n_frames', 1)} frames)")
+                for frame in ImageSequence.Iterator(img):
+                    fitted = fit_image(frame.convert('RGB'), self.display_width, self.display_height,
+                                       verbose=not frames)
+                    frames.append(image_to_rgb565(fitted))
+            width, height = fitted.size
+            print(f"Prepared {len(frames)} frames of {width}x{height}")
+            return width, height, frames
+        except Exception as e:
+            print(f"Error preparing animation: {e}")
+            return None
+    
+    def send_bitmap(self, image_path, delta=False, compress=True, store_id=None, snapshot=False,
+                    tiles=False, indexed=False, rotation=None):
         """
         Send bitmap to Arduino Due
         
         Args:
             image_path (str): Path to image file
+            delta (bool): Only send the regions that changed since the last
+                          frame sent to this display (see send_frame)
+            compress (bool): Run-length encode the pixel stream when smaller
+            store_id (str): Also save the image in the Arduino's flash image
+                            store under this id (see show_stored)
+            snapshot (bool): Keep the image in the Arduino's RAM snapshot pool
+                             so CMD:REPAINT can redraw it (see send_frame)
+            tiles (bool): Send CRC-checked tiles and resend only the damaged
+                          ones (see send_tiles; delta, compress and store_id
+                          do not apply)
+            indexed (bool): Allow palette-indexed pixels (see send_frame)
+            rotation (int): Panel rotation the image is sized for (see send_frame)
             
         Returns:
             bool: True if successful, False otherwise
@@ -276,91 +913,575 @@ class BitmapSender:
         if not image_data:
             return False
         
-        width, height, pixel_data = image_data
+        width, height, pixel_bytes = image_data
+        if tiles:
+            return self.send_tiles(width, height, pixel_bytes, snapshot=snapshot, rotation=rotation)
+        return self.send_frame(width, height, pixel_bytes, delta=delta, compress=compress,
+                               store_id=store_id, snapshot=snapshot, indexed=indexed, rotation=rotation)
+    
+    def send_frame(self, width, height, pixel_bytes, delta=False, compress=True, store_id=None,
+                   snapshot=False, indexed=False, rotation=None):
+        """
+        Send a prepared RGB565 frame to Arduino Due
+        
+        With delta=True the frame is compared against the last frame sent to
+        the same display on this connection and only the dirty rectangles are
+        transmitted (SIZE option DELTA). Without a matching previous frame, or
+        when most of the frame changed, a full frame is sent instead.
+        
+        With compress=True the rows are run-length encoded (SIZE option RLE)
+        whenever that makes the transfer smaller.
+        
+        With indexed=True a frame of at most 256 colors may instead go as
+        palette indices of 1, 2, 4 or 8 bits (SIZE option BPP), whichever of
+        raw, indexed and RLE is smallest.
+        
+        With store_id the transfer starts with IMG:STORE:<id> instead of
+        BMPStart, so the Arduino also writes the frame to its flash image
+        store. Stored frames are always sent whole (delta is ignored).
+        
+        With snapshot=True a full frame starts with BMPStart:SNAPSHOT, so the
+        Arduino keeps it in RAM for CMD:REPAINT. A delta update keeps that
+        snapshot current by itself; snapshot is ignored with store_id.
+        
+        With rotation the frame is declared as rendered for that panel rotation
+        (SIZE option ROT:<n>, 0-3 as CMD:ORIENTATION): after a CMD:ORIENTATION
+        the Arduino still puts it where it was made for, so a cached or stored
+        frame needs no re-render. snapshot is ignored with rotation.
+        
+        Args:
+            width, height (int): Frame dimensions
+            pixel_bytes (bytes): Big-endian RGB565 data, row-major
+            delta (bool): Send dirty rectangles only
+            compress (bool): Allow RLE encoding
+            store_id (str): Image store id to save the frame under
+            snapshot (bool): Keep the frame in the Arduino's snapshot pool
+            indexed (bool): Allow palette-indexed pixels
+            rotation (int): Panel rotation the frame was rendered for (None: current)
+            
+        Returns:
+            bool: True if successful, False otherwise
+        """
+        if not self.connection or not self.connection.is_open:
+            print("Error: Not connected to Arduino")
+            return False
+        
+        display_key = self.target_name()
+        rects = None
+        if delta and not store_id:
+            previous = self.last_frames.get(display_key)
+            if previous and previous[0] == width and previous[1] == height:
+                rects = compute_dirty_rects(previous[2], pixel_bytes, width, height)
+                dirty_pixels = sum(w * h for _, _, w, h in rects)
+                if not rects:
+                    print("Frame unchanged, nothing to send")
+                    return True
+                if dirty_pixels > width * height * DELTA_MAX_FRACTION:
+                    print(f"{dirty_pixels} of {width * height} pixels changed, sending full frame")
+                    rects = None
+                else:
+                    print(f"Delta update: {len(rects)} rectangle(s), {dirty_pixels} of {width * height} pixels")
+        
+        # Rows to send, grouped by dirty rectangle (a single group for a full frame)
+        row_size = width * 2
+        if rects:
+            groups = [((x, y, w, h), [pixel_bytes[row * row_size + x * 2:row * row_size + (x + w) * 2]
+                                      for row in range(y, y + h)])
+                      for x, y, w, h in rects]
+        else:
+            groups = [(None, [pixel_bytes[row * row_size:(row + 1) * row_size] for row in range(height)])]
+        
+        options = "CREDIT"
+        if rects:
+            options += ",DELTA"
+        if self.binary_status:
+            options += ",BINARY"
+        if rotation is not None:
+            options += f",ROT:{rotation}"
+            snapshot = False
+        
+        # Smallest of raw, indexed (rows plus palette) and RLE
+        raw_size = sum(len(row) for _, rows in groups for row in rows)
+        best_size, best_groups, best_option, palette_bytes = raw_size, groups, "", b''
+        if indexed:
+            palette = build_palette(pixel_bytes)
+            if palette is None:
+                print("More than 256 colors, not indexing")
+            else:
+                bpp = indexed_depth(len(palette))
+                lookup = {color: i for i, color in enumerate(palette)}
+                packed = [(rect, [encode_indexed_row(row, lookup, bpp) for row in rows]) for rect, rows in groups]
+                table = b''.join(palette) + b'\x00\x00' * ((1 << bpp) - len(palette))
+                packed_size = sum(len(row) for _, rows in packed for row in rows) + len(table)
+                if packed_size < best_size:
+                    print(f"Indexed ({len(palette)} colors, {bpp} bpp): {raw_size} -> {packed_size} bytes")
+                    best_size, best_groups, best_option, palette_bytes = packed_size, packed, f",BPP:{bpp}", table
+        if compress:
+            encoded = [(rect, [encode_rle_row(row) for row in rows]) for rect, rows in groups]
+            encoded_size = sum(len(row) for _, rows in encoded for row in rows)
+            if encoded_size < best_size:
+                print(f"RLE: {raw_size} -> {encoded_size} bytes")
+                best_size, best_groups, best_option, palette_bytes = encoded_size, encoded, ",RLE", b''
+        groups = best_groups
+        options += best_option
+        
+        # A failed transfer leaves the screen in an unknown state
+        self.last_frames.pop(display_key, None)
         
         try:
             print("\n=== Starting bitmap transmission ===")
             
             # Step 0: Select target display (v3.0 protocol)
-            if self.display_config:
-                print(f"Selecting display: {self.display_config.name}...")
-                display_command = f"DISPLAY:{self.display_config.name}\n"
-                self.connection.write(display_command.encode('utf-8'))
-                self.connection.flush()
-                
-                # Wait for DISPLAY_READY response
-                response = self.wait_for_response("DISPLAY_READY", timeout=3)
-                if not response or "DISPLAY_READY" not in response:
-                    if response and "DISPLAY_ERROR" in response:
-                        print(f"Error: {response}")
-                    else:
-                        print("Error: Arduino did not confirm display selection")
-                    return False
-                print(f"✓ Display {self.display_config.name} selected")
+            if not self.select_display():
+                return False
             
             # Step 1: Send start marker
             print("Sending start marker...")
-            self.connection.write(b"BMPStart\n")
+            self.timings = {'start': time.perf_counter()}
+            self.last_bytes_sent = 0
+            if store_id:
+                self.connection.write(f"IMG:STORE:{store_id}\n".encode('utf-8'))
+            elif snapshot and not rects:
+                self.connection.write(b"BMPStart:SNAPSHOT\n")
+            else:
+                self.connection.write(b"BMPStart\n")
             self.connection.flush()
             
-            # Step 2: Send dimensions
+            # Step 2: Send dimensions (with credit-based flow control)
             print(f"Sending dimensions: {width}x{height}")
-            size_command = f"SIZE:{width},{height}\n"
+            size_command = f"SIZE:{width},{height},{options}\n"
             self.connection.write(size_command.encode('utf-8'))
             self.connection.flush()
             
-            # Wait for READY response
-            response = self.wait_for_response("READY", timeout=5)
-            if not response or "READY" not in response:
-                print("Error: Arduino did not confirm ready state")
+            # Wait for READY and the flow-control credits
+            credits = self.wait_for_ready()
+            if credits is None:
                 return False
+            self.timings['ready'] = time.perf_counter()
             
-            # Give Arduino a moment to prepare for data reception
-            time.sleep(0.1)
+            # Step 3: Send the palette (indexed only), then pixel data; each
+            # rectangle is announced with RECT:x,y,w,h
+            self.connection.write(palette_bytes)
+            bytes_sent = len(palette_bytes)
+            for rect, rows in groups:
+                if rect:
+                    self.connection.write("RECT:{},{},{},{}\n".format(*rect).encode('utf-8'))
+                else:
+                    print(f"Sending {width * height} pixels...")
+                sent, credits = self.send_pixel_rows(rows, credits, show_progress=rect is None)
+                bytes_sent += sent
+            self.timings['sent'] = time.perf_counter()
+            self.last_bytes_sent = bytes_sent
+            self.last_pixels_sent = sum(rect[2] * rect[3] if rect else width * height for rect, _ in groups)
+            print(f"Pixel data sent: {bytes_sent} bytes")
             
-            # Step 3: Send pixel data
-            print(f"Sending {len(pixel_data)} pixels...")
-            bytes_sent = 0
+            # Step 4: Send end marker
+            print("Sending end marker...")
+            self.connection.write(b"BMPEnd\n")
+            self.connection.flush()
             
-            # Send pixels in smaller chunks to prevent buffer overflow
-            chunk_size = 50  # Send 50 pixels at a time
-            for chunk_start in range(0, len(pixel_data), chunk_size):
-                chunk_end = min(chunk_start + chunk_size, len(pixel_data))
-                
-                # Send chunk of pixels
-                for i in range(chunk_start, chunk_end):
-                    self.connection.write(pixel_data[i])
-                    bytes_sent += 2
+            # The store confirms the flash write before COMPLETE
+            if store_id:
+                if self.binary_status:
+                    stored = self.wait_for_status('S', timeout=10) is not None
+                else:
+                    response = self.wait_for_response("STORED:", timeout=10)
+                    stored = response is not None and response.startswith("STORED:")
+                if not stored:
+                    print(f"Error: Arduino did not confirm storing image '{store_id}'")
+                    return False
+                print(f"✓ Image stored as '{store_id}'")
+            
+            # Wait for completion confirmation
+            # Only a confirmed frame is what the panel shows, the reference for the next delta
+            if not self.wait_for_complete():
+                print("Error: Arduino did not confirm the transfer (no COMPLETE)")
+                return False
+            self.last_frames[display_key] = (width, height, pixel_bytes)
+            self.timings['complete'] = time.perf_counter()
+            print("✓ Bitmap transmission completed successfully!")
+            return True
                 
-                # Flush after each chunk
+        except Exception as e:
+            print(f"Error during transmission: {e}")
+            self.selected_display = None
+            return False
+    
+    def read_tile_reply(self, timeout=5):
+        """
+        Read the Arduino's next reply to a tiled transfer
+        
+        Returns:
+            tuple: ('N', seq) for a NACK, ('M', n) once it asks for n tiles
+                   again, ('K', 0) for COMPLETE, or None if timeout
+        """
+        deadline = time.time() + timeout
+        while time.time() < deadline:
+            if self.connection.in_waiting == 0:
+                time.sleep(0.01)
+                continue
+            
+            if self.binary_status:
+                status = self.read_status(timeout)
+                if status is None:
+                    continue
+                kind, value = status
+                if kind == 'E':
+                    raise RuntimeError(f"Arduino error {value}: {STATUS_ERRORS.get(value, 'unknown')}")
+                if kind in ('N', 'M', 'K'):
+                    return kind, value
+                continue
+            
+            line = self.connection.readline().decode('utf-8', errors='ignore').strip()
+            if not line:
+                continue
+            if line.startswith("NACK:"):
+                return 'N', int(line.split(':', 1)[1])
+            print(f"Arduino: {line}")
+            if line.startswith("RESEND:"):
+                return 'M', int(line.split(':', 1)[1])
+            if line == "COMPLETE":
+                return 'K', 0
+            if line.startswith("ERROR"):
+                raise RuntimeError(line)
+        return None
+    
+    def send_tiles(self, width, height, pixel_bytes, snapshot=False, rotation=None):
+        """
+        Send a prepared RGB565 frame as CRC-checked tiles (SIZE option TILE)
+        
+        All tiles go out back to back, then BMPEnd. The Arduino NACKs every
+        tile that arrived damaged or not at all and asks for them again; only
+        those are resent, up to TILE_MAX_ROUNDS times. BMPEnd goes again if
+        no reply comes, as a damaged last tile may have swallowed it.
+        
+        Args:
+            width, height (int): Frame dimensions
+            pixel_bytes (bytes): Big-endian RGB565 data, row-major
+            snapshot (bool): Keep the frame in the Arduino's snapshot pool
+            rotation (int): Panel rotation the frame was rendered for (see send_frame)
+            
+        Returns:
+            bool: True if every tile arrived intact, False otherwise
+        """
+        if not self.connection or not self.connection.is_open:
+            print("Error: Not connected to Arduino")
+            return False
+        
+        display_key = self.target_name()
+        tile_count = ((width + TILE_SIZE - 1) // TILE_SIZE) * ((height + TILE_SIZE - 1) // TILE_SIZE)
+        self.last_frames.pop(display_key, None)
+        
+        try:
+            print("\n=== Starting tiled bitmap transmission ===")
+            if not self.select_display():
+                return False
+            
+            self.timings = {'start': time.perf_counter()}
+            self.last_bytes_sent = 0
+            self.last_pixels_sent = width * height
+            snapshot = snapshot and rotation is None
+            self.connection.write(b"BMPStart:SNAPSHOT\n" if snapshot else b"BMPStart\n")
+            options = "TILE,BINARY" if self.binary_status else "TILE"
+            if rotation is not None:
+                options += f",ROT:{rotation}"
+            print(f"Sending dimensions: {width}x{height} ({tile_count} tiles)")
+            self.connection.write(f"SIZE:{width},{height},{options}\n".encode('utf-8'))
+            self.connection.flush()
+            
+            if self.binary_status:
+                ready = self.wait_for_status('R', timeout=5) is not None
+            else:
+                response = self.wait_for_response("READY", timeout=5)
+                ready = response is not None and "READY" in response
+            if not ready:
+                print("Error: Arduino did not confirm ready state")
+                return False
+            self.timings['ready'] = time.perf_counter()
+            
+            pending = list(range(tile_count))
+            for round_number in range(1, TILE_MAX_ROUNDS + 1):
+                packets = [encode_tile(pixel_bytes, width, height, seq) for seq in pending]
+                self.connection.write(b''.join(packets) + b"\nBMPEnd\n")
                 self.connection.flush()
+                self.last_bytes_sent += sum(len(packet) for packet in packets)
+                self.timings.setdefault('sent', time.perf_counter())
                 
-                # Progress indication
-                if (chunk_end) % 1000 == 0 or chunk_end == len(pixel_data):
-                    progress = chunk_end / len(pixel_data) * 100
-                    print(f"Progress: {progress:.1f}% ({chunk_end}/{len(pixel_data)} pixels, {bytes_sent} bytes)")
+                nacked = set()
+                silent = 0
+                while True:
+                    reply = self.read_tile_reply(timeout=TILE_REPLY_TIMEOUT)
+                    if reply is None:
+                        silent += 1
+                        if silent > 3:
+                            print("Error: No reply to the tiles sent")
+                            return False
+                        self.connection.write(b"\nBMPEnd\n")
+                        self.connection.flush()
+                        continue
+                    kind, value = reply
+                    if kind == 'N':
+                        nacked.add(value)
+                    elif kind == 'M':
+                        break
+                    else:
+                        self.timings['complete'] = time.perf_counter()
+                        self.last_frames[display_key] = (width, height, pixel_bytes)
+                        print(f"✓ Tiled transmission completed ({self.last_bytes_sent} bytes, "
+                              f"{round_number - 1} resend round(s))")
+                        return True
                 
-                # Small delay between chunks to allow Arduino to process
-                time.sleep(0.01)
+                pending = sorted(seq for seq in nacked if seq < tile_count)
+                print(f"Resending {len(pending)} of {tile_count} tiles")
+            
+            print(f"Error: Tiles still damaged after {TILE_MAX_ROUNDS} rounds")
+            self.connection.write(b"CMD:RESET\n")
+            self.selected_display = None
+            return False
+            
+        except Exception as e:
+            print(f"Error during transmission: {e}")
+            self.selected_display = None
+            return False
+    
+    def send_draw(self, display_list):
+        """
+        Have the Arduino draw a DisplayList on the selected display (or group)
+        
+        Returns:
+            bool: True if every batch was drawn
+        """
+        if not self.connection or not self.connection.is_open:
+            print("Error: Not connected to Arduino")
+            return False
+        if not self.select_display():
+            return False
+        
+        for batch in display_list.batches():
+            self.connection.write(f"DRAW:{len(batch)}\n".encode('utf-8') + batch)
+            self.connection.flush()
+            response = self.wait_for_response(None, timeout=5)
+            while response and not response.startswith(("OK:DRAW", "ERROR")):
+                response = self.wait_for_response(None, timeout=5)
+            if not response or not response.startswith("OK:DRAW"):
+                print(f"Error: {response or 'No reply to DRAW'}")
+                return False
+        return True
+    
+    def show_stored(self, image_id, position=None, rotation=None):
+        """
+        Draw an image from the Arduino's flash image store
+        
+        No pixel data is transferred. Without a position the image replaces
+        the screen, centered like a bitmap transfer; with one it is drawn over
+        the current content with its top-left corner at (x, y).
+        
+        Args:
+            image_id (str): Id the image was stored under
+            position (tuple): (x, y) display coordinates (optional)
+            rotation (int): Panel rotation the image was stored for (the
+                            rotation of its send_frame); position is then in
+                            that rotation's coordinates
+            
+        Returns:
+            bool: True if shown, False otherwise
+        """
+        if not self.connection or not self.connection.is_open:
+            print("Error: Not connected to Arduino")
+            return False
+        if not self.select_display():
+            return False
+        
+        command = f"IMG:SHOW:{image_id}"
+        if position:
+            command += ",{},{}".format(*position)
+        if rotation is not None:
+            command += f",ROT:{rotation}"
+        self.connection.write(f"{command}\n".encode('utf-8'))
+        self.connection.flush()
+        
+        response = self.wait_for_response(timeout=5)
+        while response and not response.startswith(("OK:", "ERROR")):
+            response = self.wait_for_response(timeout=5)
+        if not response or not response.startswith("OK:"):
+            print(f"Error: Could not show stored image '{image_id}'")
+            return False
+        
+        # The screen no longer matches the last frame sent
+        self.last_frames.pop(self.target_name(), None)
+        print(f"✓ Stored image '{image_id}' shown")
+        return True
+    
+    def send_multi(self, frames, compress=True):
+        """
+        Send frames to several displays in one MULTI transfer
+        
+        Rows of all frames are interleaved round-robin, each tagged with its
+        slot index, so the Arduino alternates SPI writes between the panels
+        without a DISPLAY/BMPStart handshake per panel.
+        
+        Args:
+            frames (list): (device_name, width, height, pixel_bytes) per display
+            compress (bool): Run-length encode the rows when smaller
+            
+        Returns:
+            bool: True if successful, False otherwise
+        """
+        if not self.connection or not self.connection.is_open:
+            print("Error: Not connected to Arduino")
+            return False
+        
+        slot_rows = [[pixel_bytes[row * width * 2:(row + 1) * width * 2] for row in range(height)]
+                     for _, width, height, pixel_bytes in frames]
+        spec = ";".join(f"{name},{width},{height}" for name, width, height, _ in frames)
+        if self.binary_status:
+            spec += ";BINARY"
+        
+        if compress:
+            raw_size = sum(len(row) for rows in slot_rows for row in rows)
+            encoded = [[encode_rle_row(row) for row in rows] for rows in slot_rows]
+            encoded_size = sum(len(row) for rows in encoded for row in rows)
+            if encoded_size < raw_size:
+                print(f"RLE: {raw_size} -> {encoded_size} bytes")
+                slot_rows = encoded
+                spec += ";RLE"
+        
+        # Interleave: row 0 of every display, then row 1, ...
+        packets = []
+        for row in range(max(len(rows) for rows in slot_rows)):
+            for slot, rows in enumerate(slot_rows):
+                if row < len(rows):
+                    packets.append(bytes([slot]) + rows[row])
+        
+        for name, _, _, _ in frames:
+            self.last_frames.pop(name, None)
+        
+        try:
+            print(f"\n=== Starting multi-display transmission ({len(frames)} displays) ===")
+            self.connection.write(f"MULTI:{spec}\n".encode('utf-8'))
+            self.connection.flush()
             
+            credits = self.wait_for_ready()
+            if credits is None:
+                return False
+            
+            bytes_sent, credits = self.send_pixel_rows(packets, credits)
             print(f"Pixel data sent: {bytes_sent} bytes")
             
-            # Step 4: Send end marker
-            print("Sending end marker...")
             self.connection.write(b"BMPEnd\n")
             self.connection.flush()
             
-            # Wait for completion confirmation
-            response = self.wait_for_response("COMPLETE", timeout=10)
-            if response and "COMPLETE" in response:
-                print("✓ Bitmap transmission completed successfully!")
-                return True
-            else:
-                print("Warning: Did not receive completion confirmation")
-                return True  # Still consider it successful
-                
+            if not self.wait_for_complete():
+                print("Error: Arduino did not confirm the transfer (no COMPLETE)")
+                return False
+            for name, width, height, pixel_bytes in frames:
+                self.last_frames[name] = (width, height, pixel_bytes)
+            print("✓ Multi-display transmission completed successfully!")
+            return True
+            
         except Exception as e:
             print(f"Error during transmission: {e}")
+            self.selected_display = None
+            return False
+    
+    def send_stream(self, width, height, frames, fps, delta=True, compress=True):
+        """
+        Play frames as an animation in one STREAM session
+        
+        Frames follow each other without a handshake: each is a full frame or,
+        with delta=True, only its tiles that differ from the frame before. The
+        Arduino paces them to fps through the flow-control credits. A frame
+        whose slot has already passed by the time the previous one is out is
+        dropped rather than sent late, so a slow link skips frames instead of
+        falling behind; the last frame is always shown.
+        
+        Args:
+            width, height (int): Frame dimensions
+            frames (list): Big-endian RGB565 data of each frame, row-major
+            fps (int): Target frame rate (0 = as fast as possible)
+            delta (bool): Send dirty rectangles when cheaper than a full frame
+            compress (bool): Run-length encode the rows (SIZE option RLE)
+            
+        Returns:
+            bool: True if successful, False otherwise
+        """
+        if not self.connection or not self.connection.is_open:
+            print("Error: Not connected to Arduino")
+            return False
+        if self.group or not self.display_config:
+            print("Error: Streaming needs a single display (--device or --config)")
+            return False
+        
+        display_key = self.target_name()
+        options = ""
+        if compress:
+            options += ",RLE"
+        if self.binary_status:
+            options += ",BINARY"
+        row_size = width * 2
+        
+        self.last_frames.pop(display_key, None)
+        sent = dropped = 0
+        previous = None
+        
+        try:
+            print(f"\n=== Starting stream: {len(frames)} frames of {width}x{height} at {fps} fps ===")
+            self.connection.write(f"STREAM:{display_key},{width},{height},{fps}{options}\n".encode('utf-8'))
+            self.connection.flush()
+            
+            credits = self.wait_for_ready()
+            if credits is None:
+                return False
+            
+            start = time.monotonic()
+            for index, pixel_bytes in enumerate(frames):
+                # Late frames are skipped rather than queued behind the link
+                if fps and index < len(frames) - 1 and time.monotonic() >= start + (index + 1) / fps:
+                    dropped += 1
+                    continue
+                
+                rects = None
+                if delta and previous is not None:
+                    rects = compute_dirty_rects(previous, pixel_bytes, width, height)
+                    if sum(w * h for _, _, w, h in rects) > width * height * DELTA_MAX_FRACTION:
+                        rects = None
+                
+                if rects is None:
+                    self.connection.write(b"FRAME\n")
+                    rows = [pixel_bytes[row * row_size:(row + 1) * row_size] for row in range(height)]
+                    if compress:
+                        rows = [encode_rle_row(row) for row in rows]
+                    _, credits = self.send_pixel_rows(rows, credits, show_progress=False)
+                else:
+                    self.connection.write(f"FRAME:{len(rects)}\n".encode('utf-8'))
+                    for x, y, w, h in rects:
+                        self.connection.write(f"RECT:{x},{y},{w},{h}\n".encode('utf-8'))
+                        rows = [pixel_bytes[row * row_size + x * 2:row * row_size + (x + w) * 2]
+                                for row in range(y, y + h)]
+                        if compress:
+                            rows = [encode_rle_row(row) for row in rows]
+                        _, credits = self.send_pixel_rows(rows, credits, show_progress=False)
+                
+                previous = pixel_bytes
+                sent += 1
+            
+            self.connection.write(b"STREAM_END\n")
+            self.connection.flush()
+            elapsed = time.monotonic() - start
+            
+            completed = self.wait_for_complete()
+            print(f"Sent {sent} frames, dropped {dropped}, {sent / elapsed if elapsed else 0:.1f} fps")
+            if not completed:
+                print("Error: Arduino did not confirm the stream (no COMPLETE)")
+                return False
+            if previous is not None:
+                self.last_frames[display_key] = (width, height, previous)
+            print("✓ Stream completed successfully!")
+            return True
+            
+        except Exception as e:
+            print(f"Error during stream: {e}")
+            self.selected_display = None
             return False
     
     def send_test_pattern(self):
@@ -383,25 +1504,15 @@ class BitmapSender:
         
         try:
             # Step 0: Select target display (v3.0 protocol)
-            if self.display_config:
-                print(f"Selecting display: {self.display_config.name}...")
-                display_command = f"DISPLAY:{self.display_config.name}\n"
-                self.connection.write(display_command.encode('utf-8'))
-                self.connection.flush()
-                
-                # Wait for DISPLAY_READY response
-                response = self.wait_for_response("DISPLAY_READY", timeout=3)
-                if not response or "DISPLAY_READY" not in response:
-                    print("Error: Arduino did not confirm display selection")
-                    return False
-                print(f"✓ Display {self.display_config.name} selected")
+            if not self.select_display():
+                return False
             
             # Send start marker
             self.connection.write(b"BMPStart\n")
             self.connection.flush()
             
             # Send dimensions
-            size_command = f"SIZE:{width},{height}\n"
+            size_command = f"SIZE:{width},{height},CREDIT\n"
             self.connection.write(size_command.encode('utf-8'))
             self.connection.flush()
             
@@ -411,10 +1522,18 @@ class BitmapSender:
                 print("Error: Arduino not ready for test pattern")
                 return False
             
+            credits = self.wait_for_credits()
+            if credits is None:
+                print("Error: Arduino did not advertise flow-control credits")
+                return False
+            
             # Send pixels
-            for pixel_bytes in pixel_data:
-                self.connection.write(pixel_bytes)
-            self.connection.flush()
+            pixel_bytes = b''.join(pixel_data)
+            self.send_pixel_rows([pixel_bytes[row * width * 2:(row + 1) * width * 2] for row in range(height)],
+                                 credits)
+            
+            # The screen no longer shows the last frame sent
+            self.last_frames.pop(self.target_name(), None)
             
             # Send end marker
             self.connection.write(b"BMPEnd\n")
@@ -514,6 +1633,141 @@ def open_file_picker(title="Select Image File"):
         print(f"Error opening file picker: {e}")
         return None
 
+def load_manifest(manifest_path):
+    """
+    Read a batch manifest: a JSON list of {"port", "display", "image"} entries
+    
+    "port" is the serial port of the board, "display" the device name of one of
+    its panels (a .config next to the manifest or in the current directory) and
+    "image" the image file, relative to the manifest.
+    
+    Returns:
+        list: (port, display_config, image_path) per entry, or None on error
+    """
+    manifest_path = Path(manifest_path)
+    try:
+        with open(manifest_path) as f:
+            items = json.load(f)
+    except (OSError, ValueError) as e:
+        print(f"Error reading manifest {manifest_path}: {e}")
+        return None
+    if not isinstance(items, list):
+        print(f"Error: Manifest {manifest_path} must be a list of entries")
+        return None
+    
+    configs = {}
+    entries = []
+    for index, item in enumerate(items):
+        try:
+            port, display, image = item['port'], item['display'], item['image']
+        except (TypeError, KeyError):
+            print(f"Error: Manifest entry {index} needs port, display and image")
+            return None
+        if display not in configs:
+            configs[display] = (get_config_by_device_name(display, str(manifest_path.parent)) or
+                                get_config_by_device_name(display))
+        if not configs[display]:
+            print(f"Error: No configuration found for device '{display}' (manifest entry {index})")
+            return None
+        image_path = manifest_path.parent / image
+        if not image_path.exists():
+            print(f"Error: Image file '{image_path}' not found (manifest entry {index})")
+            return None
+        entries.append((port, configs[display], str(image_path)))
+    return entries
+
+def prepare_batch_frame(job):
+    """Process pool worker for run_batch(): fit one image to one display config"""
+    image_path, display_config, use_cache = job
+    sender = BitmapSender(display_config=display_config, frame_cache=FrameCache() if use_cache else None)
+    return sender.prepare_image(image_path)
+
+def send_port_batch(port, frames, binary_status=True, **options):
+    """
+    Thread worker for run_batch(): one connection, every frame for port in order
+    
+    Args:
+        frames (list): (display_config, (width, height, pixel_bytes) or None)
+        options: compress, snapshot, indexed as in BitmapSender.send_frame
+    
+    Returns:
+        tuple: (frames sent, seconds, error message or None)
+    
+    A serial error ends this port's run only; the frames left over count as
+    failed so the other ports still report.
+    """
+    start = time.perf_counter()
+    sender = BitmapSender(port, binary_status=binary_status)
+    sent = 0
+    error = None
+    try:
+        if not sender.connect():
+            return 0, time.perf_counter() - start, "could not connect"
+        for display_config, frame in frames:
+            sender.display_config = display_config
+            if frame and sender.send_frame(*frame, **options):
+                sent += 1
+    except Exception as e:
+        error = str(e) or type(e).__name__
+    finally:
+        sender.disconnect()
+    return sent, time.perf_counter() - start, error
+
+def run_batch(manifest_path, processes=None, use_cache=True, binary_status=True, **options):
+    """
+    Push a manifest of images to many boards at once
+    
+    Every distinct (image, display) pair is converted once, in a process pool
+    sharing the frame cache; then each serial port gets its own thread that
+    connects and sends its frames in manifest order. The boards' connect waits
+    and transfers overlap, so the batch takes about as long as the slowest
+    board.
+    
+    Args:
+        manifest_path (str): Manifest file (see load_manifest)
+        processes (int): Conversion processes (None = one per CPU)
+        use_cache (bool): Use the preconverted frame cache
+        binary_status (bool): As for BitmapSender
+        options: compress, snapshot, indexed as in BitmapSender.send_frame
+    
+    Returns:
+        bool: True if every frame was sent
+    """
+    entries = load_manifest(manifest_path)
+    if entries is None:
+        return False
+    if not entries:
+        print("Manifest is empty, nothing to send")
+        return True
+    
+    start = time.perf_counter()
+    jobs = {}
+    for _, config, image_path in entries:
+        jobs.setdefault((image_path, config.name), (image_path, config, use_cache))
+    print(f"Converting {len(jobs)} image(s)...")
+    with ProcessPoolExecutor(max_workers=processes) as pool:
+        prepared = dict(zip(jobs, pool.map(prepare_batch_frame, jobs.values())))
+    converted = time.perf_counter()
+    
+    ports = {}
+    for port, config, image_path in entries:
+        ports.setdefault(port, []).append((config, prepared[(image_path, config.name)]))
+    print(f"Sending to {len(ports)} port(s)...")
+    with ThreadPoolExecutor(max_workers=len(ports)) as pool:
+        results = {port: pool.submit(send_port_batch, port, frames, binary_status=binary_status, **options)
+                   for port, frames in ports.items()}
+    
+    total_sent = 0
+    print(f"\n=== Batch: {len(entries)} frame(s), conversion {converted - start:.1f} s, "
+          f"total {time.perf_counter() - start:.1f} s ===")
+    for port, future in results.items():
+        sent, seconds, error = future.result()
+        total_sent += sent
+        mark = "✓" if sent == len(ports[port]) else "✗"
+        print(f"  {mark} {port}: {sent}/{len(ports[port])} frame(s) in {seconds:.1f} s"
+              + (f" ({error})" if error else ""))
+    return total_sent == len(entries)
+
 def main():
     parser = argparse.ArgumentParser(
         description="Send bitmap images to Arduino Due ST7735 display",
@@ -527,6 +1781,14 @@ Examples:
   python3 bitmap_sender.py --device DueLCD01 image.jpg
   python3 bitmap_sender.py --config DueLCD02.config photo.png
   python3 bitmap_sender.py --test-pattern /dev/ttyUSB0
+  python3 bitmap_sender.py --multi DueLCD01=a.png DueLCD02=b.png --port /dev/ttyACM0
+  python3 bitmap_sender.py --group ALL --device DueLCD01 image.jpg   # Mirror to every display
+  python3 bitmap_sender.py --device DueLCD01 --store logo logo.png   # Show and keep in flash
+  python3 bitmap_sender.py --device DueLCD01 --show logo             # Recall without sending
+  python3 bitmap_sender.py --device DueLCD01 --snapshot image.jpg    # Keep for CMD:REPAINT
+  python3 bitmap_sender.py --device DueLCD01 --stream 20 clip.gif    # Play an animation
+  python3 bitmap_sender.py --device DueLCD01 --daemon image.jpg      # Through display_daemon.py
+  python3 bitmap_sender.py --batch rack.json                         # Many boards in parallel
   python3 bitmap_sender.py --list-configs
         """
     )
@@ -546,6 +1808,40 @@ Examples:
                        help='Path to device config file (e.g., DueLCD01.config)')
     parser.add_argument('--list-configs', action='store_true',
                        help='List available device configurations')
+    parser.add_argument('--raw', action='store_true',
+                       help='Send uncompressed pixel data (disable RLE)')
+    parser.add_argument('--multi', nargs='+', metavar='DEVICE=IMAGE',
+                       help='Send one image per device in a single multi-display transfer')
+    parser.add_argument('--group', '-g', type=str,
+                       help='Mirror the image to a display group (sized from --device/--config)')
+    parser.add_argument('--no-cache', action='store_true',
+                       help='Do not use the preconverted frame cache (~/.cache/st7735/frames)')
+    parser.add_argument('--store', type=str, metavar='ID',
+                       help='Also save the image in the Arduino flash image store under ID')
+    parser.add_argument('--show', type=str, metavar='ID',
+                       help='Draw an image from the Arduino flash image store (no image file)')
+    parser.add_argument('--at', type=str, metavar='X,Y',
+                       help='With --show: draw at display position X,Y over the current content')
+    parser.add_argument('--snapshot', action='store_true',
+                       help='Keep the image in Arduino RAM so CMD:REPAINT can redraw it')
+    parser.add_argument('--port', '-p', type=str,
+                       help='Serial port (alternative to the positional argument)')
+    parser.add_argument('--stream', type=int, metavar='FPS',
+                       help='Play the frames of an animated image (GIF, APNG, WebP) at FPS')
+    parser.add_argument('--indexed', action='store_true',
+                       help='Send images of up to 256 colors as 1/2/4/8-bit palette indices when smaller')
+    parser.add_argument('--rotation', type=int, choices=range(4), metavar='N',
+                       help='The image is sized for panel rotation N (0-3); shown as such after CMD:ORIENTATION')
+    parser.add_argument('--tiles', action='store_true',
+                       help='Send CRC-checked tiles; only tiles damaged on the way are resent')
+    parser.add_argument('--text-status', action='store_true',
+                       help='Ask for the verbose text progress lines instead of binary status packets')
+    parser.add_argument('--batch', type=str, metavar='MANIFEST',
+                       help='Send the images of a JSON manifest of {port, display, image} entries, one thread per port')
+    parser.add_argument('--jobs', '-j', type=int, metavar='N',
+                       help='With --batch: image conversion processes (default: one per CPU)')
+    parser.add_argument('--daemon', nargs='?', const='/tmp/st7735_display.sock', metavar='SOCKET',
+                       help='Queue the image with a running display_daemon.py instead of opening the port')
     
     args = parser.parse_args()
     
@@ -606,6 +1902,77 @@ Examples:
             print("\nFile selection cancelled by user.")
             return 0
     
+    if args.port:
+        args.serial_port = args.port
+    
+    # Batch: many boards, each on its own port, converted and sent in parallel
+    if args.batch:
+        try:
+            success = run_batch(args.batch, processes=args.jobs, use_cache=not args.no_cache,
+                                binary_status=not args.text_status, compress=not args.raw,
+                                snapshot=args.snapshot, indexed=args.indexed, rotation=args.rotation)
+        except KeyboardInterrupt:
+            print("\nOperation cancelled by user")
+            return 1
+        print("\n✓ Operation completed successfully!" if success else "\n✗ Operation failed!")
+        return 0 if success else 1
+    
+    # Multi-display transfer: each image is fitted to its own device config
+    if args.multi:
+        sender = BitmapSender(args.serial_port, frame_cache=None if args.no_cache else FrameCache(),
+                              binary_status=not args.text_status)
+        frames = []
+        for item in args.multi:
+            device, sep, image_file = item.partition('=')
+            config = get_config_by_device_name(device) if sep else None
+            if not config:
+                print(f"Error: Expected DEVICE=IMAGE with a known device, got '{item}'")
+                return 1
+            image_data = sender.prepare_image(image_file, config)
+            if not image_data:
+                return 1
+            width, height, pixel_bytes = image_data
+            frames.append((config.name, width, height, pixel_bytes))
+        
+        try:
+            if not sender.connect():
+                return 1
+            success = sender.send_multi(frames, compress=not args.raw)
+            print("\n✓ Operation completed successfully!" if success else "\n✗ Operation failed!")
+            return 0 if success else 1
+        except KeyboardInterrupt:
+            print("\nOperation cancelled by user")
+            return 1
+        finally:
+            sender.disconnect()
+    
+    # Recall from the flash image store: only a command goes over the wire
+    if args.show:
+        position = None
+        if args.at:
+            try:
+                position = tuple(int(v) for v in args.at.split(','))
+            except ValueError:
+                position = ()
+            if len(position) != 2:
+                print(f"Error: Expected --at X,Y, got '{args.at}'")
+                return 1
+        if not display_config and not args.group:
+            print("Error: --show needs --device, --config or --group to select the target")
+            return 1
+        sender = BitmapSender(args.serial_port, display_config=display_config, group=args.group)
+        try:
+            if not sender.connect():
+                return 1
+            success = sender.show_stored(args.show, position, rotation=args.rotation)
+            print("\n✓ Operation completed successfully!" if success else "\n✗ Operation failed!")
+            return 0 if success else 1
+        except KeyboardInterrupt:
+            print("\nOperation cancelled by user")
+            return 1
+        finally:
+            sender.disconnect()
+    
     # Validate arguments
     if not args.test_pattern and not args.image_file:
         print("Error: Please specify an image file, use --gui, or use --test-pattern")
@@ -616,8 +1983,39 @@ Examples:
         print(f"Error: Image file '{args.image_file}' not found")
         return 1
     
+    # Hand the prepared frame to the daemon that owns the port
+    if args.daemon:
+        if args.test_pattern or args.stream is not None or args.store or args.tiles:
+            print("Error: --daemon sends still images only (no --test-pattern, --stream, --store or --tiles)")
+            return 1
+        if not display_config:
+            print("Error: --daemon needs --device or --config to size and address the image")
+            return 1
+        from display_daemon import DaemonClient
+        sender = BitmapSender(display_config=display_config,
+                              frame_cache=None if args.no_cache else FrameCache())
+        image_data = sender.prepare_image(args.image_file)
+        if not image_data:
+            return 1
+        width, height, pixel_bytes = image_data
+        try:
+            with DaemonClient(args.daemon) as client:
+                reply = client.send_frame(display_config.name, width, height, pixel_bytes, group=args.group,
+                                          compress=not args.raw, snapshot=args.snapshot, indexed=args.indexed,
+                                          rotation=args.rotation)
+        except OSError as e:
+            print(f"Error: Could not reach the display daemon on {args.daemon}: {e}")
+            return 1
+        if not reply.get('ok'):
+            print(f"\n✗ Operation failed: {reply.get('error', reply.get('status'))}")
+            return 1
+        print(f"\n✓ Frame {reply['status']}")
+        return 0
+    
     # Create bitmap sender with optional display config
-    sender = BitmapSender(args.serial_port, display_config=display_config)
+    sender = BitmapSender(args.serial_port, display_config=display_config, group=args.group,
+                          frame_cache=None if args.no_cache else FrameCache(),
+                          binary_status=not args.text_status)
     
     try:
         # Connect to Arduino
@@ -627,8 +2025,14 @@ Examples:
         # Send test pattern or image
         if args.test_pattern:
             success = sender.send_test_pattern()
+        elif args.stream is not None:
+            animation = sender.prepare_animation(args.image_file)
+            success = animation is not None and sender.send_stream(*animation, fps=args.stream,
+                                                                   compress=not args.raw)
         else:
-            success = sender.send_bitmap(args.image_file)
+            success = sender.send_bitmap(args.image_file, compress=not args.raw, store_id=args.store,
+                                         snapshot=args.snapshot, tiles=args.tiles,
+                                         indexed=args.indexed, rotation=args.rotation)
         
         if success:
             print("\n✓ Operation completed successfully!")
@@ -9,7 +9,8 @@ Features:
 - Test displays
 - Frame control
 - Image upload with file picker
-- Single serial connection to Native USB port (/dev/ttyACM0)
+- Single serial connection to Native USB port (/dev/ttyACM0), or commands
+  and images through a running display_daemon.py (--daemon)
 
 Requirements:
 - Python 3.6+
@@ -19,11 +20,13 @@ Requirements:
 
 Usage:
     python3 display_control.py
+    python3 display_control.py --daemon [SOCKET]   # Share the port with display_daemon.py
 """
 
 import sys
 import time
 import re
+import argparse
 import tkinter as tk
 from tkinter import ttk, filedialog, messagebox, scrolledtext
 from pathlib import Path
@@ -43,6 +46,7 @@ CHUNK_SIZE = 1024  # Send 1024 pixels (2048 bytes) at a time for faster transfer
 SETTINGS_FILE = Path.home() / '.st7735_display_control.json'
 DEFAULT_IMAGE_DIR = Path.home() / 'Pictures'
 LOCK_FILE = '/tmp/st7735_display_control.lock'
+DAEMON_SOCKET = '/tmp/st7735_display.sock'
 
 def find_arduino_due_port():
     """Automatically detect Arduino Due Native USB port"""
@@ -99,11 +103,19 @@ def find_arduino_due_port():
     return ports[0] if ports else None
 
 class DisplayController:
-    """Handles serial communication with unified CMD:/DISPLAY: protocol"""
+    """
+    Handles serial communication with unified CMD:/DISPLAY: protocol
     
-    def __init__(self, serial_port=None, baudrate=SERIAL_BAUDRATE):
+    With daemon_socket set, the port stays with a running display_daemon.py:
+    commands (CMD:BATCH included) and images go through its DaemonClient, and
+    the daemon selects the active display for each of them.
+    """
+    
+    def __init__(self, serial_port=None, baudrate=SERIAL_BAUDRATE, daemon_socket=None):
         self.serial_port = serial_port
         self.baudrate = baudrate
+        self.daemon_socket = daemon_socket
+        self.daemon = None
         self.connection = None
         self.active_display = None
         self.displays = []
@@ -112,6 +124,8 @@ class DisplayController:
         
     def connect(self, auto_reconnect=False):
         """Establish serial connection"""
+        if self.daemon_socket:
+            return self.connect_daemon()
         try:
             # Auto-detect port if not specified or if reconnecting
             if not self.serial_port or auto_reconnect:
@@ -148,8 +162,43 @@ class DisplayController:
             print(f"Connection error: {e}")
             return False
     
+    def connect_daemon(self):
+        """Attach to display_daemon.py; it already owns the port, so there is no reset wait"""
+        from display_daemon import DaemonClient
+        try:
+            print(f"Connecting to display daemon on {self.daemon_socket}...")
+            self.daemon = DaemonClient(self.daemon_socket)
+            status = self.daemon.status()
+        except (OSError, ValueError) as e:
+            print(f"Connection error: No display daemon on {self.daemon_socket}: {e}")
+            self.daemon = None
+            return False
+        self.serial_port = f"{status.get('port')} (daemon)"
+        print("Connection established!")
+        return True
+    
+    def is_connected(self):
+        if self.daemon_socket:
+            return self.daemon is not None
+        return bool(self.connection and self.connection.is_open)
+    
+    def daemon_request(self, send):
+        """Run one DaemonClient call; a lost daemon reads as a failed reply"""
+        if not self.daemon:
+            return {'ok': False, 'error': 'Not connected'}
+        try:
+            return send(self.daemon)
+        except (OSError, ValueError) as e:
+            self.daemon.close()
+            self.daemon = None
+            return {'ok': False, 'error': f"Daemon connection lost - {e}"}
+    
     def disconnect(self):
         """Close serial connection"""
+        if self.daemon:
+            self.daemon.close()
+            self.daemon = None
+            print("Disconnected from display daemon")
         if self.connection and self.connection.is_open:
             self.connection.close()
             print("Disconnected from Arduino")
@@ -181,6 +230,11 @@ class DisplayController:
     
     def send_command(self, command):
         """Send a CMD: prefixed command and return response"""
+        if self.daemon_socket:
+            reply = self.daemon_request(lambda client: client.command(command, display=self.active_display))
+            if reply.get('lines'):
+                return '\n'.join(reply['lines'])
+            return f"ERROR:{reply.get('error', 'No response')}"
         if not self.connection or not self.connection.is_open:
             return "ERROR:Not connected"
         
@@ -223,6 +277,12 @@ class DisplayController:
         except Exception as e:
             return f"ERROR:Communication failed - {e}"
     
+    def send_batch(self, commands):
+        """Send several commands as one CMD:BATCH: applied together, one redraw and one response"""
+        if len(commands) == 1:
+            return self.send_command(commands[0])
+        return self.send_command('BATCH:' + ';'.join(commands))
+    
     def get_display_list(self):
         """Get list of displays using CMD:LIST"""
         response = self.send_command('LIST')
@@ -246,6 +306,13 @@ class DisplayController:
     
     def select_display(self, display_name):
         """Select a display using DISPLAY: command"""
+        if self.daemon_socket:
+            # The daemon selects the display for every request; INFO checks that it exists
+            reply = self.daemon_request(lambda client: client.command('INFO', display=display_name))
+            if not reply.get('ok'):
+                return f"ERROR:{reply.get('error') or ' '.join(reply.get('lines', []))}"
+            self.active_display = display_name
+            return f"OK:Display selected: {display_name}"
         if not self.connection or not self.connection.is_open:
             return "ERROR:Not connected"
         
@@ -293,6 +360,15 @@ class DisplayController:
             if progress_callback:
                 progress_callback(f"Sending bitmap: {width}x{height}")
             
+            if self.daemon_socket:
+                pixel_bytes = b''.join(struct.pack('>H', ((r >> 3) << 11) | ((g >> 2) << 5) | (b >> 3))
+                                       for r, g, b in img.getdata())
+                reply = self.daemon_request(
+                    lambda client: client.send_frame(self.active_display, width, height, pixel_bytes))
+                if not reply.get('ok'):
+                    return f"ERROR:{reply.get('error', reply.get('status'))}"
+                return "OK:Bitmap transfer complete"
+            
             # Send BMPStart
             self.connection.write(b"BMPStart\n")
             self.connection.flush()
@@ -377,13 +453,13 @@ class DisplayController:
 class DisplayControlGUI:
     """Tkinter GUI for display control"""
     
-    def __init__(self, master):
+    def __init__(self, master, daemon_socket=None):
         self.master = master
         master.title("ST7735 Display Control v3.1")
         master.geometry("800x700")  # Increased size to prevent button clipping
         master.minsize(800, 700)  # Set minimum size
         
-        self.controller = DisplayController()
+        self.controller = DisplayController(daemon_socket=daemon_socket)
         self.last_image_dir = self.load_settings().get('last_directory', str(DEFAULT_IMAGE_DIR))
         
         self.create_widgets()
@@ -811,7 +887,7 @@ class DisplayControlGUI:
         offset_top.pack(side=tk.LEFT, padx=2)
         offset_top.bind('<Return>', lambda e: apply_offset('TOP', int(offset_top.get())))
         
-        def adjust_top(delta, shift=False):
+        def adjust_top(delta, shift=False, send=True):
             if shift:
                 # Shift+click: adjust height
                 # Top+: increase height (top UP=-1, bottom DOWN=+1)
@@ -822,14 +898,16 @@ class DisplayControlGUI:
                 new_bottom = max(-max_bottom_adjust, min(max_bottom_adjust, current_bottom - delta))
                 offset_top.set(new_top)
                 offset_bottom.set(new_bottom)
-                apply_offset('TOP', new_top)
-                apply_offset('BOTTOM', new_bottom)
+                changes = {'TOP': new_top, 'BOTTOM': new_bottom}
             else:
                 # Normal click: move top edge only
                 current = int(offset_top.get())
                 new_val = max(-max_top_adjust, min(max_top_adjust, current + delta))
                 offset_top.set(new_val)
-                apply_offset('TOP', new_val)
+                changes = {'TOP': new_val}
+            if send:
+                apply_offsets(changes)
+            return changes
         
         top_plus_btn = ttk.Button(top_frame, text="+", width=3)
         top_plus_btn.pack(side=tk.LEFT, padx=1)
@@ -848,7 +926,7 @@ class DisplayControlGUI:
         offset_bottom.pack(side=tk.LEFT, padx=2)
         offset_bottom.bind('<Return>', lambda e: apply_offset('BOTTOM', int(offset_bottom.get())))
         
-        def adjust_bottom(delta, shift=False):
+        def adjust_bottom(delta, shift=False, send=True):
             if shift:
                 # Shift+click: adjust height
                 # Bottom+: increase height (bottom DOWN=+1, top UP=-1)
@@ -859,14 +937,16 @@ class DisplayControlGUI:
                 new_bottom = max(-max_bottom_adjust, min(max_bottom_adjust, current_bottom - delta))
                 offset_top.set(new_top)
                 offset_bottom.set(new_bottom)
-                apply_offset('TOP', new_top)
-                apply_offset('BOTTOM', new_bottom)
+                changes = {'TOP': new_top, 'BOTTOM': new_bottom}
             else:
                 # Normal click: move bottom edge only
                 current = int(offset_bottom.get())
                 new_val = max(-max_bottom_adjust, min(max_bottom_adjust, current + delta))
                 offset_bottom.set(new_val)
-                apply_offset('BOTTOM', new_val)
+                changes = {'BOTTOM': new_val}
+            if send:
+                apply_offsets(changes)
+            return changes
         
         bottom_plus_btn = ttk.Button(bottom_frame, text="+", width=3)
         bottom_plus_btn.pack(side=tk.LEFT, padx=1)
@@ -887,7 +967,7 @@ class DisplayControlGUI:
         offset_left.pack(side=tk.LEFT, padx=2)
         offset_left.bind('<Return>', lambda e: apply_offset('LEFT', int(offset_left.get())))
         
-        def adjust_left(delta, shift=False):
+        def adjust_left(delta, shift=False, send=True):
             if shift:
                 # Shift+click: adjust width
                 # Left+: increase width (left LEFT=-1, right RIGHT=+1)
@@ -898,14 +978,16 @@ class DisplayControlGUI:
                 new_right = max(-max_right_adjust, min(max_right_adjust, current_right - delta))
                 offset_left.set(new_left)
                 offset_right.set(new_right)
-                apply_offset('LEFT', new_left)
-                apply_offset('RIGHT', new_right)
+                changes = {'LEFT': new_left, 'RIGHT': new_right}
             else:
                 # Normal click: move left edge only
                 current = int(offset_left.get())
                 new_val = max(-max_left_adjust, min(max_left_adjust, current + delta))
                 offset_left.set(new_val)
-                apply_offset('LEFT', new_val)
+                changes = {'LEFT': new_val}
+            if send:
+                apply_offsets(changes)
+            return changes
         
         left_plus_btn = ttk.Button(left_inner, text="+", width=3)
         left_plus_btn.pack(side=tk.LEFT, padx=1)
@@ -924,7 +1006,7 @@ class DisplayControlGUI:
         offset_right.pack(side=tk.LEFT, padx=2)
         offset_right.bind('<Return>', lambda e: apply_offset('RIGHT', int(offset_right.get())))
         
-        def adjust_right(delta, shift=False):
+        def adjust_right(delta, shift=False, send=True):
             if shift:
                 # Shift+click: adjust width
                 # Right+: increase width (right RIGHT=+1, left LEFT=-1)
@@ -935,14 +1017,16 @@ class DisplayControlGUI:
                 new_right = max(-max_right_adjust, min(max_right_adjust, current_right - delta))
                 offset_left.set(new_left)
                 offset_right.set(new_right)
-                apply_offset('LEFT', new_left)
-                apply_offset('RIGHT', new_right)
+                changes = {'LEFT': new_left, 'RIGHT': new_right}
             else:
                 # Normal click: move right edge only
                 current = int(offset_right.get())
                 new_val = max(-max_right_adjust, min(max_right_adjust, current + delta))
                 offset_right.set(new_val)
-                apply_offset('RIGHT', new_val)
+                changes = {'RIGHT': new_val}
+            if send:
+                apply_offsets(changes)
+            return changes
         
         right_plus_btn = ttk.Button(right_inner, text="+", width=3)
         right_plus_btn.pack(side=tk.LEFT, padx=1)
@@ -959,22 +1043,26 @@ class DisplayControlGUI:
         
         def move_all(direction):
             """Move all sides in the same direction (translation, not resize)"""
+            # Both edges go in one CMD:BATCH, so the frame is redrawn once
+            changes = {}
             if direction == 'up':
-                adjust_top(-1, shift=False)
-                adjust_bottom(-1, shift=False)
+                changes.update(adjust_top(-1, send=False))
+                changes.update(adjust_bottom(-1, send=False))
             elif direction == 'down':
-                adjust_top(1, shift=False)
-                adjust_bottom(1, shift=False)
+                changes.update(adjust_top(1, send=False))
+                changes.update(adjust_bottom(1, send=False))
             elif direction == 'left':
                 # Move frame left: both edges move left
                 # Note: LEFT adjustment is inverted in firmware (+ moves right, - moves left)
-                adjust_left(-1, shift=False)   # Left edge moves left (negative because inverted)
-                adjust_right(-1, shift=False)  # Right edge moves left (negative)
+                changes.update(adjust_left(-1, send=False))   # Left edge moves left (negative because inverted)
+                changes.update(adjust_right(-1, send=False))  # Right edge moves left (negative)
             elif direction == 'right':
                 # Move frame right: both edges move right
                 # Note: LEFT adjustment is inverted in firmware (+ moves right, - moves left)
-                adjust_left(1, shift=False)   # Left edge moves right (positive because inverted)
-                adjust_right(1, shift=False)  # Right edge moves right (positive)
+                changes.update(adjust_left(1, send=False))   # Left edge moves right (positive because inverted)
+                changes.update(adjust_right(1, send=False))  # Right edge moves right (positive)
+            if changes:
+                apply_offsets(changes)
         
         ttk.Button(all_frame, text="↑ Up", command=lambda: move_all('up'), width=8).pack(side=tk.LEFT, padx=2)
         ttk.Button(all_frame, text="↓ Down", command=lambda: move_all('down'), width=8).pack(side=tk.LEFT, padx=2)
@@ -983,9 +1071,14 @@ class DisplayControlGUI:
         
         def apply_offset(side, value):
             """Apply offset to one side and refresh pattern"""
-            response = self.controller.send_command(f'ADJUST_{side}:{value}')
+            apply_offsets({side: value})
+        
+        def apply_offsets(changes):
+            """Apply offsets to several sides as one batch (one redraw) and refresh pattern"""
+            response = self.controller.send_batch([f'ADJUST_{side}:{value}' for side, value in changes.items()])
+            summary = ", ".join(f"{side}: {value}" for side, value in changes.items())
             if "OK" in response:
-                status_label.config(text=f"✓ Adjusted {side}: {value}", foreground="green")
+                status_label.config(text=f"✓ Adjusted {summary}", foreground="green")
             else:
                 status_label.config(text=f"✗ Offset Error: {response}", foreground="red")
         
@@ -1001,20 +1094,15 @@ class DisplayControlGUI:
             status_label.config(text="Applying frame parameters...", foreground="blue")
             cal_dialog.update()
             
-            # Set color
-            response = self.controller.send_command(f'FRAME_COLOR:{color}')
+            # Color, thickness and the pattern redraw in one batch; nothing changes on error
+            response = self.controller.send_batch([f'FRAME_COLOR:{color}',
+                                                   f'FRAME_THICKNESS:{thickness}',
+                                                   'CALIBRATE'])
             if "ERROR" in response:
-                status_label.config(text=f"✗ Color Error: {response}", foreground="red")
-                return
-            
-            # Set thickness
-            response = self.controller.send_command(f'FRAME_THICKNESS:{thickness}')
-            if "ERROR" in response:
-                status_label.config(text=f"✗ Thickness Error: {response}", foreground="red")
+                status_label.config(text=f"✗ Frame Error: {response}", foreground="red")
                 return
             
             status_label.config(text="✓ Parameters applied", foreground="green")
-            show_pattern()
         
         def show_pattern():
             status_label.config(text="Sending calibration pattern...", foreground="blue")
@@ -1040,8 +1128,7 @@ class DisplayControlGUI:
             offset_bottom.set(0)
             offset_left.set(0)
             offset_right.set(0)
-            for side in ['TOP', 'BOTTOM', 'LEFT', 'RIGHT']:
-                self.controller.send_command(f'ADJUST_{side}:0')
+            self.controller.send_batch([f'ADJUST_{side}:0' for side in ['TOP', 'BOTTOM', 'LEFT', 'RIGHT']])
             status_label.config(text="✓ Offsets reset", foreground="green")
         
         def save_and_exit():
@@ -1168,14 +1255,12 @@ class DisplayControlGUI:
                 except Exception as e:
                     print(f"Error reading .config file: {e}")
                     # Fallback: restore to original values from when dialog opened
-                    self.controller.send_command(f'ADJUST_TOP:{original_offsets.get("TOP", 0)}')
-                    self.controller.send_command(f'ADJUST_BOTTOM:{original_offsets.get("BOTTOM", 0)}')
-                    self.controller.send_command(f'ADJUST_LEFT:{original_offsets.get("LEFT", 0)}')
-                    self.controller.send_command(f'ADJUST_RIGHT:{original_offsets.get("RIGHT", 0)}')
+                    self.controller.send_batch([f'ADJUST_{side}:{original_offsets.get(side, 0)}'
+                                                for side in ['TOP', 'BOTTOM', 'LEFT', 'RIGHT']])
             
             # Restore original color/thickness
-            self.controller.send_command(f'FRAME_COLOR:{original_color}')
-            self.controller.send_command(f'FRAME_THICKNESS:{original_thickness}')
+            self.controller.send_batch([f'FRAME_COLOR:{original_color}',
+                                        f'FRAME_THICKNESS:{original_thickness}'])
             cal_dialog.destroy()
         
         ttk.Button(control_frame, text="Apply Color/Thickness", 
@@ -1288,7 +1373,7 @@ class DisplayControlGUI:
     
     def update_button_states(self):
         """Update button states based on connection and display selection"""
-        connected = self.controller.connection and self.controller.connection.is_open
+        connected = self.controller.is_connected()
         has_displays = len(self.controller.displays) > 0
         display_selected = self.controller.active_display is not None
         
@@ -1374,6 +1459,12 @@ class DisplayControlGUI:
 
 def main():
     """Main entry point"""
+    parser = argparse.ArgumentParser(description="ST7735 display control and calibration GUI")
+    parser.add_argument('--daemon', nargs='?', const=DAEMON_SOCKET, metavar='SOCKET',
+                        help='Send commands and images through a running display_daemon.py '
+                             'instead of opening the port')
+    args = parser.parse_args()
+    
     # Check for single instance
     lock_file = None
     try:
@@ -1394,7 +1485,7 @@ def main():
     
     try:
         root = tk.Tk()
-        app = DisplayControlGUI(root)
+        app = DisplayControlGUI(root, daemon_socket=args.daemon)
         root.protocol("WM_DELETE_WINDOW", app.on_closing)
         root.mainloop()
     finally:
@@ -0,0 +1,506 @@
+#!/usr/bin/env python3
+"""
+Display daemon for the ST7735 bitmap protocol
+
+Owns the serial link to the Arduino Due and keeps the session warm: the port
+is opened once (the 5 second reset wait is paid at startup, not per image)
+and the last selected display stays selected, so consecutive frames for the
+same panel go straight to BMPStart without a DISPLAY: handshake. Display
+switches go through CMD:RESET, as the firmware only accepts DISPLAY: in
+display selection.
+
+Producers talk to the daemon over a Unix socket. Requests are queued and
+sent by a single worker thread in arrival order, with per-display
+coalescing: a frame for a display replaces the frame still waiting for that
+display (the replaced request is answered "superseded"), so a slow link
+shows the newest frame of every panel instead of working through a backlog.
+The previous frame of every display stays known across requests, so delta
+updates work between producers and across separate client runs.
+
+Socket protocol: each request is one JSON line, followed by "length" payload
+bytes for ops that carry data; each request gets one JSON line back with
+"ok" and "status". A connection can carry any number of requests.
+
+    {"op": "frame", "display": "DueLCD01", "width": 60, "height": 50,
+     "length": 6000, "delta": true}            + big-endian RGB565 pixels
+    {"op": "draw", "display": "DueLCD01", "ops": [11, 14]}
+                                                + DisplayList op bytes
+    {"op": "command", "command": "STATS"}      -> "lines": the CMD: reply
+    {"op": "status"}                           -> queue and link counters
+
+"display" is a device name, "group" a display group instead. Frames also take
+"compress", "indexed", "snapshot" and "rotation" (see BitmapSender.send_frame) and, with
+"wait": false, are answered "queued" as soon as they are accepted. "timeout"
+(seconds, default 60) bounds how long a request waits to be sent; one that
+is still queued then is dropped and answered "timeout". While the serial
+link is down the daemon retries with a growing pause and, after a handful of
+attempts, fails everything queued instead of holding it.
+
+Usage:
+    python3 display_daemon.py [serial_port] [--socket PATH]
+
+Example:
+    python3 display_daemon.py /dev/ttyACM0 &
+    python3 bitmap_sender.py --device DueLCD01 --daemon image.png
+"""
+
+import sys
+import time
+import json
+import argparse
+import threading
+import socket
+import socketserver
+import os
+import signal
+from pathlib import Path
+
+from bitmap_sender import BitmapSender, DisplayList, SERIAL_BAUDRATE
+from st7735_tools.config_loader import get_config_by_device_name
+
+DEFAULT_SOCKET = '/tmp/st7735_display.sock'
+MAX_PAYLOAD = 1024 * 1024          # Largest request payload accepted (bytes)
+COMMAND_QUIET_SECONDS = 0.2        # Silence that ends a CMD: reply
+COMMAND_TIMEOUT = 3                # Longest wait for a CMD: reply (seconds)
+RECONNECT_DELAY = 2                # First pause before reopening a lost serial port (seconds)
+RECONNECT_MAX_DELAY = 30           # Longest pause between reconnect attempts (seconds)
+RECONNECT_ATTEMPTS = 5             # Attempts before the queued jobs are failed
+JOB_TIMEOUT = 60                   # Default wait for a request to be sent (seconds)
+CLIENT_TIMEOUT = 120               # Client wait for the daemon's reply (seconds)
+
+
+class Job:
+    """One queued request and, once finished, its reply"""
+    
+    def __init__(self, op, header, payload=b''):
+        self.op = op
+        self.header = header
+        self.payload = payload
+        self.group = header.get('group')
+        self.display = header.get('display')
+        self.target = f"GROUP:{self.group}" if self.group else self.display
+        self.reply = None
+        self.done = threading.Event()
+        
+    def finish(self, reply):
+        self.reply = reply
+        self.done.set()
+
+
+class DisplayDaemon:
+    """Serial link owner: queue, coalescing and the worker thread"""
+    
+    def __init__(self, serial_port='/dev/ttyACM0', baudrate=SERIAL_BAUDRATE, config_dir=None):
+        self.sender = BitmapSender(serial_port, baudrate)
+        self.config_dir = str(config_dir or Path(__file__).resolve().parent)
+        self.configs = {}
+        self.jobs = []
+        self.condition = threading.Condition()
+        self.running = False
+        self.worker = None
+        self.counters = {'sent': 0, 'superseded': 0, 'failed': 0, 'reconnects': 0}
+        
+    def start(self):
+        """Open the serial link and start the worker"""
+        if not self.sender.connect():
+            return False
+        self.running = True
+        self.worker = threading.Thread(target=self.run, name='display-worker', daemon=True)
+        self.worker.start()
+        return True
+        
+    def stop(self):
+        """Fail whatever is still queued, stop the worker and close the link"""
+        with self.condition:
+            self.running = False
+            pending, self.jobs = self.jobs, []
+            self.condition.notify_all()
+        for job in pending:
+            job.finish({'ok': False, 'status': 'failed', 'error': 'Daemon shutting down'})
+        if self.worker:
+            self.worker.join(timeout=CLIENT_TIMEOUT)
+        self.sender.disconnect()
+        
+    def connected(self):
+        return bool(self.sender.connection and self.sender.connection.is_open)
+    
+    # ---- Queue ----
+    
+    def submit(self, job):
+        """
+        Queue a job; a frame replaces the frame still pending for its target
+        
+        The replacement keeps the queue position of the frame it replaces, so a
+        producer sending faster than the link cannot starve the other displays.
+        """
+        superseded = None
+        with self.condition:
+            if not self.running:
+                return False
+            for i, queued in enumerate(self.jobs):
+                if job.op == 'frame' and queued.op == 'frame' and queued.target == job.target:
+                    superseded = queued
+                    self.jobs[i] = job
+                    self.counters['superseded'] += 1
+                    break
+            else:
+                self.jobs.append(job)
+            self.condition.notify()
+        if superseded:
+            superseded.finish({'ok': True, 'status': 'superseded'})
+        return True
+        
+    def pending(self):
+        with self.condition:
+            return len(self.jobs)
+            
+    def cancel(self, job):
+        """Drop a job that is still queued; False if the worker already took it"""
+        with self.condition:
+            if job not in self.jobs:
+                return False
+            self.jobs.remove(job)
+            return True
+            
+    def fail_pending(self, error):
+        """Answer every queued job with an error"""
+        with self.condition:
+            pending, self.jobs = self.jobs, []
+        for job in pending:
+            self.counters['failed'] += 1
+            job.finish({'ok': False, 'status': 'failed', 'error': error})
+            
+    def run(self):
+        """Worker: send queued jobs one at a time over the shared connection"""
+        while True:
+            with self.condition:
+                while self.running and not self.jobs:
+                    self.condition.wait()
+                if not self.running:
+                    return
+                job = self.jobs.pop(0)
+            try:
+                reply = self.execute(job)
+            except Exception as e:
+                reply = {'ok': False, 'status': 'failed', 'error': str(e)}
+            # Answer first: reconnecting can take a while
+            job.finish(reply)
+            if not reply['ok']:
+                self.counters['failed'] += 1
+                self.recover()
+            elif job.op == 'frame':
+                self.counters['sent'] += 1
+    
+    # ---- Serial side (worker thread only) ----
+    
+    def recover(self):
+        """After a failed job, put the firmware back in display selection"""
+        sender = self.sender
+        try:
+            if self.connected():
+                time.sleep(0.1)
+                sender.connection.reset_input_buffer()
+                if sender.reset_protocol():
+                    return
+        except Exception as e:
+            print(f"Error resetting protocol: {e}")
+        
+        # No reply: the Arduino was reset or unplugged
+        print("Serial link lost, reconnecting...")
+        self.counters['reconnects'] += 1
+        sender.disconnect()
+        delay = RECONNECT_DELAY
+        for attempt in range(RECONNECT_ATTEMPTS):
+            if not self.running or sender.connect():
+                return
+            if attempt + 1 < RECONNECT_ATTEMPTS:
+                time.sleep(delay)
+                delay = min(delay * 2, RECONNECT_MAX_DELAY)
+        
+        # Still down: answer the producers now instead of leaving them waiting;
+        # the next request starts another round of attempts
+        print(f"Error: Could not reopen {sender.serial_port} after {RECONNECT_ATTEMPTS} attempts")
+        self.fail_pending("Serial link lost")
+            
+    def select_target(self, job):
+        """Point the sender at the job's display or group"""
+        if not job.target:
+            raise ValueError("Request needs a display or group")
+        if job.display and job.display not in self.configs:
+            config = get_config_by_device_name(job.display, self.config_dir)
+            if not config:
+                raise ValueError(f"No configuration found for device '{job.display}'")
+            self.configs[job.display] = config
+        self.sender.display_config = self.configs.get(job.display)
+        self.sender.group = job.group
+        return self.sender.select_display()
+        
+    def execute(self, job):
+        if not self.connected():
+            return {'ok': False, 'status': 'failed', 'error': 'Not connected to Arduino'}
+        header = job.header
+        
+        if job.op == 'frame':
+            if not self.select_target(job):
+                return {'ok': False, 'status': 'failed', 'error': f"Could not select {job.target}"}
+            rotation = header.get('rotation')
+            ok = self.sender.send_frame(int(header['width']), int(header['height']), job.payload,
+                                        delta=bool(header.get('delta', False)),
+                                        compress=bool(header.get('compress', True)),
+                                        indexed=bool(header.get('indexed', False)),
+                                        snapshot=bool(header.get('snapshot', False)),
+                                        rotation=None if rotation is None else int(rotation))
+            reply = {'ok': ok, 'status': 'sent' if ok else 'failed'}
+            if ok:
+                reply['bytes'] = self.sender.last_bytes_sent
+            return reply
+        
+        if job.op == 'draw':
+            if not self.select_target(job):
+                return {'ok': False, 'status': 'failed', 'error': f"Could not select {job.target}"}
+            display_list = DisplayList()
+            offset = 0
+            for size in header['ops']:
+                display_list.ops.append(job.payload[offset:offset + size])
+                offset += size
+            ok = self.sender.send_draw(display_list)
+            return {'ok': ok, 'status': 'sent' if ok else 'failed'}
+        
+        if job.op == 'command':
+            if job.target and not self.select_target(job):
+                return {'ok': False, 'status': 'failed', 'error': f"Could not select {job.target}"}
+            command = str(header['command'])
+            lines = self.run_command(command)
+            if command.split(':')[0].upper() == 'RESET':
+                self.sender.selected_display = None
+            ok = bool(lines) and not lines[0].startswith('ERROR')
+            return {'ok': ok, 'status': 'sent' if ok else 'failed', 'lines': lines}
+        
+        return {'ok': False, 'status': 'failed', 'error': f"Unknown op '{job.op}'"}
+        
+    def run_command(self, command):
+        """Send CMD:<command> and collect its reply until the link goes quiet"""
+        connection = self.sender.connection
+        connection.write(f"CMD:{command}\n".encode('utf-8'))
+        connection.flush()
+        lines = []
+        deadline = time.time() + COMMAND_TIMEOUT
+        last = None
+        while time.time() < deadline:
+            if connection.in_waiting > 0:
+                line = connection.readline().decode('utf-8', errors='ignore').strip()
+                if line:
+                    lines.append(line)
+                last = time.time()
+            elif last is not None and time.time() - last > COMMAND_QUIET_SECONDS:
+                break
+            else:
+                time.sleep(0.01)
+        return lines
+    
+    # ---- Socket side (one thread per client connection) ----
+    
+    def handle_request(self, header, payload):
+        op = header.get('op')
+        if op == 'status':
+            with self.condition:
+                queued = [job.target for job in self.jobs]
+            reply = {'ok': True, 'status': 'idle' if not queued else 'busy', 'connected': self.connected(),
+                     'port': self.sender.serial_port, 'selected': self.sender.selected_display,
+                     'pending': len(queued), 'queued': queued}
+            reply.update(self.counters)
+            return reply
+        
+        if op not in ('frame', 'draw', 'command'):
+            return {'ok': False, 'status': 'failed', 'error': f"Unknown op '{op}'"}
+        if op == 'frame':
+            try:
+                width, height = int(header['width']), int(header['height'])
+            except (KeyError, TypeError, ValueError):
+                return {'ok': False, 'status': 'failed', 'error': 'frame needs width and height'}
+            if width <= 0 or height <= 0 or len(payload) != width * height * 2:
+                return {'ok': False, 'status': 'failed',
+                        'error': f"Expected {width}x{height} RGB565 pixels, got {len(payload)} bytes"}
+        if op == 'draw':
+            # Op sizes must cover the payload exactly, or ops would be cut mid-op
+            sizes = header.setdefault('ops', [len(payload)])
+            if (not isinstance(sizes, list) or not all(isinstance(size, int) and size > 0 for size in sizes)
+                    or sum(sizes) != len(payload)):
+                return {'ok': False, 'status': 'failed',
+                        'error': f"draw ops sizes {sizes} do not add up to the {len(payload)} byte payload"}
+        if op == 'command' and 'command' not in header:
+            return {'ok': False, 'status': 'failed', 'error': 'command needs a command'}
+        try:
+            timeout = float(header.get('timeout', JOB_TIMEOUT))
+        except (TypeError, ValueError):
+            return {'ok': False, 'status': 'failed', 'error': 'timeout must be a number of seconds'}
+        
+        job = Job(op, header, payload)
+        if not self.submit(job):
+            return {'ok': False, 'status': 'failed', 'error': 'Daemon shutting down'}
+        if op == 'frame' and not header.get('wait', True):
+            return {'ok': True, 'status': 'queued', 'pending': self.pending()}
+        if not job.done.wait(timeout) and self.cancel(job):
+            return {'ok': False, 'status': 'timeout', 'error': f"Not sent within {timeout:g} s"}
+        # Already being sent: its reply follows shortly
+        job.done.wait()
+        return job.reply
+
+
+class RequestHandler(socketserver.StreamRequestHandler):
+    """One client connection: JSON request lines, each with its payload"""
+    
+    def handle(self):
+        daemon = self.server.display_daemon
+        while True:
+            line = self.rfile.readline()
+            if not line:
+                return
+            if not line.strip():
+                continue
+            try:
+                header = json.loads(line.decode('utf-8'))
+                length = int(header.get('length', 0))
+                if not isinstance(header, dict) or length < 0 or length > MAX_PAYLOAD:
+                    raise ValueError(f"Bad request length {length}")
+            except (ValueError, AttributeError) as e:
+                self.reply({'ok': False, 'status': 'failed', 'error': f"Bad request: {e}"})
+                return
+            payload = self.rfile.read(length) if length else b''
+            if len(payload) != length:
+                return
+            self.reply(daemon.handle_request(header, payload))
+            
+    def reply(self, message):
+        self.wfile.write((json.dumps(message) + "\n").encode('utf-8'))
+        self.wfile.flush()
+
+
+class DaemonServer(socketserver.ThreadingMixIn, socketserver.UnixStreamServer):
+    daemon_threads = True
+
+
+class DaemonClient:
+    """Producer side of the daemon socket"""
+    
+    def __init__(self, socket_path=DEFAULT_SOCKET, timeout=CLIENT_TIMEOUT):
+        self.sock = socket.socket(socket.AF_UNIX, socket.SOCK_STREAM)
+        self.sock.settimeout(timeout)
+        self.sock.connect(socket_path)
+        self.reader = self.sock.makefile('rb')
+        
+    def close(self):
+        self.reader.close()
+        self.sock.close()
+        
+    def __enter__(self):
+        return self
+        
+    def __exit__(self, *exc):
+        self.close()
+        
+    def request(self, header, payload=b''):
+        """Send one request and return the daemon's reply (dict)"""
+        header = dict(header, length=len(payload))
+        self.sock.sendall((json.dumps(header) + "\n").encode('utf-8') + payload)
+        line = self.reader.readline()
+        if not line:
+            raise ConnectionError("Daemon closed the connection")
+        return json.loads(line.decode('utf-8'))
+        
+    @staticmethod
+    def _target(display, group):
+        return {'group': group} if group else {'display': display}
+        
+    def send_frame(self, display, width, height, pixel_bytes, group=None, wait=True, **options):
+        """
+        Queue a frame (big-endian RGB565, row-major)
+        
+        options: delta, compress, indexed, snapshot, rotation as in BitmapSender.send_frame.
+        The reply's status is "sent", "superseded" (a newer frame for the same
+        display replaced it), "queued" (wait=False) or "failed".
+        """
+        header = dict(op='frame', width=width, height=height, wait=wait, **options)
+        header.update(self._target(display, group))
+        return self.request(header, pixel_bytes)
+        
+    def send_draw(self, display, display_list, group=None):
+        header = dict(op='draw', ops=[len(op) for op in display_list.ops])
+        header.update(self._target(display, group))
+        return self.request(header, b''.join(display_list.ops))
+        
+    def command(self, command, display=None, group=None):
+        header = {'op': 'command', 'command': command}
+        if display or group:
+            header.update(self._target(display, group))
+        return self.request(header)
+        
+    def status(self):
+        return self.request({'op': 'status'})
+
+
+def main():
+    parser = argparse.ArgumentParser(
+        description="Own the Arduino serial link and queue frames from several producers",
+        formatter_class=argparse.RawDescriptionHelpFormatter,
+        epilog="""
+Examples:
+  python3 display_daemon.py                                   # /dev/ttyACM0, default socket
+  python3 display_daemon.py /dev/ttyACM1 --socket /run/st7735.sock
+  python3 display_daemon.py --status                          # Ask a running daemon
+        """
+    )
+    parser.add_argument('serial_port', nargs='?', default='/dev/ttyACM0',
+                        help='Serial port (default: /dev/ttyACM0 - Arduino Due Native USB port)')
+    parser.add_argument('--socket', '-s', default=DEFAULT_SOCKET,
+                        help=f'Unix socket to listen on (default: {DEFAULT_SOCKET})')
+    parser.add_argument('--config-dir', type=str,
+                        help='Directory with the *.config device files (default: next to this script)')
+    parser.add_argument('--status', action='store_true',
+                        help='Print the status of a running daemon and exit')
+    args = parser.parse_args()
+    
+    if args.status:
+        try:
+            with DaemonClient(args.socket, timeout=5) as client:
+                print(json.dumps(client.status(), indent=2))
+            return 0
+        except OSError as e:
+            print(f"Error: No daemon on {args.socket}: {e}")
+            return 1
+    
+    # A socket file nobody answers on is left over from a daemon that died
+    if os.path.exists(args.socket):
+        probe = socket.socket(socket.AF_UNIX, socket.SOCK_STREAM)
+        try:
+            probe.connect(args.socket)
+            print(f"Error: A daemon is already listening on {args.socket}")
+            return 1
+        except OSError:
+            os.unlink(args.socket)
+        finally:
+            probe.close()
+    
+    daemon = DisplayDaemon(args.serial_port, config_dir=args.config_dir)
+    if not daemon.start():
+        return 1
+    
+    server = DaemonServer(args.socket, RequestHandler)
+    server.display_daemon = daemon
+    print(f"Listening on {args.socket}")
+    
+    # SIGTERM (kill, systemd) shuts down like Ctrl+C
+    signal.signal(signal.SIGTERM, lambda signum, frame: sys.exit(0))
+    try:
+        server.serve_forever()
+    except KeyboardInterrupt:
+        print("\nShutting down")
+    finally:
+        server.server_close()
+        os.unlink(args.socket)
+        daemon.stop()
+    return 0
+
+
+if __name__ == '__main__':
+    sys.exit(main())
@@ -7,8 +7,39 @@ Converts TOML display configuration files to C++ header for Arduino Due firmware
 import toml
 from pathlib import Path
 from datetime import datetime
+import re
 import sys
 
+# Arduino Due pin number -> (PIO controller, bit), from the SAM3X variant pin map.
+# FastDisplay drives CS/DC through these registers instead of digitalWrite().
+DUE_PIO_PINS = {
+    0: ('A', 8), 1: ('A', 9), 2: ('B', 25), 3: ('C', 28), 4: ('C', 26), 5: ('C', 25),
+    6: ('C', 24), 7: ('C', 23), 8: ('C', 22), 9: ('C', 21), 10: ('C', 29), 11: ('D', 7),
+    12: ('D', 8), 13: ('B', 27), 14: ('D', 4), 15: ('D', 5), 16: ('A', 13), 17: ('A', 12),
+    18: ('A', 11), 19: ('A', 10), 20: ('B', 12), 21: ('B', 13), 22: ('B', 26), 23: ('A', 14),
+    24: ('A', 15), 25: ('D', 0), 26: ('D', 1), 27: ('D', 2), 28: ('D', 3), 29: ('D', 6),
+    30: ('D', 9), 31: ('A', 7), 32: ('D', 10), 33: ('C', 1), 34: ('C', 2), 35: ('C', 3),
+    36: ('C', 4), 37: ('C', 5), 38: ('C', 6), 39: ('C', 7), 40: ('C', 8), 41: ('C', 9),
+    42: ('A', 19), 43: ('A', 20), 44: ('C', 19), 45: ('C', 18), 46: ('C', 17), 47: ('C', 16),
+    48: ('C', 15), 49: ('C', 14), 50: ('C', 13), 51: ('C', 12), 52: ('B', 21), 53: ('B', 14),
+    54: ('A', 16), 55: ('A', 24), 56: ('A', 23), 57: ('A', 22), 58: ('A', 6), 59: ('A', 4),
+    60: ('A', 3), 61: ('A', 2), 62: ('B', 17), 63: ('B', 18), 64: ('B', 19), 65: ('B', 20),
+    66: ('B', 15), 67: ('B', 16), 68: ('A', 1), 69: ('A', 0), 70: ('A', 17), 71: ('A', 18),
+}
+
+
+def pio_pin(pin, label, device):
+    """(port index A=0..D=3, bit) of a Due pin; raises ValueError for unknown pins"""
+    if pin not in DUE_PIO_PINS:
+        raise ValueError(f"{device}: {label} pin {pin} is not an Arduino Due digital pin")
+    port, bit = DUE_PIO_PINS[pin]
+    return 'ABCD'.index(port), bit
+
+
+def traits_name(name):
+    """C++ identifier of a display's traits struct, e.g. DueLCD01Traits"""
+    return re.sub(r'\W', '_', name) + 'Traits'
+
 
 def parse_config(config_file):
     """Parse a single .config file"""
@@ -33,7 +64,9 @@ def parse_config(config_file):
         'right': cal['right'],
         'top': cal['top'],
         'bottom': cal['bottom'],
-        'center': cal['center']
+        'center': cal['center'],
+        'spi_clock': pinout.get('spi_clock', 0),
+        'groups': device.get('groups', [])
     }
 
 
@@ -59,6 +92,7 @@ def generate_header(configs):
         '',
         '#include <Arduino.h>',
         '#include "DisplayManager.h"',
+        '#include "FastDisplay.h"',
         '',
         '// Number of registered displays',
         f'#define NUM_DISPLAYS {len(configs)}',
@@ -71,6 +105,8 @@ def generate_header(configs):
         name_upper = cfg['name'].upper()
         usable_width = cfg['right'] - cfg['left'] + 1
         usable_height = cfg['bottom'] - cfg['top'] + 1
+        cs_port, cs_bit = pio_pin(cfg['pins']['cs'], 'CS', cfg['name'])
+        dc_port, dc_bit = pio_pin(cfg['pins']['dc'], 'DC', cfg['name'])
         
         lines.extend([
             f'// ========== {cfg["name"]} ==========',
@@ -87,6 +123,15 @@ def generate_header(configs):
             f'#define {name_upper}_TFT_RST {cfg["pins"]["rst"]}',
             f'#define {name_upper}_TFT_BL {cfg["pins"]["bl"]}',
             '',
+            '// PIO controller (A=0 .. D=3) and bit of CS / DC',
+            f'#define {name_upper}_TFT_CS_PORT {cs_port}',
+            f'#define {name_upper}_TFT_CS_BIT {cs_bit}',
+            f'#define {name_upper}_TFT_DC_PORT {dc_port}',
+            f'#define {name_upper}_TFT_DC_BIT {dc_bit}',
+            '',
+            '// Burst-write SPI clock (Hz)',
+            f'#define {name_upper}_SPI_CLOCK {cfg["spi_clock"] or "DISPLAY_SPI_CLOCK"}',
+            '',
             '// Display Dimensions',
             f'#define {name_upper}_DISPLAY_WIDTH {cfg["width"]}',
             f'#define {name_upper}_DISPLAY_HEIGHT {cfg["height"]}',
@@ -102,6 +147,17 @@ def generate_header(configs):
             f'#define {name_upper}_CENTER_X {cfg["center"][0]}',
             f'#define {name_upper}_CENTER_Y {cfg["center"][1]}',
             '',
+            '// Compile-time pins and bus clock for FastDisplay',
+            f'struct {traits_name(cfg["name"])} {{',
+            f'    static constexpr uint8_t CS_PIN = {name_upper}_TFT_CS;',
+            f'    static constexpr uint8_t DC_PIN = {name_upper}_TFT_DC;',
+            f'    static constexpr uint8_t CS_PORT = {name_upper}_TFT_CS_PORT;',
+            f'    static constexpr uint8_t CS_BIT = {name_upper}_TFT_CS_BIT;',
+            f'    static constexpr uint8_t DC_PORT = {name_upper}_TFT_DC_PORT;',
+            f'    static constexpr uint8_t DC_BIT = {name_upper}_TFT_DC_BIT;',
+            f'    static constexpr uint32_t SPI_CLOCK = {name_upper}_SPI_CLOCK;',
+            '};',
+            '',
         ])
     
     # Generate initialization function
@@ -133,18 +189,27 @@ def generate_header(configs):
             f'        cfg.usableHeight = {name_upper}_USABLE_HEIGHT;',
             f'        cfg.centerX = {name_upper}_CENTER_X;',
             f'        cfg.centerY = {name_upper}_CENTER_Y;',
-            '        manager.addDisplay(cfg);',
+            f'        manager.addDisplay(new FastDisplay<{traits_name(cfg["name"])}>(cfg));',
             '    }',
             ''
         ])
     
+    # Display groups ("ALL" is built in)
+    grouped = [cfg for cfg in configs if cfg['groups']]
+    if grouped:
+        lines.append('    // Display groups')
+        for cfg in grouped:
+            for group in cfg['groups']:
+                lines.append(f'    manager.addToGroup("{group}", {cfg["name"].upper()}_NAME);')
+        lines.append('')
+    
     lines.extend([
         '}',
         '',
         '#endif // DISPLAY_CONFIG_H'
     ])
     
-    return '\n'.join(lines)
+    return '\n'.join(lines) + '\n'
 
 
 def main():
@@ -172,7 +237,11 @@ def main():
             sys.exit(1)
     
     # Generate header
-    header_content = generate_header(configs)
+    try:
+        header_content = generate_header(configs)
+    except ValueError as e:
+        print(f"✗ {e}")
+        sys.exit(1)
     
     # Write to include/DisplayConfig.h
     output_file = Path('include/DisplayConfig.h')
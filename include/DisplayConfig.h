@@ -1,7 +1,7 @@
 /*
  * DisplayConfig.h - Multi-Display Configuration
  * Auto-generated from all .config files
- * Generated: 2025-11-06 03:23:47
+ * Generated: 2026-10-14 16:21:24
  * 
  * DO NOT EDIT THIS FILE MANUALLY!
  * Edit the .config files and regenerate using generate_config_header.py
@@ -14,6 +14,7 @@
 
 #include <Arduino.h>
 #include "DisplayManager.h"
+#include "FastDisplay.h"
 
 // Number of registered displays
 #define NUM_DISPLAYS 2
@@ -33,6 +34,15 @@
 #define DUELCD01_TFT_RST 8
 #define DUELCD01_TFT_BL 9
 
+// PIO controller (A=0 .. D=3) and bit of CS / DC
+#define DUELCD01_TFT_CS_PORT 2
+#define DUELCD01_TFT_CS_BIT 23
+#define DUELCD01_TFT_DC_PORT 2
+#define DUELCD01_TFT_DC_BIT 29
+
+// Burst-write SPI clock (Hz)
+#define DUELCD01_SPI_CLOCK DISPLAY_SPI_CLOCK
+
 // Display Dimensions
 #define DUELCD01_DISPLAY_WIDTH 160
 #define DUELCD01_DISPLAY_HEIGHT 128
@@ -48,6 +58,17 @@
 #define DUELCD01_CENTER_X 80
 #define DUELCD01_CENTER_Y 65
 
+// Compile-time pins and bus clock for FastDisplay
+struct DueLCD01Traits {
+    static constexpr uint8_t CS_PIN = DUELCD01_TFT_CS;
+    static constexpr uint8_t DC_PIN = DUELCD01_TFT_DC;
+    static constexpr uint8_t CS_PORT = DUELCD01_TFT_CS_PORT;
+    static constexpr uint8_t CS_BIT = DUELCD01_TFT_CS_BIT;
+    static constexpr uint8_t DC_PORT = DUELCD01_TFT_DC_PORT;
+    static constexpr uint8_t DC_BIT = DUELCD01_TFT_DC_BIT;
+    static constexpr uint32_t SPI_CLOCK = DUELCD01_SPI_CLOCK;
+};
+
 // ========== DueLCD02 ==========
 #define DUELCD02_INDEX 1
 
@@ -62,6 +83,15 @@
 #define DUELCD02_TFT_RST 33
 #define DUELCD02_TFT_BL 35
 
+// PIO controller (A=0 .. D=3) and bit of CS / DC
+#define DUELCD02_TFT_CS_PORT 3
+#define DUELCD02_TFT_CS_BIT 6
+#define DUELCD02_TFT_DC_PORT 0
+#define DUELCD02_TFT_DC_BIT 7
+
+// Burst-write SPI clock (Hz)
+#define DUELCD02_SPI_CLOCK DISPLAY_SPI_CLOCK
+
 // Display Dimensions
 #define DUELCD02_DISPLAY_WIDTH 128
 #define DUELCD02_DISPLAY_HEIGHT 160
@@ -77,6 +107,17 @@
 #define DUELCD02_CENTER_X 65
 #define DUELCD02_CENTER_Y 80
 
+// Compile-time pins and bus clock for FastDisplay
+struct DueLCD02Traits {
+    static constexpr uint8_t CS_PIN = DUELCD02_TFT_CS;
+    static constexpr uint8_t DC_PIN = DUELCD02_TFT_DC;
+    static constexpr uint8_t CS_PORT = DUELCD02_TFT_CS_PORT;
+    static constexpr uint8_t CS_BIT = DUELCD02_TFT_CS_BIT;
+    static constexpr uint8_t DC_PORT = DUELCD02_TFT_DC_PORT;
+    static constexpr uint8_t DC_BIT = DUELCD02_TFT_DC_BIT;
+    static constexpr uint32_t SPI_CLOCK = DUELCD02_SPI_CLOCK;
+};
+
 // Display Registry Initialization
 inline void initializeDisplayRegistry(DisplayManager& manager) {
 
@@ -99,7 +140,7 @@ inline void initializeDisplayRegistry(DisplayManager& manager) {
         cfg.usableHeight = DUELCD01_USABLE_HEIGHT;
         cfg.centerX = DUELCD01_CENTER_X;
         cfg.centerY = DUELCD01_CENTER_Y;
-        manager.addDisplay(cfg);
+        manager.addDisplay(new FastDisplay<DueLCD01Traits>(cfg));
     }
 
     // Add DueLCD02
@@ -121,7 +162,7 @@ inline void initializeDisplayRegistry(DisplayManager& manager) {
         cfg.usableHeight = DUELCD02_USABLE_HEIGHT;
         cfg.centerX = DUELCD02_CENTER_X;
         cfg.centerY = DUELCD02_CENTER_Y;
-        manager.addDisplay(cfg);
+        manager.addDisplay(new FastDisplay<DueLCD02Traits>(cfg));
     }
 
 }
@@ -4,21 +4,28 @@
  */
 
 #include "DisplayManager.h"
+#include "PerfStats.h"
 
 // DisplayInstance implementation
+DisplayInstance* DisplayInstance::pendingTransfer = nullptr;
+
 DisplayInstance::DisplayInstance(const DisplayConfig& cfg) 
-    : config(cfg), tft(nullptr), initialized(false),
+    : config(cfg), tft(nullptr), bus(nullptr), initialized(false),
       imageFrameEnabled(false), imageFrameColor(ST77XX_WHITE), 
-      imageFrameThickness(1), frameBuffer(nullptr), frameBufferAllocated(false) {
+      imageFrameThickness(1), shadow(nullptr), frameDepth(0),
+      ownRotation(NO_SOURCE_ROTATION) {
 }
 
 DisplayInstance::~DisplayInstance() {
+    if (pendingTransfer == this) {
+        waitForTransfer();
+    }
+    delete shadow;
+    delete bus;
     if (tft) {
+        DisplaySnapshot::discardAll(tft);
         delete tft;
     }
-    if (frameBuffer) {
-        delete[] frameBuffer;
-    }
 }
 
 bool DisplayInstance::initialize() {
@@ -46,17 +53,33 @@ bool DisplayInstance::initialize() {
     tft->initR(INITR_BLACKTAB);
     tft->setRotation(config.rotation);
     
+    // Row transfers use DMA when the platform supports it
+    SpiDma::begin();
+    
+    // A bus backend that cannot drive this panel falls back to the Adafruit path
+    if (bus && !bus->begin()) {
+        delete bus;
+        bus = nullptr;
+    }
+    
     initialized = true;
     return true;
 }
 
+void DisplayInstance::setBus(PanelBus* backend) {
+    waitForTransfer();
+    delete bus;
+    bus = backend;
+}
+
 void DisplayInstance::showTestPattern() {
     if (!tft || !initialized) {
         return;
     }
     
     // Clear screen
-    tft->fillScreen(ST77XX_BLACK);
+    Adafruit_GFX* gfx = beginFrame();
+    gfx->fillScreen(ST77XX_BLACK);
     
     // Draw gradient FIRST (background)
     drawColorBars();
@@ -66,11 +89,13 @@ void DisplayInstance::showTestPattern() {
     
     // Draw device info LAST (on top of everything)
     drawDeviceInfo();
+    endFrame();
 }
 
 void DisplayInstance::clear() {
     if (tft && initialized) {
-        tft->fillScreen(ST77XX_BLACK);
+        beginFrame()->fillScreen(ST77XX_BLACK);
+        endFrame();
     }
 }
 
@@ -81,8 +106,10 @@ void DisplayInstance::setBacklight(bool on) {
 void DisplayInstance::drawCalibrationFrame(int8_t adjustTop, int8_t adjustBottom,
                                           int8_t adjustLeft, int8_t adjustRight,
                                           uint16_t frameColor, uint8_t frameThickness) {
+    Adafruit_GFX* gfx = beginFrame();
+    
     // Clear screen first to remove old frame
-    tft->fillScreen(ST77XX_BLACK);
+    gfx->fillScreen(ST77XX_BLACK);
     
     // Draw frame with specified color, thickness, and adjustments
     drawImageFrame(frameColor, frameThickness, 
@@ -91,22 +118,25 @@ void DisplayInstance::drawCalibrationFrame(int8_t adjustTop, int8_t adjustBottom
     // Draw diagonal from origin to display center (identifies origin)
     int displayCenterX = config.width / 2;
     int displayCenterY = config.height / 2;
-    tft->drawLine(0, 0, displayCenterX, displayCenterY, ST77XX_YELLOW);
+    gfx->drawLine(0, 0, displayCenterX, displayCenterY, ST77XX_YELLOW);
     
     // Mark origin
-    tft->drawPixel(0, 0, ST77XX_WHITE);
-    tft->drawPixel(1, 0, ST77XX_WHITE);
-    tft->drawPixel(0, 1, ST77XX_WHITE);
+    gfx->drawPixel(0, 0, ST77XX_WHITE);
+    gfx->drawPixel(1, 0, ST77XX_WHITE);
+    gfx->drawPixel(0, 1, ST77XX_WHITE);
     
     // Mark calibrated center with red cross
-    tft->drawPixel(config.centerX, config.centerY, ST77XX_RED);
-    tft->drawPixel(config.centerX-1, config.centerY, ST77XX_RED);
-    tft->drawPixel(config.centerX+1, config.centerY, ST77XX_RED);
-    tft->drawPixel(config.centerX, config.centerY-1, ST77XX_RED);
-    tft->drawPixel(config.centerX, config.centerY+1, ST77XX_RED);
+    gfx->drawPixel(config.centerX, config.centerY, ST77XX_RED);
+    gfx->drawPixel(config.centerX-1, config.centerY, ST77XX_RED);
+    gfx->drawPixel(config.centerX+1, config.centerY, ST77XX_RED);
+    gfx->drawPixel(config.centerX, config.centerY-1, ST77XX_RED);
+    gfx->drawPixel(config.centerX, config.centerY+1, ST77XX_RED);
+    endFrame();
 }
 
 void DisplayInstance::drawColorBars() {
+    Adafruit_GFX* gfx = beginFrame();
+    
     // Draw gradient background across entire usable area
     // Horizontal gradient: blue -> cyan -> green -> yellow -> red
     
@@ -128,26 +158,35 @@ void DisplayInstance::drawColorBars() {
         const uint16_t color = ((r & 0xF8) << 8) | ((g & 0xFC) << 3) | (b >> 3);
         
         // Draw vertical line for this color
-        tft->drawFastVLine(x, config.usableY, config.usableHeight, color);
+        gfx->drawFastVLine(x, config.usableY, config.usableHeight, color);
     }
+    endFrame();
 }
 
 void DisplayInstance::drawDeviceInfo() {
-    tft->setTextColor(ST77XX_BLACK);
-    tft->setTextSize(2);  // Doubled from 1 to 2
-    tft->setTextWrap(false);
+    Adafruit_GFX* gfx = beginFrame();
+    
+    gfx->setTextColor(ST77XX_BLACK);
+    gfx->setTextSize(2);  // Doubled from 1 to 2
+    gfx->setTextWrap(false);
     
     // Position text in upper area
     int textY = config.usableY + 5;
     int textX = config.usableX + 5;
     
-    tft->setCursor(textX, textY);
-    tft->print(config.name);
+    gfx->setCursor(textX, textY);
+    gfx->print(config.name);
     
-    tft->setCursor(textX, textY + 20);  // Increased spacing from 10 to 20 for larger text
-    tft->print(config.width);
-    tft->print("x");
-    tft->print(config.height);
+    gfx->setCursor(textX, textY + 20);  // Increased spacing from 10 to 20 for larger text
+    gfx->print(config.width);
+    gfx->print("x");
+    gfx->print(config.height);
+    endFrame();
+}
+
+void DisplayInstance::centerInUsableArea(int width, int height, int& offsetX, int& offsetY) const {
+    offsetX = config.usableX + config.usableWidth / 2 - width / 2;
+    offsetY = config.usableY + config.usableHeight / 2 - height / 2;
 }
 
 bool DisplayInstance::isWithinBounds(int x, int y) const {
@@ -158,24 +197,473 @@ bool DisplayInstance::isWithinBounds(int x, int y) const {
 bool DisplayInstance::isWithinFrameBounds(int x, int y,
                                          int8_t adjustTop, int8_t adjustBottom,
                                          int8_t adjustLeft, int8_t adjustRight) const {
-    // Calculate frame boundaries with adjustments
-    // Remember: top and left use inverted calculations
-    int16_t frameTop = config.usableY - adjustTop;
-    int16_t frameLeft = config.usableX - adjustLeft;
-    int16_t frameBottom = (config.usableY + config.usableHeight - 1) + adjustBottom;
-    int16_t frameRight = (config.usableX + config.usableWidth - 1) + adjustRight;
+    int16_t frameLeft, frameTop, frameRight, frameBottom;
+    getFrameBounds(frameLeft, frameTop, frameRight, frameBottom,
+                   adjustTop, adjustBottom, adjustLeft, adjustRight);
     
     // Check if pixel is within the frame boundaries
     return (x >= frameLeft && x <= frameRight &&
             y >= frameTop && y <= frameBottom);
 }
 
+void DisplayInstance::getFrameBounds(int16_t& left, int16_t& top, int16_t& right, int16_t& bottom,
+                                    int8_t adjustTop, int8_t adjustBottom,
+                                    int8_t adjustLeft, int8_t adjustRight) const {
+    // Calculate frame boundaries with adjustments
+    // Remember: top and left use inverted calculations
+    top = config.usableY - adjustTop;
+    left = config.usableX - adjustLeft;
+    bottom = (config.usableY + config.usableHeight - 1) + adjustBottom;
+    right = (config.usableX + config.usableWidth - 1) + adjustRight;
+}
+
+bool DisplayInstance::clipSpan(int16_t& x, int16_t y, const uint16_t*& pixels, uint16_t& count) const {
+    if (!tft || !initialized || count == 0) {
+        return false;
+    }
+    
+    // Clip the span to the panel (frame bounds may extend beyond it)
+    if (y < 0 || y >= tft->height()) {
+        return false;
+    }
+    if (x < 0) {
+        if (-x >= count) return false;
+        pixels += -x;
+        count += x;
+        x = 0;
+    }
+    if (x + count > tft->width()) {
+        if (x >= tft->width()) return false;
+        count = tft->width() - x;
+    }
+    return true;
+}
+
+void DisplayInstance::writeRow(int16_t x, int16_t y, const uint16_t* pixels, uint16_t count) {
+    if (!clipSpan(x, y, pixels, count)) {
+        return;
+    }
+    waitForTransfer();
+    if (shadow) {
+        shadow->writeSpan(x, y, pixels, count, frameDepth > 0);
+        if (frameDepth > 0) {
+            return;
+        }
+    }
+    
+    // One transaction: single address window, then stream the whole span
+    PerfStats::ScopedCycles spi(PerfStats::counters.spiCycles);
+    PerfStats::countSpiWrite();
+    openWindow(x, y, count, 1);
+    writeWindowPixels(pixels, count);
+    closeWindow();
+}
+
+void DisplayInstance::writeRowAsync(int16_t x, int16_t y, const uint16_t* pixels, uint16_t count) {
+    if (!SpiDma::isAvailable() || frameDepth > 0) {
+        writeRow(x, y, pixels, count);
+        return;
+    }
+    if (!clipSpan(x, y, pixels, count)) {
+        return;
+    }
+    waitForTransfer();
+    if (shadow) {
+        shadow->writeSpan(x, y, pixels, count, false);
+    }
+    
+    // CS stays asserted and DC is left in data mode after the address window, so the
+    // DMA engine only has to clock out the (big-endian) pixel bytes
+    PerfStats::ScopedCycles spi(PerfStats::counters.spiCycles);
+    PerfStats::countSpiWrite();
+    openWindow(x, y, count, 1);
+    SpiDma::start((const uint8_t*)pixels, count * 2);
+    pendingTransfer = this;
+}
+
+void DisplayInstance::writeRect(int16_t x, int16_t y, int16_t width, int16_t height,
+                                const uint16_t* pixels, uint16_t stride) {
+    if (!tft || !initialized || width <= 0 || height <= 0) {
+        return;
+    }
+    
+    if (shadow) {
+        waitForTransfer();
+        for (int16_t row = 0; row < height; row++) {
+            shadow->writeSpan(x, y + row, pixels + (uint32_t)row * stride, width, frameDepth > 0);
+        }
+        if (frameDepth > 0) {
+            return;
+        }
+    }
+    pushRect(x, y, width, height, pixels, stride);
+}
+
+void DisplayInstance::pushRect(int16_t x, int16_t y, int16_t width, int16_t height,
+                               const uint16_t* pixels, uint16_t stride) {
+    // Clip the block to the panel once
+    if (x < 0) {
+        if (-x >= width) return;
+        pixels += -x;
+        width += x;
+        x = 0;
+    }
+    if (y < 0) {
+        if (-y >= height) return;
+        pixels += (uint32_t)(-y) * stride;
+        height += y;
+        y = 0;
+    }
+    if (x + width > tft->width()) {
+        if (x >= tft->width()) return;
+        width = tft->width() - x;
+    }
+    if (y + height > tft->height()) {
+        if (y >= tft->height()) return;
+        height = tft->height() - y;
+    }
+    waitForTransfer();
+    
+    // The panel advances through the window by itself, so rows follow back to back
+    PerfStats::ScopedCycles spi(PerfStats::counters.spiCycles);
+    PerfStats::countSpiWrite();
+    openWindow(x, y, width, height);
+    
+    if (SpiDma::isAvailable()) {
+        // start() waits for the previous row, keeping CS asserted in between
+        for (int16_t row = 0; row < height; row++) {
+            SpiDma::start((const uint8_t*)(pixels + (uint32_t)row * stride), width * 2);
+        }
+        pendingTransfer = this;
+        return;
+    }
+    
+    if (stride == width) {
+        writeWindowPixels(pixels, (uint32_t)width * height);
+    } else {
+        for (int16_t row = 0; row < height; row++) {
+            writeWindowPixels(pixels + (uint32_t)row * stride, width);
+        }
+    }
+    closeWindow();
+}
+
+void DisplayInstance::openWindow(int16_t x, int16_t y, int16_t width, int16_t height) {
+    if (bus) {
+        bus->openWindow(x, y, width, height);
+        return;
+    }
+    tft->startWrite();
+    tft->setAddrWindow(x, y, width, height);
+}
+
+void DisplayInstance::writeWindowPixels(const uint16_t* pixels, uint32_t count) {
+    if (bus) {
+        bus->writePixels(pixels, count);
+    } else {
+        tft->writePixels(const_cast<uint16_t*>(pixels), count, true, true);
+    }
+}
+
+void DisplayInstance::closeWindow() {
+    if (bus) {
+        bus->closeWindow();
+    } else {
+        tft->endWrite();
+    }
+}
+
+bool DisplayInstance::restoreSnapshot(uint8_t region) {
+    const SnapshotHeader* header = DisplaySnapshot::getSnapshotHeader(tft, region);
+    if (!header) {
+        return false;
+    }
+    return restoreSnapshot(header->offsetX, header->offsetY, header->width, header->height, region);
+}
+
+bool DisplayInstance::restoreSnapshot(int16_t x, int16_t y, int16_t width, int16_t height, uint8_t region) {
+    if (!tft || !DisplaySnapshot::hasSnapshot(tft, region)) {
+        return false;
+    }
+    
+    const uint16_t* pixels;
+    uint16_t stride;
+    if (DisplaySnapshot::clipToSnapshot(tft, region, x, y, width, height, pixels, stride)) {
+        writeRect(x, y, width, height, pixels, stride);
+        // Pool slots can move on the next capture; do not leave DMA reading one
+        waitForTransfer();
+    }
+    return true;
+}
+
+bool DisplayInstance::beginSnapshot(int16_t x, int16_t y, uint16_t width, uint16_t height, uint8_t region) {
+    if (!tft) {
+        return false;
+    }
+    return DisplaySnapshot::allocate(tft, region, width, height, x, y) != nullptr;
+}
+
+void DisplayInstance::recordSpan(int16_t x, int16_t y, const uint16_t* pixels, uint16_t count, uint8_t region) {
+    DisplaySnapshot::writeSpan(tft, region, x, y, pixels, count);
+}
+
+void DisplayInstance::recordFill(int16_t x, int16_t y, int16_t width, int16_t height, uint16_t color, uint8_t region) {
+    // The pool keeps display byte order
+    DisplaySnapshot::fillRect(tft, region, x, y, width, height, (uint16_t)((color >> 8) | (color << 8)));
+}
+
+void DisplayInstance::discardSnapshot(uint8_t region) {
+    DisplaySnapshot::discardSnapshot(tft, region);
+}
+
+bool DisplayInstance::enableShadow(bool enable) {
+    if (!tft || !initialized) {
+        return false;
+    }
+    if (enable == (shadow != nullptr)) {
+        return true;
+    }
+    waitForTransfer();
+    
+    delete shadow;
+    shadow = nullptr;
+    frameDepth = 0;
+    if (!enable) {
+        return true;
+    }
+    
+    shadow = new ShadowBuffer(tft->width(), tft->height());
+    if (!shadow || !shadow->isValid()) {
+        delete shadow;
+        shadow = nullptr;
+        return false;
+    }
+    
+    // The panel cannot be read back, so both start out black
+    clear();
+    return true;
+}
+
+Adafruit_GFX* DisplayInstance::beginFrame() {
+    waitForTransfer();
+    if (!shadow) {
+        return tft;
+    }
+    frameDepth++;
+    return shadow;
+}
+
+void DisplayInstance::endFrame() {
+    if (!shadow || frameDepth == 0) {
+        return;
+    }
+    if (--frameDepth == 0 && shadow->isDirty()) {
+        flushShadow();
+    }
+}
+
+void DisplayInstance::flushShadow() {
+    // Rows with the same dirty tiles are sent together: one address window per run
+    // of adjacent dirty tiles covers all of them
+    const int16_t width = shadow->width();
+    const int16_t height = shadow->height();
+    
+    for (int16_t y = 0; y < height; ) {
+        uint32_t mask = shadow->getDirtyMask(y);
+        int16_t rows = 1;
+        while (y + rows < height && shadow->getDirtyMask(y + rows) == mask) {
+            rows++;
+        }
+        
+        uint8_t tile = 0;
+        while (tile < 32 && (mask >> tile) != 0) {
+            if (!(mask & (1UL << tile))) {
+                tile++;
+                continue;
+            }
+            uint8_t last = tile;
+            while (last < 31 && (mask & (1UL << (last + 1)))) {
+                last++;
+            }
+            
+            int16_t x = tile * ShadowBuffer::TILE_WIDTH;
+            int16_t end = (last + 1) * ShadowBuffer::TILE_WIDTH;
+            if (end > width) {
+                end = width;
+            }
+            pushRect(x, y, end - x, rows, shadow->getPixels(x, y), shadow->getStride());
+            tile = last + 1;
+        }
+        y += rows;
+    }
+    shadow->markClean();
+}
+
+bool DisplayInstance::setRotation(uint8_t rotation) {
+    if (!tft) {
+        return false;
+    }
+    endSourceRotation();
+    waitForTransfer();
+    rotation &= 3;
+    const uint8_t from = config.rotation;
+    
+    // The image keeps its size and is centered where its area went, so CMD:REPAINT
+    // shows it upright; the pixels saved under a frame border no longer line up
+    const SnapshotHeader* header = DisplaySnapshot::getSnapshotHeader(tft);
+    if (header) {
+        int16_t sx = header->offsetX;
+        int16_t sy = header->offsetY;
+        int16_t sw = header->width;
+        int16_t sh = header->height;
+        mapRect(from, rotation, sx, sy, sw, sh);
+        DisplaySnapshot::moveSnapshot(tft, DisplaySnapshot::REGION_IMAGE,
+                                      sx + (sw - (int16_t)header->width) / 2,
+                                      sy + (sh - (int16_t)header->height) / 2);
+    }
+    for (uint8_t region = DisplaySnapshot::REGION_FRAME_TOP; region <= DisplaySnapshot::REGION_FRAME_RIGHT; region++) {
+        DisplaySnapshot::discardSnapshot(tft, region);
+    }
+    
+    mapGeometry(rotation);
+    tft->setRotation(rotation);
+    
+    // The shadow follows the panel's new width and height
+    if (shadow) {
+        enableShadow(false);
+        return enableShadow(true);
+    }
+    return true;
+}
+
+bool DisplayInstance::beginSourceRotation(uint8_t rotation) {
+    if (!tft || !initialized) {
+        return false;
+    }
+    rotation &= 3;
+    const uint8_t current = isSourceRotated() ? ownRotation : config.rotation;
+    endSourceRotation();
+    if (rotation == current) {
+        return true;
+    }
+    if (shadow) {
+        return false;
+    }
+    waitForTransfer();
+    ownRotation = current;
+    mapGeometry(rotation);
+    tft->setRotation(rotation);
+    return true;
+}
+
+void DisplayInstance::endSourceRotation() {
+    if (!isSourceRotated()) {
+        return;
+    }
+    waitForTransfer();
+    mapGeometry(ownRotation);
+    tft->setRotation(ownRotation);
+    ownRotation = NO_SOURCE_ROTATION;
+}
+
+void DisplayInstance::mapGeometry(uint8_t rotation) {
+    // Size, usable area and center of the same panel pixels, seen in rotation
+    const uint8_t from = config.rotation;
+    int16_t x = config.usableX;
+    int16_t y = config.usableY;
+    int16_t w = config.usableWidth;
+    int16_t h = config.usableHeight;
+    mapRect(from, rotation, x, y, w, h);
+    int16_t centerX = config.centerX;
+    int16_t centerY = config.centerY;
+    int16_t pointWidth = 1;
+    int16_t pointHeight = 1;
+    mapRect(from, rotation, centerX, centerY, pointWidth, pointHeight);
+    
+    if ((from ^ rotation) & 1) {
+        uint16_t width = config.width;
+        config.width = config.height;
+        config.height = width;
+    }
+    config.rotation = rotation;
+    config.usableX = x;
+    config.usableY = y;
+    config.usableWidth = w;
+    config.usableHeight = h;
+    config.centerX = centerX;
+    config.centerY = centerY;
+}
+
+void DisplayInstance::mapRect(uint8_t from, uint8_t to, int16_t& x, int16_t& y,
+                              int16_t& width, int16_t& height) const {
+    // Through rotation 0 (the panel's own axes), with Adafruit_GFX's rotation convention
+    const int16_t panelWidth = (config.rotation & 1) ? config.height : config.width;
+    const int16_t panelHeight = (config.rotation & 1) ? config.width : config.height;
+    int16_t px = x;
+    int16_t py = y;
+    int16_t pw = width;
+    int16_t ph = height;
+    switch (from & 3) {
+        case 1:
+            px = panelWidth - (y + height);
+            py = x;
+            pw = height;
+            ph = width;
+            break;
+        case 2:
+            px = panelWidth - (x + width);
+            py = panelHeight - (y + height);
+            break;
+        case 3:
+            px = y;
+            py = panelHeight - (x + width);
+            pw = height;
+            ph = width;
+            break;
+    }
+    
+    x = px;
+    y = py;
+    width = pw;
+    height = ph;
+    switch (to & 3) {
+        case 1:
+            x = py;
+            y = panelWidth - (px + pw);
+            width = ph;
+            height = pw;
+            break;
+        case 2:
+            x = panelWidth - (px + pw);
+            y = panelHeight - (py + ph);
+            break;
+        case 3:
+            x = panelHeight - (py + ph);
+            y = px;
+            width = ph;
+            height = pw;
+            break;
+    }
+}
+
+void DisplayInstance::waitForTransfer() {
+    if (!pendingTransfer) {
+        return;
+    }
+    
+    PerfStats::ScopedCycles spi(PerfStats::counters.spiCycles);
+    SpiDma::wait();
+    pendingTransfer->closeWindow();
+    pendingTransfer = nullptr;
+}
+
 void DisplayInstance::drawImageFrame(uint16_t color, uint8_t thickness,
                                     int8_t adjustTop, int8_t adjustBottom,
                                     int8_t adjustLeft, int8_t adjustRight) {
     if (!tft || !initialized) {
         return;
     }
+    waitForTransfer();
     
     // Apply adjustments to usable area boundaries (relative to config values)
     // Adjustments move edges: positive = outward (expand), negative = inward (shrink)
@@ -197,6 +685,10 @@ void DisplayInstance::drawImageFrame(uint16_t color, uint8_t thickness,
     if (y < -10) y = -10;
     if (w <= 0 || h <= 0) return;  // Nothing to draw
     
+    // Keep what the frame covers so clearImageFrame() can put it back
+    saveFrameArea(x, y, w, h, thickness);
+    Adafruit_GFX* gfx = beginFrame();
+    
     // Draw frame with specified thickness
     // Draw inward from the boundary (like cal_lcd.cpp reference implementation)
     for (uint8_t i = 0; i < thickness; i++) {
@@ -210,14 +702,22 @@ void DisplayInstance::drawImageFrame(uint16_t color, uint8_t thickness,
         if (fw <= 0 || fh <= 0) break;
         
         // Draw rectangle (allow slightly beyond display bounds for calibration)
-        tft->drawRect(fx, fy, fw, fh, color);
+        gfx->drawRect(fx, fy, fw, fh, color);
     }
+    endFrame();
 }
 
 void DisplayInstance::clearImageFrame() {
     if (!tft || !initialized) {
         return;
     }
+    Adafruit_GFX* gfx = beginFrame();
+    
+    // Put back the pixels saved under the frame, if the image they came from is known
+    if (restoreFrameArea()) {
+        endFrame();
+        return;
+    }
     
     // Clear frame by drawing in black
     int16_t x = config.usableX;
@@ -226,8 +726,70 @@ void DisplayInstance::clearImageFrame() {
     int16_t h = config.usableHeight;
     
     for (uint8_t i = 0; i < imageFrameThickness; i++) {
-        tft->drawRect(x - i, y - i, w + 2*i, h + 2*i, ST77XX_BLACK);
+        gfx->drawRect(x - i, y - i, w + 2*i, h + 2*i, ST77XX_BLACK);
+    }
+    endFrame();
+}
+
+void DisplayInstance::saveFrameArea(int16_t x, int16_t y, int16_t w, int16_t h, uint8_t thickness) {
+    // One pool slot per border side, read from the shadow framebuffer or cut out of
+    // this display's image snapshot. Without either the content under the frame is
+    // unknown and nothing is saved.
+    if (!shadow && !DisplaySnapshot::hasSnapshot(tft, DisplaySnapshot::REGION_IMAGE)) {
+        for (uint8_t region = DisplaySnapshot::REGION_FRAME_TOP; region <= DisplaySnapshot::REGION_FRAME_RIGHT; region++) {
+            DisplaySnapshot::discardSnapshot(tft, region);
+        }
+        return;
+    }
+    
+    int16_t t = thickness;
+    if (2 * t > w) t = (w + 1) / 2;
+    if (2 * t > h) t = (h + 1) / 2;
+    int16_t sideHeight = h - 2 * t;
+    
+    using namespace DisplaySnapshot;
+    captureArea(REGION_FRAME_TOP, x, y, w, t);
+    captureArea(REGION_FRAME_BOTTOM, x, y + h - t, w, t);
+    if (sideHeight > 0) {
+        captureArea(REGION_FRAME_LEFT, x, y + t, t, sideHeight);
+        captureArea(REGION_FRAME_RIGHT, x + w - t, y + t, t, sideHeight);
+    } else {
+        DisplaySnapshot::discardSnapshot(tft, REGION_FRAME_LEFT);
+        DisplaySnapshot::discardSnapshot(tft, REGION_FRAME_RIGHT);
+    }
+}
+
+bool DisplayInstance::captureArea(uint8_t region, int16_t x, int16_t y, int16_t width, int16_t height) {
+    if (!shadow) {
+        // Pixels the image snapshot does not cover were left black by the transfer
+        return DisplaySnapshot::captureFromSnapshot(tft, region, DisplaySnapshot::REGION_IMAGE,
+                                                    x, y, width, height);
+    }
+    
+    uint16_t* dest = DisplaySnapshot::allocate(tft, region, width, height, x, y);
+    if (!dest) {
+        return false;
     }
+    for (int16_t r = 0; r < height; r++) {
+        for (int16_t c = 0; c < width; c++) {
+            int16_t sx = x + c;
+            int16_t sy = y + r;
+            bool onPanel = sx >= 0 && sx < shadow->width() && sy >= 0 && sy < shadow->height();
+            *dest++ = onPanel ? *shadow->getPixels(sx, sy) : 0;
+        }
+    }
+    return true;
+}
+
+bool DisplayInstance::restoreFrameArea() {
+    bool restored = false;
+    for (uint8_t region = DisplaySnapshot::REGION_FRAME_TOP; region <= DisplaySnapshot::REGION_FRAME_RIGHT; region++) {
+        if (restoreSnapshot(region)) {
+            DisplaySnapshot::discardSnapshot(tft, region);
+            restored = true;
+        }
+    }
+    return restored;
 }
 
 void DisplayInstance::enableImageFrame(bool enable, uint16_t color, uint8_t thickness,
@@ -247,7 +809,7 @@ void DisplayInstance::enableImageFrame(bool enable, uint16_t color, uint8_t thic
 // DisplayManager implementation
 
 // DisplayManager implementation
-DisplayManager::DisplayManager() : displayCount(0) {
+DisplayManager::DisplayManager() : displayCount(0), groupCount(0) {
     for (uint8_t i = 0; i < MAX_DISPLAYS; i++) {
         displays[i] = nullptr;
     }
@@ -262,30 +824,32 @@ DisplayManager::~DisplayManager() {
 }
 
 bool DisplayManager::addDisplay(const DisplayConfig& config) {
-    // Check capacity
-    if (displayCount >= MAX_DISPLAYS) {
-        return false;  // Maximum displays reached
+    return addDisplay(new DisplayInstance(config));
+}
+
+bool DisplayManager::addDisplay(DisplayInstance* display) {
+    if (!display) {
+        return false;  // Memory allocation failed
     }
+    const DisplayConfig& config = display->getConfig();
     
-    // Validate config
-    if (!config.name || config.width == 0 || config.height == 0) {
-        return false;  // Invalid configuration
-    }
+    // Check capacity and validate config
+    bool valid = displayCount < MAX_DISPLAYS && config.name && config.width != 0 && config.height != 0;
     
     // Check for duplicate names
-    for (uint8_t i = 0; i < displayCount; i++) {
+    for (uint8_t i = 0; valid && i < displayCount; i++) {
         if (displays[i] && strcmp(displays[i]->getName(), config.name) == 0) {
-            return false;  // Display with this name already exists
+            valid = false;  // Display with this name already exists
         }
     }
     
-    // Create display instance
-    displays[displayCount] = new DisplayInstance(config);
-    if (!displays[displayCount]) {
-        return false;  // Memory allocation failed
+    if (!valid) {
+        delete display;
+        return false;
     }
     
-    displayCount++;
+    displays[displayCount++] = display;
+    addToGroup("ALL", config.name);
     return true;
 }
 
@@ -325,6 +889,65 @@ DisplayInstance* DisplayManager::getDisplay(uint8_t index) {
     return nullptr;
 }
 
+bool DisplayManager::addToGroup(const char* groupName, const char* displayName) {
+    DisplayInstance* display = getDisplay(displayName);
+    if (!display || !groupName || strlen(groupName) == 0 ||
+        strlen(groupName) > DisplayGroup::MAX_NAME_LENGTH) {
+        return false;
+    }
+    
+    DisplayGroup* group = getGroup(groupName);
+    if (!group) {
+        if (groupCount >= MAX_GROUPS) {
+            return false;  // Maximum groups reached
+        }
+        group = &groups[groupCount++];
+        strcpy(group->name, groupName);
+        group->memberCount = 0;
+    }
+    
+    for (uint8_t i = 0; i < group->memberCount; i++) {
+        if (group->members[i] == display) {
+            return true;  // Already a member
+        }
+    }
+    if (group->memberCount >= DisplayGroup::MAX_MEMBERS) {
+        return false;
+    }
+    group->members[group->memberCount++] = display;
+    return true;
+}
+
+bool DisplayManager::removeGroup(const char* groupName) {
+    for (uint8_t i = 0; i < groupCount; i++) {
+        if (strcmp(groups[i].name, groupName) == 0) {
+            // Keep the table packed
+            for (uint8_t j = i + 1; j < groupCount; j++) {
+                groups[j - 1] = groups[j];
+            }
+            groupCount--;
+            return true;
+        }
+    }
+    return false;
+}
+
+DisplayGroup* DisplayManager::getGroup(const char* name) {
+    for (uint8_t i = 0; i < groupCount; i++) {
+        if (strcmp(groups[i].name, name) == 0) {
+            return &groups[i];
+        }
+    }
+    return nullptr;
+}
+
+DisplayGroup* DisplayManager::getGroup(uint8_t index) {
+    if (index < groupCount) {
+        return &groups[index];
+    }
+    return nullptr;
+}
+
 void DisplayManager::listDisplays(Stream& serial) {
     serial.println("Registered displays:");
     for (uint8_t i = 0; i < displayCount; i++) {
@@ -344,3 +967,17 @@ void DisplayManager::listDisplays(Stream& serial) {
         }
     }
 }
+
+void DisplayManager::listGroups(Stream& serial) {
+    serial.println("Display groups:");
+    for (uint8_t i = 0; i < groupCount; i++) {
+        serial.print("  ");
+        serial.print(groups[i].name);
+        serial.print(":");
+        for (uint8_t j = 0; j < groups[i].memberCount; j++) {
+            serial.print(j == 0 ? " " : ", ");
+            serial.print(groups[i].members[j]->getName());
+        }
+        serial.println();
+    }
+}
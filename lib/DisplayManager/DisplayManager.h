@@ -7,6 +7,10 @@
  * - Test pattern generation
  * - Display selection and lookup
  * - Coordinated operations across displays
+ * - Named display groups (mirrored content); "ALL" holds every display
+ * - Frame border save area kept in the DisplaySnapshot pool
+ * - Optional shadow framebuffer: draws compose in RAM, only dirty tiles are sent
+ * - Pluggable bus backend for burst writes (PanelBus.h, FastDisplay.h)
  */
 
 #ifndef DISPLAY_MANAGER_H
@@ -16,6 +20,10 @@
 #include <Adafruit_GFX.h>
 #include <Adafruit_ST7735.h>
 #include <SPI.h>
+#include "SpiDma.h"
+#include "ShadowBuffer.h"
+#include "DisplaySnapshot.h"
+#include "PanelBus.h"
 
 // Display configuration structure
 struct DisplayConfig {
@@ -49,7 +57,7 @@ struct DisplayConfig {
 class DisplayInstance {
 public:
     DisplayInstance(const DisplayConfig& config);
-    ~DisplayInstance();
+    virtual ~DisplayInstance();
     
     bool initialize();
     void showTestPattern();
@@ -59,7 +67,52 @@ public:
     // Getters
     const char* getName() const { return config.name; }
     const DisplayConfig& getConfig() const { return config; }
-    Adafruit_ST7735* getTFT() { return tft; }
+    
+    // Bus backend for burst writes (owned; call before initialize()). initialize()
+    // drops a backend whose begin() fails, leaving the Adafruit path.
+    void setBus(PanelBus* backend);
+    const char* getBusName() const { return bus ? bus->name() : "Adafruit"; }
+    uint32_t getBusClock() const { return bus ? bus->clockHz() : 0; }
+    
+    // Raw panel access; drawing through it bypasses the shadow framebuffer
+    // (use beginFrame() to draw)
+    Adafruit_ST7735* getTFT() { waitForTransfer(); return tft; }
+    
+    // Shadow framebuffer (ShadowBuffer.h). Enabling allocates width*height*2 bytes
+    // and clears the screen; returns false if that much RAM is not available.
+    bool enableShadow(bool enable);
+    bool isShadowEnabled() const { return shadow != nullptr; }
+    
+    // Drawing surface for Adafruit_GFX calls: the shadow when enabled, else the panel.
+    // Frames nest; the outermost endFrame() sends the dirty tiles in one burst.
+    // Pixel writes (writeRow/writeRect) inside a frame are composed as well; outside
+    // of one they go straight out and are copied into the shadow.
+    Adafruit_GFX* beginFrame();
+    void endFrame();
+    
+    // Change the panel rotation. The panel rotates in hardware (MADCTL), so the burst
+    // writes stay plain address windows; the calibrated geometry in getConfig() (size,
+    // usable area, center) is mapped into the new orientation, so a frame rendered for
+    // the configured one lands centered in the same usable area, upright. The image
+    // snapshot is re-centered the same way, frame border snapshots are dropped and a
+    // shadow framebuffer is resized (and cleared). Returns false if the resized shadow
+    // no longer fits in RAM; the display then draws straight to the panel.
+    bool setRotation(uint8_t rotation);
+    
+    // Map a rectangle from rotation from's coordinates to rotation to's, covering the
+    // same panel pixels; width and height swap for a quarter turn
+    void mapRect(uint8_t from, uint8_t to, int16_t& x, int16_t& y,
+                 int16_t& width, int16_t& height) const;
+    
+    // Address the panel in another rotation's coordinates, for a frame rendered for that
+    // orientation (SIZE option ROT). The panel's address mode (MADCTL) and the geometry in
+    // getConfig() switch to it, so the frame's rows burst out unchanged and land on the
+    // panel pixels they had in that orientation; endSourceRotation() switches back.
+    // Snapshots and the shadow framebuffer keep the display's own rotation, so this
+    // returns false with a shadow enabled.
+    bool beginSourceRotation(uint8_t rotation);
+    void endSourceRotation();
+    bool isSourceRotated() const { return ownRotation != NO_SOURCE_ROTATION; }
     
     // Drawing helpers
     void drawCalibrationFrame(int8_t adjustTop = 0, int8_t adjustBottom = 0,
@@ -67,10 +120,53 @@ public:
                              uint16_t frameColor = ST77XX_WHITE, uint8_t frameThickness = 1);
     void drawColorBars();
     void drawDeviceInfo();
+    // Top-left offset that centers a width x height bitmap in the usable area
+    // (it may reach past the area; callers check or clip)
+    void centerInUsableArea(int width, int height, int& offsetX, int& offsetY) const;
     bool isWithinBounds(int x, int y) const;
     bool isWithinFrameBounds(int x, int y, 
                             int8_t adjustTop = 0, int8_t adjustBottom = 0,
                             int8_t adjustLeft = 0, int8_t adjustRight = 0) const;
+    void getFrameBounds(int16_t& left, int16_t& top, int16_t& right, int16_t& bottom,
+                       int8_t adjustTop = 0, int8_t adjustBottom = 0,
+                       int8_t adjustLeft = 0, int8_t adjustRight = 0) const;
+    
+    // Burst pixel output: one CS/address-window transaction per call.
+    // Pixels are in display (big-endian RGB565) byte order, as received over serial.
+    void writeRow(int16_t x, int16_t y, const uint16_t* pixels, uint16_t count);
+    
+    // Same as writeRow, but returns while the span is still being clocked out by DMA
+    // (falls back to writeRow where DMA is unavailable). pixels must stay untouched
+    // until waitForTransfer() - or the next write on any display - has completed.
+    void writeRowAsync(int16_t x, int16_t y, const uint16_t* pixels, uint16_t count);
+    
+    // Burst a width x height block through a single address window. Consecutive rows
+    // start stride pixels apart (RAM or memory-mapped flash); the block is clipped to
+    // the panel. With DMA the call returns while the last row is being clocked out.
+    void writeRect(int16_t x, int16_t y, int16_t width, int16_t height,
+                   const uint16_t* pixels, uint16_t stride);
+    
+    // Redraw this display's snapshot for region from the DisplaySnapshot pool through
+    // writeRect() (DMA where available); the rectangle form (display coordinates) only
+    // redraws the part of the snapshot inside it. Returns false if there is no snapshot.
+    bool restoreSnapshot(uint8_t region = DisplaySnapshot::REGION_IMAGE);
+    bool restoreSnapshot(int16_t x, int16_t y, int16_t width, int16_t height,
+                         uint8_t region = DisplaySnapshot::REGION_IMAGE);
+    
+    // Snapshot of content as it is drawn (BMPStart:SNAPSHOT). beginSnapshot() reserves a
+    // display-coordinate rectangle in the pool; recordSpan() / recordFill() copy what was
+    // just drawn into any snapshot it overlaps, without waiting for DMA. recordSpan pixels
+    // are in display byte order, the recordFill color is native RGB565.
+    bool beginSnapshot(int16_t x, int16_t y, uint16_t width, uint16_t height,
+                       uint8_t region = DisplaySnapshot::REGION_IMAGE);
+    void recordSpan(int16_t x, int16_t y, const uint16_t* pixels, uint16_t count,
+                    uint8_t region = DisplaySnapshot::REGION_IMAGE);
+    void recordFill(int16_t x, int16_t y, int16_t width, int16_t height, uint16_t color,
+                    uint8_t region = DisplaySnapshot::REGION_IMAGE);
+    void discardSnapshot(uint8_t region = DisplaySnapshot::REGION_IMAGE);
+    
+    // Finish any in-flight DMA transfer on the shared SPI bus (releases its chip select)
+    static void waitForTransfer();
     
     // Image frame support
     void drawImageFrame(uint16_t color = ST77XX_WHITE, uint8_t thickness = 1, 
@@ -83,15 +179,51 @@ public:
     bool isImageFrameEnabled() const { return imageFrameEnabled; }
     
 private:
+    static const uint8_t NO_SOURCE_ROTATION = 0xFF;
+    
+    // Panel transaction of the burst writes, through the bus backend or Adafruit_ST7735:
+    // select the panel and open an address window, leaving DC in data mode for the pixels
+    void openWindow(int16_t x, int16_t y, int16_t width, int16_t height);
+    void writeWindowPixels(const uint16_t* pixels, uint32_t count);
+    void closeWindow();
+    
+    bool clipSpan(int16_t& x, int16_t y, const uint16_t*& pixels, uint16_t& count) const;
+    void pushRect(int16_t x, int16_t y, int16_t width, int16_t height,
+                  const uint16_t* pixels, uint16_t stride);
+    void flushShadow();
+    bool captureArea(uint8_t region, int16_t x, int16_t y, int16_t width, int16_t height);
+    void saveFrameArea(int16_t x, int16_t y, int16_t w, int16_t h, uint8_t thickness);
+    bool restoreFrameArea();
+    void mapGeometry(uint8_t rotation);
+    
+    // Display whose DMA transfer currently holds the bus (nullptr when idle)
+    static DisplayInstance* pendingTransfer;
+    
     // Image frame state
     bool imageFrameEnabled;
     uint16_t imageFrameColor;
     uint8_t imageFrameThickness;
-    uint16_t* frameBuffer;  // Stores pixels under frame for restoration
-    bool frameBufferAllocated;
     DisplayConfig config;
     Adafruit_ST7735* tft;
+    PanelBus* bus;
     bool initialized;
+    
+    // Shadow framebuffer (nullptr when off) and beginFrame() nesting depth
+    ShadowBuffer* shadow;
+    uint8_t frameDepth;
+    
+    // Rotation to return to after beginSourceRotation() (NO_SOURCE_ROTATION when not rotated)
+    uint8_t ownRotation;
+};
+
+// Named set of displays that receive the same content
+struct DisplayGroup {
+    static const uint8_t MAX_NAME_LENGTH = 15;
+    static const uint8_t MAX_MEMBERS = 8;
+    
+    char name[MAX_NAME_LENGTH + 1];
+    DisplayInstance* members[MAX_MEMBERS];
+    uint8_t memberCount;
 };
 
 // Main display manager class
@@ -102,6 +234,10 @@ public:
     
     // Setup
     bool addDisplay(const DisplayConfig& config);
+    
+    // Register a display created by the caller (e.g. a FastDisplay); the manager
+    // owns it from here on and deletes it if it cannot be added
+    bool addDisplay(DisplayInstance* display);
     bool initializeAll();
     void showAllTestPatterns();
     
@@ -110,13 +246,24 @@ public:
     DisplayInstance* getDisplay(uint8_t index);
     uint8_t getDisplayCount() const { return displayCount; }
     
+    // Display groups (created on first member)
+    bool addToGroup(const char* groupName, const char* displayName);
+    bool removeGroup(const char* groupName);
+    DisplayGroup* getGroup(const char* name);
+    DisplayGroup* getGroup(uint8_t index);
+    uint8_t getGroupCount() const { return groupCount; }
+    
     // Utility
     void listDisplays(Stream& serial);
+    void listGroups(Stream& serial);
     
 private:
     static const uint8_t MAX_DISPLAYS = 8;
+    static const uint8_t MAX_GROUPS = 8;
     DisplayInstance* displays[MAX_DISPLAYS];
     uint8_t displayCount;
+    DisplayGroup groups[MAX_GROUPS];
+    uint8_t groupCount;
 };
 
 #endif // DISPLAY_MANAGER_H
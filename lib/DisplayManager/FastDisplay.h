@@ -0,0 +1,164 @@
+/*
+ * FastDisplay.h
+ * Display instances specialized at compile time on their chip select / DC pins
+ *
+ * generate_config_header.py emits a traits struct per display with its CS and DC
+ * pins, their PIO controller (A=0 .. D=3) and bit, and the SPI clock for burst
+ * writes. FastDisplay<Traits> installs a SamSpiBus<Traits> (PanelBus.h), which
+ * opens the address window by writing the SAM3X SPI0 registers directly and
+ * toggles CS/DC with single stores to the PIO set/clear registers, where the
+ * Adafruit driver goes through SPI.transfer() and digitalWrite() (a
+ * g_APinDescription lookup per edge, six DC edges per window).
+ *
+ * The bus checks its pins against the board's pin map and that SPI0 is running
+ * in begin(); if either fails the display quietly keeps the Adafruit path.
+ * Define DISPLAY_DISABLE_FAST_PINS (or build for a non-SAM3X target) and
+ * FastDisplay behaves exactly like DisplayInstance.
+ */
+
+#ifndef FAST_DISPLAY_H
+#define FAST_DISPLAY_H
+
+#include <Arduino.h>
+#include <SPI.h>
+#include "DisplayManager.h"
+#include "PanelBus.h"
+
+#if defined(__SAM3X8E__) && !defined(DISPLAY_DISABLE_FAST_PINS)
+#define DISPLAY_FAST_PINS 1
+#else
+#define DISPLAY_FAST_PINS 0
+#endif
+
+// Burst-write SPI clock for displays whose config sets none. The SAM3X divides the
+// 84 MHz master clock by an integer, so 24 MHz runs at 21 MHz.
+#ifndef DISPLAY_SPI_CLOCK
+#define DISPLAY_SPI_CLOCK 24000000UL
+#endif
+
+#if DISPLAY_FAST_PINS
+
+// One output pin as PIO controller index and bit
+template <uint8_t Port, uint8_t Bit>
+struct FastPin {
+    static constexpr uint32_t MASK = 1UL << Bit;
+
+    static Pio* pio() {
+        return Port == 0 ? PIOA : Port == 1 ? PIOB : Port == 2 ? PIOC : PIOD;
+    }
+    static void high() { pio()->PIO_SODR = MASK; }
+    static void low() { pio()->PIO_CODR = MASK; }
+
+    // True if pin is this PIO line in the board's pin map
+    static bool matches(uint8_t pin) {
+        return g_APinDescription[pin].pPort == pio() && g_APinDescription[pin].ulPin == MASK;
+    }
+};
+
+// SPI0 driven through its registers, on the SPI library's default channel so DMA
+// transfers (SpiDma) can run inside an open window
+template <class Traits>
+class SamSpiBus : public PanelBus {
+public:
+    SamSpiBus() : savedMode(0), savedCsr(0), divider(255) {}
+
+    bool begin() override {
+        if (!Cs::matches(Traits::CS_PIN) || !Dc::matches(Traits::DC_PIN)) {
+            return false;  // DisplayConfig.h does not match this board
+        }
+        if (Traits::SPI_CLOCK == 0 || (SPI0->SPI_SR & SPI_SR_SPIENS) == 0) {
+            return false;
+        }
+        uint32_t div = (VARIANT_MCK + Traits::SPI_CLOCK - 1) / Traits::SPI_CLOCK;
+        divider = div < 1 ? 1 : (div > 255 ? 255 : div);
+        return true;
+    }
+
+    void openWindow(int16_t x, int16_t y, int16_t width, int16_t height) override {
+        // Fixed peripheral mode, as SpiDma uses, with this display's clock (SPI mode 0)
+        const uint32_t channel = BOARD_PIN_TO_SPI_CHANNEL(BOARD_SPI_DEFAULT_SS);
+        savedMode = SPI0->SPI_MR;
+        savedCsr = SPI0->SPI_CSR[channel];
+        SPI0->SPI_CSR[channel] = SPI_CSR_SCBR(divider) | SPI_CSR_NCPHA | SPI_CSR_CSAAT |
+                                 SPI_CSR_BITS_8_BIT;
+        SPI0->SPI_MR = (savedMode & ~(SPI_MR_PS | SPI_MR_PCS_Msk)) |
+                       SPI_MR_PCS((~(1u << channel)) & 0xF);
+
+        // INITR_BLACKTAB panels have no RAM offset in any rotation
+        Cs::low();
+        writeCommand(ST77XX_CASET);
+        writeWord(x);
+        writeWord(x + width - 1);
+        writeCommand(ST77XX_RASET);
+        writeWord(y);
+        writeWord(y + height - 1);
+        writeCommand(ST77XX_RAMWR);
+    }
+
+    void writePixels(const uint16_t* pixels, uint32_t count) override {
+        const uint8_t* bytes = (const uint8_t*)pixels;
+        for (uint32_t i = 0; i < count * 2; i++) {
+            writeByte(bytes[i]);
+        }
+    }
+
+    void closeWindow() override {
+        drain();
+        Cs::high();
+        const uint32_t channel = BOARD_PIN_TO_SPI_CHANNEL(BOARD_SPI_DEFAULT_SS);
+        SPI0->SPI_MR = savedMode;
+        SPI0->SPI_CSR[channel] = savedCsr;
+    }
+
+    const char* name() const override { return "SAM3X SPI0"; }
+    uint32_t clockHz() const override { return VARIANT_MCK / divider; }
+
+private:
+    typedef FastPin<Traits::CS_PORT, Traits::CS_BIT> Cs;
+    typedef FastPin<Traits::DC_PORT, Traits::DC_BIT> Dc;
+
+    static void writeByte(uint8_t value) {
+        while ((SPI0->SPI_SR & SPI_SR_TDRE) == 0) {
+        }
+        SPI0->SPI_TDR = value;
+    }
+
+    // Transmit-only: wait for the shift register, then discard the received byte
+    static void drain() {
+        while ((SPI0->SPI_SR & SPI_SR_TXEMPTY) == 0) {
+        }
+        (void)SPI0->SPI_RDR;
+        (void)SPI0->SPI_SR;
+    }
+
+    // DC may only change once every earlier byte is out; it is left high (data)
+    static void writeCommand(uint8_t command) {
+        drain();
+        Dc::low();
+        writeByte(command);
+        drain();
+        Dc::high();
+    }
+    static void writeWord(uint16_t value) {
+        writeByte(value >> 8);
+        writeByte(value & 0xFF);
+    }
+
+    uint32_t savedMode;
+    uint32_t savedCsr;
+    uint32_t divider;
+};
+
+#endif // DISPLAY_FAST_PINS
+
+template <class Traits>
+class FastDisplay : public DisplayInstance {
+public:
+    explicit FastDisplay(const DisplayConfig& config) : DisplayInstance(config) {
+#if DISPLAY_FAST_PINS
+        setBus(new SamSpiBus<Traits>());
+#endif
+    }
+};
+
+#endif // FAST_DISPLAY_H
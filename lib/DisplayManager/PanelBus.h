@@ -0,0 +1,45 @@
+/*
+ * PanelBus.h
+ * Low-level bus backend for a display's burst writes
+ *
+ * A DisplayInstance sends rows and blocks through an address window: select the
+ * panel, CASET/RASET/RAMWR, pixels, deselect. By default that goes through
+ * Adafruit_ST7735. A PanelBus installed with DisplayInstance::setBus() takes it
+ * over (see FastDisplay.h for the SAM3X register backend); GFX drawing and panel
+ * initialization always stay with the Adafruit driver.
+ *
+ * begin() runs once the Adafruit driver has initialized the panel. A backend that
+ * returns false there (pins or clock it cannot drive) is dropped and the display
+ * keeps using the Adafruit path.
+ */
+
+#ifndef PANEL_BUS_H
+#define PANEL_BUS_H
+
+#include <Arduino.h>
+
+class PanelBus {
+public:
+    virtual ~PanelBus() {}
+
+    // Validate and set up; false leaves the display on the Adafruit path
+    virtual bool begin() = 0;
+
+    // Select the panel and open a width x height address window; DC is left in data
+    // mode so pixel bytes (or a DMA transfer) can follow directly
+    virtual void openWindow(int16_t x, int16_t y, int16_t width, int16_t height) = 0;
+
+    // Blocking pixel push inside an open window (display byte order)
+    virtual void writePixels(const uint16_t* pixels, uint32_t count) = 0;
+
+    // Wait for the last byte and deselect the panel
+    virtual void closeWindow() = 0;
+
+    // Short backend name for CMD:INFO
+    virtual const char* name() const = 0;
+
+    // SPI clock actually used, in Hz
+    virtual uint32_t clockHz() const = 0;
+};
+
+#endif // PANEL_BUS_H
@@ -0,0 +1,113 @@
+/*
+ * ShadowBuffer.cpp
+ * RAM copy of a display's pixels with dirty-tile tracking
+ */
+
+#include "ShadowBuffer.h"
+#include <stdlib.h>
+#include <string.h>
+
+ShadowBuffer::ShadowBuffer(int16_t width, int16_t height)
+    : Adafruit_GFX(width, height), pixels(nullptr), dirtyTiles(nullptr), dirty(false) {
+    if (width <= 0 || height <= 0 || width > MAX_WIDTH) {
+        return;
+    }
+
+    dirtyTiles = (uint32_t*)calloc(height, sizeof(uint32_t));
+    pixels = (uint16_t*)malloc((size_t)width * height * sizeof(uint16_t));
+    if (!pixels || !dirtyTiles) {
+        free(pixels);
+        free(dirtyTiles);
+        pixels = nullptr;
+        dirtyTiles = nullptr;
+    }
+}
+
+ShadowBuffer::~ShadowBuffer() {
+    free(pixels);
+    free(dirtyTiles);
+}
+
+bool ShadowBuffer::clipRect(int16_t& x, int16_t& y, int16_t& w, int16_t& h) const {
+    if (!pixels) {
+        return false;
+    }
+    if (x < 0) {
+        w += x;
+        x = 0;
+    }
+    if (y < 0) {
+        h += y;
+        y = 0;
+    }
+    if (x + w > WIDTH) {
+        w = WIDTH - x;
+    }
+    if (y + h > HEIGHT) {
+        h = HEIGHT - y;
+    }
+    return w > 0 && h > 0;
+}
+
+void ShadowBuffer::markDirty(int16_t x, int16_t y, int16_t w, int16_t h) {
+    uint8_t firstTile = x / TILE_WIDTH;
+    uint8_t lastTile = (x + w - 1) / TILE_WIDTH;
+    uint32_t mask = (uint32_t)(((uint64_t)2 << lastTile) - ((uint64_t)1 << firstTile));
+    for (int16_t row = y; row < y + h; row++) {
+        dirtyTiles[row] |= mask;
+    }
+    dirty = true;
+}
+
+void ShadowBuffer::markClean() {
+    if (dirtyTiles) {
+        memset(dirtyTiles, 0, HEIGHT * sizeof(uint32_t));
+    }
+    dirty = false;
+}
+
+void ShadowBuffer::drawPixel(int16_t x, int16_t y, uint16_t color) {
+    fillRect(x, y, 1, 1, color);
+}
+
+void ShadowBuffer::drawFastHLine(int16_t x, int16_t y, int16_t w, uint16_t color) {
+    fillRect(x, y, w, 1, color);
+}
+
+void ShadowBuffer::drawFastVLine(int16_t x, int16_t y, int16_t h, uint16_t color) {
+    fillRect(x, y, 1, h, color);
+}
+
+void ShadowBuffer::fillRect(int16_t x, int16_t y, int16_t w, int16_t h, uint16_t color) {
+    if (!clipRect(x, y, w, h)) {
+        return;
+    }
+
+    // Stored in display byte order
+    uint16_t value = (uint16_t)((color >> 8) | (color << 8));
+    uint16_t* row = pixels + (uint32_t)y * WIDTH + x;
+    for (int16_t r = 0; r < h; r++, row += WIDTH) {
+        for (int16_t c = 0; c < w; c++) {
+            row[c] = value;
+        }
+    }
+    markDirty(x, y, w, h);
+}
+
+void ShadowBuffer::fillScreen(uint16_t color) {
+    fillRect(0, 0, WIDTH, HEIGHT, color);
+}
+
+void ShadowBuffer::writeSpan(int16_t x, int16_t y, const uint16_t* src, uint16_t count, bool markAsDirty) {
+    int16_t firstX = x;
+    int16_t w = count;
+    int16_t h = 1;
+    if (!clipRect(firstX, y, w, h)) {
+        return;
+    }
+
+    memcpy(pixels + (uint32_t)y * WIDTH + firstX, src + (firstX - x), (size_t)w * sizeof(uint16_t));
+    if (markAsDirty) {
+        markDirty(firstX, y, w, 1);
+    }
+}
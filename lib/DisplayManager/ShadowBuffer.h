@@ -0,0 +1,58 @@
+/*
+ * ShadowBuffer.h
+ * RAM copy of a display's pixels with dirty-tile tracking
+ *
+ * A ShadowBuffer is an Adafruit_GFX canvas the size of the panel in its current
+ * rotation. Drawing lands in RAM and marks the TILE_WIDTH-pixel tiles it touches
+ * in each row; DisplayInstance::endFrame() then sends only the dirty spans, so
+ * overlapping draws reach the panel once, in one burst. Pixels are kept in
+ * display (big-endian RGB565) byte order and go to writeRect()/DMA unchanged.
+ * A 160x128 panel takes 40 KB.
+ */
+
+#ifndef SHADOW_BUFFER_H
+#define SHADOW_BUFFER_H
+
+#include <Arduino.h>
+#include <Adafruit_GFX.h>
+
+class ShadowBuffer : public Adafruit_GFX {
+public:
+    static const uint8_t TILE_WIDTH = 8;
+    static const int16_t MAX_WIDTH = 32 * TILE_WIDTH;  // One 32-bit tile mask per row
+
+    ShadowBuffer(int16_t width, int16_t height);
+    ~ShadowBuffer();
+
+    // False if the buffer could not be allocated (or the panel is too wide)
+    bool isValid() const { return pixels != nullptr; }
+
+    // Adafruit_GFX drawing; colors are native RGB565
+    void drawPixel(int16_t x, int16_t y, uint16_t color) override;
+    void drawFastHLine(int16_t x, int16_t y, int16_t w, uint16_t color) override;
+    void drawFastVLine(int16_t x, int16_t y, int16_t h, uint16_t color) override;
+    void fillRect(int16_t x, int16_t y, int16_t w, int16_t h, uint16_t color) override;
+    void fillScreen(uint16_t color) override;
+
+    // Copy a span that is already in display byte order. markAsDirty = false records
+    // content the panel is being sent anyway (write-through).
+    void writeSpan(int16_t x, int16_t y, const uint16_t* src, uint16_t count, bool markAsDirty);
+
+    const uint16_t* getPixels(int16_t x, int16_t y) const { return pixels + (uint32_t)y * WIDTH + x; }
+    uint16_t getStride() const { return WIDTH; }
+
+    // Bit n of a row's mask covers pixels n*TILE_WIDTH .. n*TILE_WIDTH+TILE_WIDTH-1
+    uint32_t getDirtyMask(int16_t y) const { return dirtyTiles[y]; }
+    bool isDirty() const { return dirty; }
+    void markClean();
+
+private:
+    bool clipRect(int16_t& x, int16_t& y, int16_t& w, int16_t& h) const;
+    void markDirty(int16_t x, int16_t y, int16_t w, int16_t h);
+
+    uint16_t* pixels;
+    uint32_t* dirtyTiles;
+    bool dirty;
+};
+
+#endif // SHADOW_BUFFER_H
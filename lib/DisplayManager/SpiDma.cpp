@@ -0,0 +1,114 @@
+/*
+ * SpiDma.cpp
+ * SAM3X8E DMAC memory-to-SPI0 transmit
+ */
+
+#include "SpiDma.h"
+
+#if DISPLAY_SPI_DMA
+
+#include <SPI.h>
+
+#ifndef DISPLAY_SPI_DMA_CHANNEL
+#define DISPLAY_SPI_DMA_CHANNEL 0       // DMAC channel used for SPI0 TX
+#endif
+
+static const uint32_t SPI0_TX_HW_INTERFACE = 1;  // DMAC handshaking interface ID for SPI0 TX
+
+static bool     g_dmaReady = false;
+static bool     g_dmaActive = false;
+static uint32_t g_savedMode = 0;                 // SPI_MR while a transfer is active
+
+namespace SpiDma {
+
+bool begin() {
+    if (g_dmaReady) return true;
+
+    pmc_enable_periph_clk(ID_DMAC);
+    DMAC->DMAC_EN &= ~DMAC_EN_ENABLE;
+    DMAC->DMAC_GCFG = DMAC_GCFG_ARB_CFG_FIXED;
+    DMAC->DMAC_EN = DMAC_EN_ENABLE;
+    DMAC->DMAC_CHDR = DMAC_CHDR_DIS0 << DISPLAY_SPI_DMA_CHANNEL;
+
+    g_dmaReady = true;
+    return true;
+}
+
+bool isAvailable() {
+    return g_dmaReady;
+}
+
+void start(const uint8_t* src, uint16_t count) {
+    wait();
+    if (count == 0) return;
+
+    // The Due SPI library runs SPI0 in variable peripheral mode, where each TDR write
+    // carries its own chip-select field. Byte-wide DMA writes would leave that field 0
+    // (NPCS0), so switch to fixed peripheral mode on the library's default channel for
+    // the duration of the transfer; this keeps the transaction's CSR settings in effect.
+    const uint32_t channel = BOARD_PIN_TO_SPI_CHANNEL(BOARD_SPI_DEFAULT_SS);
+    g_savedMode = SPI0->SPI_MR;
+    SPI0->SPI_MR = (g_savedMode & ~(SPI_MR_PS | SPI_MR_PCS_Msk)) |
+                   SPI_MR_PCS((~(1u << channel)) & 0xF);
+
+    const uint32_t ch = DISPLAY_SPI_DMA_CHANNEL;
+    DMAC->DMAC_CHDR = DMAC_CHDR_DIS0 << ch;
+    (void)DMAC->DMAC_EBCISR;  // clear stale buffer/chained-buffer completion status
+
+    DMAC->DMAC_CH_NUM[ch].DMAC_SADDR = (uint32_t)src;
+    DMAC->DMAC_CH_NUM[ch].DMAC_DADDR = (uint32_t)&SPI0->SPI_TDR;
+    DMAC->DMAC_CH_NUM[ch].DMAC_DSCR = 0;
+    DMAC->DMAC_CH_NUM[ch].DMAC_CTRLA = count |
+                                       DMAC_CTRLA_SRC_WIDTH_BYTE |
+                                       DMAC_CTRLA_DST_WIDTH_BYTE;
+    DMAC->DMAC_CH_NUM[ch].DMAC_CTRLB = DMAC_CTRLB_SRC_DSCR |
+                                       DMAC_CTRLB_DST_DSCR |
+                                       DMAC_CTRLB_FC_MEM2PER_DMA_FC |
+                                       DMAC_CTRLB_SRC_INCR_INCREMENTING |
+                                       DMAC_CTRLB_DST_INCR_FIXED;
+    DMAC->DMAC_CH_NUM[ch].DMAC_CFG = DMAC_CFG_DST_PER(SPI0_TX_HW_INTERFACE) |
+                                     DMAC_CFG_DST_H2SEL |
+                                     DMAC_CFG_SOD |
+                                     DMAC_CFG_FIFOCFG_ALAP_CFG;
+    DMAC->DMAC_CHER = DMAC_CHER_ENA0 << ch;
+    g_dmaActive = true;
+}
+
+bool isBusy() {
+    if (!g_dmaActive) return false;
+    if (DMAC->DMAC_CHSR & (DMAC_CHSR_ENA0 << DISPLAY_SPI_DMA_CHANNEL)) return true;
+    return (SPI0->SPI_SR & SPI_SR_TXEMPTY) == 0;
+}
+
+void wait() {
+    if (!g_dmaActive) return;
+
+    while (DMAC->DMAC_CHSR & (DMAC_CHSR_ENA0 << DISPLAY_SPI_DMA_CHANNEL)) {
+    }
+    while ((SPI0->SPI_SR & SPI_SR_TXEMPTY) == 0) {
+    }
+
+    // Transmit-only DMA leaves the last received byte (and overrun) behind; drain it so
+    // the SPI library's next transfer() waits for its own byte rather than returning early.
+    (void)SPI0->SPI_RDR;
+    (void)SPI0->SPI_SR;
+
+    SPI0->SPI_MR = g_savedMode;
+    g_dmaActive = false;
+}
+
+} // namespace SpiDma
+
+#else // !DISPLAY_SPI_DMA
+
+namespace SpiDma {
+
+bool begin() { return false; }
+bool isAvailable() { return false; }
+void start(const uint8_t* src, uint16_t count) { (void)src; (void)count; }
+bool isBusy() { return false; }
+void wait() {}
+
+} // namespace SpiDma
+
+#endif // DISPLAY_SPI_DMA
@@ -0,0 +1,45 @@
+/*
+ * SpiDma.h
+ * DMA-driven SPI transmit for display writes on the Arduino Due (SAM3X8E)
+ * 
+ * The SAM3X SPI peripheral has no PDC; transmit DMA goes through the DMAC
+ * with SPI0 TX as the hardware handshaking interface. A transfer is started
+ * with start() and runs while the CPU returns to USB reception; wait() blocks
+ * until the last byte has left the shift register.
+ * 
+ * Define DISPLAY_DISABLE_SPI_DMA to force the blocking Adafruit path.
+ * On non-SAM3X targets the module compiles to stubs and isAvailable() is false.
+ */
+
+#ifndef SPI_DMA_H
+#define SPI_DMA_H
+
+#include <Arduino.h>
+
+#if defined(__SAM3X8E__) && !defined(DISPLAY_DISABLE_SPI_DMA)
+#define DISPLAY_SPI_DMA 1
+#else
+#define DISPLAY_SPI_DMA 0
+#endif
+
+namespace SpiDma {
+
+// One-time DMAC setup. Safe to call repeatedly. Returns false if DMA is unsupported.
+bool begin();
+
+// True once begin() succeeded on a DMA-capable build
+bool isAvailable();
+
+// Start transmitting count bytes from src (RAM or flash) on SPI0.
+// The caller owns chip select / DC and must keep src valid until wait() returns.
+void start(const uint8_t* src, uint16_t count);
+
+// True while a transfer is still being clocked out
+bool isBusy();
+
+// Block until the transfer has fully left the SPI shift register
+void wait();
+
+} // namespace SpiDma
+
+#endif // SPI_DMA_H
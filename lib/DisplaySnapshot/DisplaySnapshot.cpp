@@ -0,0 +1,363 @@
+#include "DisplaySnapshot.h"
+#include <string.h>
+
+namespace {
+
+struct Slot {
+  bool used;
+  const Adafruit_ST7735 *display;
+  uint8_t region;
+  SnapshotHeader header;
+  uint32_t offset;   // byte offset of the pixels in the arena
+  uint32_t size;     // bytes reserved (word aligned)
+  uint32_t lastUse;  // use clock value of the most recent access
+};
+
+// Word aligned, so slot pixels can go straight to writePixels or DMA
+uint32_t g_arena[DISPLAY_SNAPSHOT_ARENA_SIZE / 4];
+Slot g_slots[DisplaySnapshot::MAX_SLOTS];
+uint32_t g_useClock = 0;
+uint32_t g_captures = 0;
+uint32_t g_evictions = 0;
+uint32_t g_failures = 0;
+
+uint8_t *arenaBytes() {
+  return (uint8_t *)g_arena;
+}
+
+uint16_t *slotPixels(const Slot &slot) {
+  return (uint16_t *)(arenaBytes() + slot.offset);
+}
+
+void touch(Slot &slot) {
+  slot.lastUse = ++g_useClock;
+}
+
+Slot *findSlot(const Adafruit_ST7735 *display, uint8_t region) {
+  for (uint8_t i = 0; i < DisplaySnapshot::MAX_SLOTS; i++) {
+    if (g_slots[i].used && g_slots[i].display == display && g_slots[i].region == region) {
+      return &g_slots[i];
+    }
+  }
+  return nullptr;
+}
+
+uint32_t bytesUsed() {
+  uint32_t total = 0;
+  for (uint8_t i = 0; i < DisplaySnapshot::MAX_SLOTS; i++) {
+    if (g_slots[i].used) total += g_slots[i].size;
+  }
+  return total;
+}
+
+Slot *freeSlot() {
+  for (uint8_t i = 0; i < DisplaySnapshot::MAX_SLOTS; i++) {
+    if (!g_slots[i].used) return &g_slots[i];
+  }
+  return nullptr;
+}
+
+void evictLeastRecentlyUsed() {
+  Slot *victim = nullptr;
+  for (uint8_t i = 0; i < DisplaySnapshot::MAX_SLOTS; i++) {
+    if (g_slots[i].used && (!victim || g_slots[i].lastUse < victim->lastUse)) {
+      victim = &g_slots[i];
+    }
+  }
+  if (victim) {
+    victim->used = false;
+    g_evictions++;
+  }
+}
+
+// Used slots in ascending arena order; returns the count
+uint8_t sortedSlots(Slot **order) {
+  uint8_t count = 0;
+  for (uint8_t i = 0; i < DisplaySnapshot::MAX_SLOTS; i++) {
+    if (!g_slots[i].used) continue;
+    uint8_t j = count++;
+    while (j > 0 && order[j - 1]->offset > g_slots[i].offset) {
+      order[j] = order[j - 1];
+      j--;
+    }
+    order[j] = &g_slots[i];
+  }
+  return count;
+}
+
+// First gap of at least size bytes, or -1
+long findGap(uint32_t size) {
+  Slot *order[DisplaySnapshot::MAX_SLOTS];
+  uint8_t count = sortedSlots(order);
+  uint32_t start = 0;
+  for (uint8_t i = 0; i < count; i++) {
+    if (order[i]->offset - start >= size) return (long)start;
+    start = order[i]->offset + order[i]->size;
+  }
+  return (DISPLAY_SNAPSHOT_ARENA_SIZE - start >= size) ? (long)start : -1;
+}
+
+// Slide every slot down to the start of the arena, closing the gaps between them
+void compact() {
+  Slot *order[DisplaySnapshot::MAX_SLOTS];
+  uint8_t count = sortedSlots(order);
+  uint32_t next = 0;
+  for (uint8_t i = 0; i < count; i++) {
+    if (order[i]->offset != next) {
+      memmove(arenaBytes() + next, arenaBytes() + order[i]->offset, order[i]->size);
+      order[i]->offset = next;
+    }
+    next += order[i]->size;
+  }
+}
+
+// Clip the display-coordinate rectangle to the slot; returns its first pixel, or nullptr
+uint16_t *clipToSlot(const Slot &slot, int16_t &x, int16_t &y, int16_t &width, int16_t &height) {
+  const SnapshotHeader &hdr = slot.header;
+  int left = (x > hdr.offsetX) ? x : hdr.offsetX;
+  int top = (y > hdr.offsetY) ? y : hdr.offsetY;
+  int right = x + width;
+  int bottom = y + height;
+  if (right > hdr.offsetX + (int)hdr.width) right = hdr.offsetX + hdr.width;
+  if (bottom > hdr.offsetY + (int)hdr.height) bottom = hdr.offsetY + hdr.height;
+  if (left >= right || top >= bottom) return nullptr;
+
+  x = left;
+  y = top;
+  width = right - left;
+  height = bottom - top;
+  return slotPixels(slot) + (uint32_t)(top - hdr.offsetY) * hdr.width + (left - hdr.offsetX);
+}
+
+} // namespace
+
+namespace DisplaySnapshot {
+
+uint16_t *allocate(const Adafruit_ST7735 *display, uint8_t region,
+                   uint16_t width, uint16_t height, int16_t offsetX, int16_t offsetY) {
+  if (width == 0 || height == 0) return nullptr;
+
+  uint32_t size = ((uint32_t)width * height * sizeof(uint16_t) + 3) & ~3UL;
+  if (size > DISPLAY_SNAPSHOT_ARENA_SIZE) {
+    g_failures++;
+    return nullptr;
+  }
+
+  // A new capture replaces the old one for the same display and region
+  discardSnapshot(display, region);
+
+  // Make room by dropping the least recently used snapshots
+  while (bytesUsed() + size > DISPLAY_SNAPSHOT_ARENA_SIZE || !freeSlot()) {
+    evictLeastRecentlyUsed();
+  }
+
+  long offset = findGap(size);
+  if (offset < 0) {
+    compact();
+    offset = bytesUsed();
+  }
+
+  Slot *slot = freeSlot();
+  slot->used = true;
+  slot->display = display;
+  slot->region = region;
+  slot->header.width = width;
+  slot->header.height = height;
+  slot->header.offsetX = offsetX;
+  slot->header.offsetY = offsetY;
+  slot->offset = (uint32_t)offset;
+  slot->size = size;
+  touch(*slot);
+  g_captures++;
+  return slotPixels(*slot);
+}
+
+bool captureFromBuffer(const Adafruit_ST7735 *display, uint8_t region, const uint16_t *src,
+                       uint16_t width, uint16_t height, int16_t offsetX, int16_t offsetY) {
+  if (!src) return false;
+
+  uint16_t *dest = allocate(display, region, width, height, offsetX, offsetY);
+  if (!dest) return false;
+
+  // Copy pixel data (display byte order, row-major)
+  memcpy(dest, src, (size_t)width * height * sizeof(uint16_t));
+  return true;
+}
+
+bool captureFromSnapshot(const Adafruit_ST7735 *display, uint8_t region, uint8_t srcRegion,
+                         int16_t x, int16_t y, uint16_t width, uint16_t height) {
+  // Mark the source as just used so making room for the copy evicts other slots first
+  Slot *src = findSlot(display, srcRegion);
+  if (!src || region == srcRegion) return false;
+  touch(*src);
+
+  uint16_t *dest = allocate(display, region, width, height, x, y);
+  if (!dest) return false;
+
+  // Allocation may have moved (or, in a small arena, evicted) the source
+  src = findSlot(display, srcRegion);
+  if (!src) {
+    discardSnapshot(display, region);
+    return false;
+  }
+  const SnapshotHeader &hdr = src->header;
+  const uint16_t *srcPixels = slotPixels(*src);
+
+  for (uint16_t r = 0; r < height; ++r) {
+    int sy = y + (int)r - hdr.offsetY;
+    for (uint16_t c = 0; c < width; ++c) {
+      int sx = x + (int)c - hdr.offsetX;
+      bool covered = sx >= 0 && sx < (int)hdr.width && sy >= 0 && sy < (int)hdr.height;
+      dest[r * width + c] = covered ? srcPixels[sy * hdr.width + sx] : 0;
+    }
+  }
+  return true;
+}
+
+bool captureFromDisplay(Adafruit_ST7735 &tft, uint16_t x, uint16_t y, uint16_t width, uint16_t height) {
+  // Many ST7735 drivers (including common Adafruit_ST7735) don't implement a readPixel API.
+  // Implementing a generic read-back is driver-dependent and can be slow. This function attempts
+  // to provide a hook but will return false to indicate unsupported on this platform.
+  (void)tft; (void)x; (void)y; (void)width; (void)height;
+  return false; // Not supported in this reference implementation.
+}
+
+bool hasSnapshot(const Adafruit_ST7735 *display, uint8_t region) {
+  return findSlot(display, region) != nullptr;
+}
+
+const SnapshotHeader *getSnapshotHeader(const Adafruit_ST7735 *display, uint8_t region) {
+  Slot *slot = findSlot(display, region);
+  if (!slot) return nullptr;
+  touch(*slot);
+  return &slot->header;
+}
+
+const uint16_t *getPixels(const Adafruit_ST7735 *display, uint8_t region) {
+  Slot *slot = findSlot(display, region);
+  if (!slot) return nullptr;
+  touch(*slot);
+  return slotPixels(*slot);
+}
+
+bool clipToSnapshot(const Adafruit_ST7735 *display, uint8_t region,
+                    int16_t &x, int16_t &y, int16_t &width, int16_t &height,
+                    const uint16_t *&pixels, uint16_t &stride) {
+  Slot *slot = findSlot(display, region);
+  if (!slot) return false;
+  touch(*slot);
+  pixels = clipToSlot(*slot, x, y, width, height);
+  stride = slot->header.width;
+  return pixels != nullptr;
+}
+
+bool writeSpan(const Adafruit_ST7735 *display, uint8_t region, int16_t x, int16_t y,
+               const uint16_t *pixels, uint16_t count) {
+  Slot *slot = findSlot(display, region);
+  if (!slot) return false;
+
+  int16_t firstX = x;
+  int16_t width = count;
+  int16_t height = 1;
+  uint16_t *dest = clipToSlot(*slot, firstX, y, width, height);
+  if (dest) {
+    memcpy(dest, pixels + (firstX - x), (size_t)width * sizeof(uint16_t));
+  }
+  return true;
+}
+
+bool fillRect(const Adafruit_ST7735 *display, uint8_t region, int16_t x, int16_t y,
+              int16_t width, int16_t height, uint16_t value) {
+  Slot *slot = findSlot(display, region);
+  if (!slot) return false;
+
+  uint16_t *dest = clipToSlot(*slot, x, y, width, height);
+  if (dest) {
+    for (int16_t r = 0; r < height; ++r, dest += slot->header.width) {
+      for (int16_t c = 0; c < width; ++c) {
+        dest[c] = value;
+      }
+    }
+  }
+  return true;
+}
+
+bool restoreRect(Adafruit_ST7735 &tft, uint8_t region, int16_t x, int16_t y, int16_t width, int16_t height) {
+  if (!findSlot(&tft, region)) return false;
+
+  // Clip once against the snapshot and the panel, then stream the block through a
+  // single address window (the panel advances through the window by itself)
+  const uint16_t *pixels;
+  uint16_t stride;
+  if (!clipToSnapshot(&tft, region, x, y, width, height, pixels, stride)) return true;
+  if (x < 0) { pixels += -x; width += x; x = 0; }
+  if (y < 0) { pixels += (uint32_t)(-y) * stride; height += y; y = 0; }
+  if (x + width > (int)tft.width()) width = tft.width() - x;
+  if (y + height > (int)tft.height()) height = tft.height() - y;
+  if (width <= 0 || height <= 0) return true;
+
+  tft.startWrite();
+  tft.setAddrWindow(x, y, width, height);
+  if (stride == width) {
+    tft.writePixels(const_cast<uint16_t *>(pixels), (uint32_t)width * height, true, true);
+  } else {
+    for (int16_t r = 0; r < height; ++r) {
+      tft.writePixels(const_cast<uint16_t *>(pixels + (uint32_t)r * stride), width, true, true);
+    }
+  }
+  tft.endWrite();
+  return true;
+}
+
+bool restoreToDisplay(Adafruit_ST7735 &tft, uint8_t region) {
+  Slot *slot = findSlot(&tft, region);
+  if (!slot) return false;
+  const SnapshotHeader &hdr = slot->header;
+  return restoreRect(tft, region, hdr.offsetX, hdr.offsetY, hdr.width, hdr.height);
+}
+
+bool moveSnapshot(const Adafruit_ST7735 *display, uint8_t region, int16_t offsetX, int16_t offsetY) {
+  Slot *slot = findSlot(display, region);
+  if (!slot) return false;
+  slot->header.offsetX = offsetX;
+  slot->header.offsetY = offsetY;
+  return true;
+}
+
+void discardSnapshot(const Adafruit_ST7735 *display, uint8_t region) {
+  Slot *slot = findSlot(display, region);
+  if (slot) {
+    slot->used = false;
+  }
+}
+
+void discardAll(const Adafruit_ST7735 *display) {
+  for (uint8_t i = 0; i < MAX_SLOTS; i++) {
+    if (!display || g_slots[i].display == display) {
+      g_slots[i].used = false;
+    }
+  }
+}
+
+void getStats(SnapshotStats &stats) {
+  stats.arenaSize = DISPLAY_SNAPSHOT_ARENA_SIZE;
+  stats.bytesUsed = bytesUsed();
+  stats.slotsUsed = 0;
+  for (uint8_t i = 0; i < MAX_SLOTS; i++) {
+    if (g_slots[i].used) stats.slotsUsed++;
+  }
+  stats.maxSlots = MAX_SLOTS;
+  stats.captures = g_captures;
+  stats.evictions = g_evictions;
+  stats.failures = g_failures;
+}
+
+bool getSlot(uint8_t index, const Adafruit_ST7735 *&display, uint8_t &region, SnapshotHeader &header) {
+  if (index >= MAX_SLOTS || !g_slots[index].used) return false;
+  display = g_slots[index].display;
+  region = g_slots[index].region;
+  header = g_slots[index].header;
+  return true;
+}
+
+} // namespace DisplaySnapshot
@@ -0,0 +1,131 @@
+#ifndef DISPLAY_SNAPSHOT_H
+#define DISPLAY_SNAPSHOT_H
+
+#include <Arduino.h>
+#include <Adafruit_ST7735.h>
+#include <stdint.h>
+
+// Size of the static snapshot arena in bytes. The default holds one full 160x128 image
+// (40 KB) plus the frame border strips of two displays; it shares the Due's 96 KB of SRAM
+// with a shadow framebuffer (another 40 KB), so set it from the build flags
+// (platformio.ini) to match the configured panels rather than growing it here.
+#ifndef DISPLAY_SNAPSHOT_ARENA_SIZE
+#define DISPLAY_SNAPSHOT_ARENA_SIZE (44UL * 1024UL)
+#endif
+
+// Geometry of one stored snapshot
+struct SnapshotHeader {
+  uint16_t width;   // captured width (pixels)
+  uint16_t height;  // captured height (pixels)
+  int16_t  offsetX; // x offset where the rectangle was drawn on the display
+  int16_t  offsetY; // y offset where the rectangle was drawn on the display
+};
+
+// Pool usage counters (CMD:SNAPSHOTS)
+struct SnapshotStats {
+  uint32_t arenaSize;   // bytes
+  uint32_t bytesUsed;   // bytes held by slots
+  uint8_t  slotsUsed;
+  uint8_t  maxSlots;
+  uint32_t captures;    // successful allocations
+  uint32_t evictions;   // slots dropped to make room (least recently used first)
+  uint32_t failures;    // requests larger than the arena
+};
+
+// Snapshot pool for capturing/restoring rectangles of pixels.
+// Snapshots live in one static arena (no heap use) as up to MAX_SLOTS slots, each
+// tagged with the display it belongs to and a region id, so every display can keep
+// its image and the area under its frame border at the same time. When the arena
+// is full the least recently used slots are evicted; free space is compacted, so
+// it never fragments.
+// Pixels are stored row-major in display (big-endian RGB565) byte order, the order
+// they arrive in over serial. Pointers into the arena stay valid until the next
+// capture or allocate call, which may move slots.
+// - captureFromBuffer() copies pixels from an existing in-memory buffer (recommended)
+// - captureFromDisplay() is provided but may be unsupported depending on your driver
+// - restoreToDisplay() draws pixels back to the provided Adafruit_ST7735 instance in one
+//   address window; restoreRect() redraws only part of a snapshot (undoing a small overlay)
+
+namespace DisplaySnapshot {
+
+static const uint8_t MAX_SLOTS = 8;
+
+// Region ids; values from REGION_USER up are free for application use
+enum Region : uint8_t {
+  REGION_IMAGE = 0,       // the bitmap area
+  REGION_FRAME_TOP,       // pixels under the image frame border, one slot per side
+  REGION_FRAME_BOTTOM,
+  REGION_FRAME_LEFT,
+  REGION_FRAME_RIGHT,
+  REGION_USER
+};
+
+// Reserve a slot for display/region (replacing any previous one) and return its pixel
+// storage for the caller to fill, or nullptr if width*height pixels cannot fit.
+uint16_t *allocate(const Adafruit_ST7735 *display, uint8_t region,
+                   uint16_t width, uint16_t height, int16_t offsetX, int16_t offsetY);
+
+// Capture pixels from an existing buffer (row-major, display byte order). This is the recommended
+// and fast approach when you already have the pixel source (for example, captured during serial upload).
+// src points to width*height uint16_t elements. The function makes an internal copy.
+bool captureFromBuffer(const Adafruit_ST7735 *display, uint8_t region, const uint16_t *src,
+                       uint16_t width, uint16_t height, int16_t offsetX, int16_t offsetY);
+
+// Copy the display-coordinate rectangle (x, y, width, height) out of the display's srcRegion
+// snapshot into a new slot. Pixels the source does not cover are taken as black, which is
+// what a bitmap transfer leaves around the bitmap.
+bool captureFromSnapshot(const Adafruit_ST7735 *display, uint8_t region, uint8_t srcRegion,
+                         int16_t x, int16_t y, uint16_t width, uint16_t height);
+
+// Attempt to capture pixels directly from the display. Many ST7735 drivers do not support reading
+// pixels back; this function may fail and return false on those setups. If successful, a snapshot is stored.
+bool captureFromDisplay(Adafruit_ST7735 &tft, uint16_t x, uint16_t y, uint16_t width, uint16_t height);
+
+// Returns true if the display has a snapshot for region
+bool hasSnapshot(const Adafruit_ST7735 *display, uint8_t region = REGION_IMAGE);
+
+// Return the snapshot header (read-only) or nullptr if no snapshot present. Counts as a use.
+const SnapshotHeader *getSnapshotHeader(const Adafruit_ST7735 *display, uint8_t region = REGION_IMAGE);
+
+// Return the snapshot pixels or nullptr if no snapshot present. Counts as a use.
+const uint16_t *getPixels(const Adafruit_ST7735 *display, uint8_t region = REGION_IMAGE);
+
+// Restore the display's snapshot for region to tft. Returns true on success.
+bool restoreToDisplay(Adafruit_ST7735 &tft, uint8_t region = REGION_IMAGE);
+
+// Restore only the part of the snapshot inside the display-coordinate rectangle
+// (x, y, width, height). Returns false if there is no snapshot; true otherwise, even
+// when the rectangle misses it.
+bool restoreRect(Adafruit_ST7735 &tft, uint8_t region, int16_t x, int16_t y, int16_t width, int16_t height);
+
+// Clip the display-coordinate rectangle (x, y, width, height) to the display's snapshot
+// for region. On success it holds the covered part, pixels points at its first pixel and
+// stride is the snapshot row length. Returns false if nothing is covered. Counts as a use.
+bool clipToSnapshot(const Adafruit_ST7735 *display, uint8_t region,
+                    int16_t &x, int16_t &y, int16_t &width, int16_t &height,
+                    const uint16_t *&pixels, uint16_t &stride);
+
+// Keep a snapshot current while its area is redrawn: copy count pixels drawn at display
+// row y from x (writeSpan), or fill a rectangle with one pixel value (fillRect), into the
+// part of the snapshot they cover. Values are in display byte order. Returns false if
+// there is no snapshot. Neither counts as a use.
+bool writeSpan(const Adafruit_ST7735 *display, uint8_t region, int16_t x, int16_t y,
+               const uint16_t *pixels, uint16_t count);
+bool fillRect(const Adafruit_ST7735 *display, uint8_t region, int16_t x, int16_t y,
+              int16_t width, int16_t height, uint16_t value);
+
+// Place the display's snapshot for region at a new display position, for example after a
+// rotation change. Returns false if there is no snapshot. Does not count as a use.
+bool moveSnapshot(const Adafruit_ST7735 *display, uint8_t region, int16_t offsetX, int16_t offsetY);
+
+// Discard one snapshot, or every snapshot of a display (display == nullptr: all of them).
+void discardSnapshot(const Adafruit_ST7735 *display, uint8_t region = REGION_IMAGE);
+void discardAll(const Adafruit_ST7735 *display = nullptr);
+
+// Pool usage; getSlot() describes slot index (0..MAX_SLOTS-1), false if it is empty.
+void getStats(SnapshotStats &stats);
+bool getSlot(uint8_t index, const Adafruit_ST7735 *&display, uint8_t &region, SnapshotHeader &header);
+
+} // namespace DisplaySnapshot
+
+#endif // DISPLAY_SNAPSHOT_H
@@ -0,0 +1,420 @@
+/*
+ * ImageStore.cpp
+ * Flash-backed image log with an in-RAM index
+ */
+
+#include "ImageStore.h"
+#include <string.h>
+
+static const uint32_t PAGE_SIZE = IMAGE_STORE_PAGE_SIZE;
+static const uint32_t ERASED_WORD = 0xFFFFFFFF;
+
+#if IMAGE_STORE_FLASH
+
+// End of the firmware image: .text followed by the initial values of .data
+extern "C" uint32_t _etext;
+extern "C" uint32_t _srelocate;
+extern "C" uint32_t _erelocate;
+
+static const uint32_t REGION_ADDRESS = IFLASH1_ADDR + IFLASH1_SIZE - IMAGE_STORE_SIZE;
+
+#else
+
+static uint32_t g_region[IMAGE_STORE_SIZE / 4];  // RAM stand-in for the flash region
+static bool g_regionErased = false;
+
+#endif
+
+ImageStore::ImageStore()
+    : base(nullptr), available(false), writeOffset(0), liveBytes(0), imageCount(0),
+      writing(false), pendingOffset(0), pendingBytes(0), pageOffset(0), pageFill(0) {
+}
+
+bool ImageStore::begin() {
+#if IMAGE_STORE_FLASH
+    // Never hand out pages that hold firmware
+    uint32_t firmwareEnd = (uint32_t)&_etext + ((uint32_t)&_erelocate - (uint32_t)&_srelocate);
+    if (firmwareEnd > REGION_ADDRESS) {
+        available = false;
+        return false;
+    }
+    base = (const uint8_t*)REGION_ADDRESS;
+#else
+    if (!g_regionErased) {
+        memset(g_region, 0xFF, sizeof(g_region));
+        g_regionErased = true;
+    }
+    base = (const uint8_t*)g_region;
+#endif
+
+    available = true;
+    writing = false;
+    return scan();
+}
+
+uint32_t ImageStore::recordSize(uint16_t width, uint16_t height) {
+    uint32_t bytes = HEADER_SIZE + (uint32_t)width * height * 2;
+    return (bytes + PAGE_SIZE - 1) / PAGE_SIZE * PAGE_SIZE;
+}
+
+bool ImageStore::scan() {
+    imageCount = 0;
+    liveBytes = 0;
+    writeOffset = 0;
+
+    // The log ends at the first page that does not start with a complete record
+    while (writeOffset + HEADER_SIZE <= IMAGE_STORE_SIZE) {
+        const ImageRecord* record = (const ImageRecord*)at(writeOffset);
+        if (record->magic != ImageRecord::MAGIC || record->id[ImageRecord::MAX_ID_LENGTH] != '\0') {
+            break;
+        }
+        uint32_t size = recordSize(record->width, record->height);
+        if (writeOffset + size > IMAGE_STORE_SIZE) {
+            break;
+        }
+        indexRecord(record);
+        writeOffset += size;
+    }
+    return ensureErased(writeOffset);
+}
+
+void ImageStore::indexRecord(const ImageRecord* record) {
+    bool tombstone = record->width == 0 || record->height == 0;
+
+    // A later record for the same id supersedes the earlier one
+    for (uint8_t i = 0; i < imageCount; i++) {
+        if (strcmp(images[i].getId(), record->id) != 0) {
+            continue;
+        }
+        liveBytes -= recordSize(images[i].getWidth(), images[i].getHeight());
+        if (tombstone) {
+            imageCount--;
+            for (uint8_t j = i; j < imageCount; j++) {
+                images[j] = images[j + 1];
+            }
+        } else {
+            images[i].record = record;
+            images[i].pixels = (const uint16_t*)((const uint8_t*)record + HEADER_SIZE);
+            liveBytes += recordSize(record->width, record->height);
+        }
+        return;
+    }
+
+    if (tombstone || imageCount >= MAX_IMAGES) {
+        return;
+    }
+    images[imageCount].record = record;
+    images[imageCount].pixels = (const uint16_t*)((const uint8_t*)record + HEADER_SIZE);
+    imageCount++;
+    liveBytes += recordSize(record->width, record->height);
+}
+
+const StoredImage* ImageStore::find(const char* id) const {
+    for (uint8_t i = 0; i < imageCount; i++) {
+        if (strcmp(images[i].getId(), id) == 0) {
+            return &images[i];
+        }
+    }
+    return nullptr;
+}
+
+const StoredImage* ImageStore::getImage(uint8_t index) const {
+    return index < imageCount ? &images[index] : nullptr;
+}
+
+uint32_t ImageStore::getFreeBytes() const {
+    return available ? IMAGE_STORE_SIZE - liveBytes : 0;
+}
+
+bool ImageStore::programPage(uint32_t offset, const uint32_t* data) {
+#if IMAGE_STORE_FLASH
+    // Fill the EFC latch buffer through the page's own addresses, then erase and
+    // write the page in one command. The store lives in bank 1 and the firmware
+    // runs from bank 0, so code fetches continue while the page is programmed.
+    volatile uint32_t* latch = (volatile uint32_t*)(REGION_ADDRESS + offset);
+    uint32_t page = (REGION_ADDRESS + offset - IFLASH1_ADDR) / IFLASH1_PAGE_SIZE;
+
+    for (int attempt = 0; attempt < 2; attempt++) {
+        for (uint32_t i = 0; i < PAGE_SIZE / 4; i++) {
+            latch[i] = data[i];
+        }
+        if (efc_perform_command(EFC1, EFC_FCMD_EWP, page) == EFC_RC_OK) {
+            return true;
+        }
+        // Lock regions survive a firmware upload; unlock this one and retry
+        efc_perform_command(EFC1, EFC_FCMD_CLB, page);
+    }
+    return false;
+#else
+    memcpy(&g_region[offset / 4], data, PAGE_SIZE);
+    return true;
+#endif
+}
+
+bool ImageStore::erasePage(uint32_t offset) {
+    uint32_t erased[PAGE_SIZE / 4];
+    memset(erased, 0xFF, sizeof(erased));
+    return programPage(offset, erased);
+}
+
+bool ImageStore::ensureErased(uint32_t offset) {
+    // Keeps the page after the last record from looking like the start of one
+    if (offset + HEADER_SIZE > IMAGE_STORE_SIZE || *(const uint32_t*)at(offset) == ERASED_WORD) {
+        return true;
+    }
+    return erasePage(offset);
+}
+
+bool ImageStore::compact() {
+    // Slide every indexed record down over superseded records and tombstones.
+    // Records only ever move towards the start, so copying page by page in
+    // ascending order never overwrites a page that is still to be read.
+    uint32_t source = 0;
+    uint32_t dest = 0;
+
+    while (source < writeOffset) {
+        const ImageRecord* record = (const ImageRecord*)at(source);
+        uint32_t size = recordSize(record->width, record->height);
+
+        bool live = false;
+        for (uint8_t i = 0; i < imageCount; i++) {
+            if (images[i].record == record) {
+                live = true;
+                break;
+            }
+        }
+
+        if (live) {
+            if (dest != source) {
+                for (uint32_t page = 0; page < size; page += PAGE_SIZE) {
+                    memcpy(pageBuffer, at(source + page), PAGE_SIZE);
+                    if (!programPage(dest + page, pageBuffer)) {
+                        scan();
+                        return false;
+                    }
+                }
+            }
+            dest += size;
+        }
+        source += size;
+    }
+
+    // Pages past the new end may still hold moved or dead records
+    if (dest < writeOffset && !erasePage(dest)) {
+        return false;
+    }
+    return scan();
+}
+
+bool ImageStore::reserve(uint32_t size) {
+    if (writeOffset + size <= IMAGE_STORE_SIZE) {
+        return true;
+    }
+    if (liveBytes + size > IMAGE_STORE_SIZE) {
+        return false;
+    }
+    return compact() && writeOffset + size <= IMAGE_STORE_SIZE;
+}
+
+bool ImageStore::beginImage(const char* id, uint16_t width, uint16_t height) {
+    if (!available || writing || width == 0 || height == 0) {
+        return false;
+    }
+    size_t idLength = strlen(id);
+    if (idLength == 0 || idLength > ImageRecord::MAX_ID_LENGTH) {
+        return false;
+    }
+    if (!find(id) && imageCount >= MAX_IMAGES) {
+        return false;
+    }
+    if (!reserve(recordSize(width, height))) {
+        return false;
+    }
+
+    // Unused header bytes stay erased
+    memset(&pendingHeader, 0xFF, sizeof(pendingHeader));
+    pendingHeader.magic = ImageRecord::MAGIC;
+    memset(pendingHeader.id, 0, sizeof(pendingHeader.id));
+    memcpy(pendingHeader.id, id, idLength);
+    pendingHeader.width = width;
+    pendingHeader.height = height;
+
+    pendingOffset = writeOffset;
+    pendingBytes = (uint32_t)width * height * 2;
+    pageOffset = writeOffset;
+    pageFill = HEADER_SIZE;  // The header is filled in by commitImage()
+    writing = true;
+    return true;
+}
+
+bool ImageStore::flushPage() {
+    if (pageOffset == pendingOffset) {
+        // First page carries the header: hold it back until the record is complete
+        memcpy(firstPage, pageBuffer, PAGE_SIZE);
+    } else if (!programPage(pageOffset, pageBuffer)) {
+        abortImage();
+        return false;
+    }
+    pageOffset += PAGE_SIZE;
+    pageFill = 0;
+    return true;
+}
+
+bool ImageStore::appendPixels(const uint16_t* pixels, uint16_t count) {
+    uint32_t remaining = (uint32_t)count * 2;
+    if (!writing || remaining > pendingBytes) {
+        return false;
+    }
+
+    const uint8_t* src = (const uint8_t*)pixels;
+    while (remaining > 0) {
+        uint32_t chunk = PAGE_SIZE - pageFill;
+        if (chunk > remaining) {
+            chunk = remaining;
+        }
+        memcpy((uint8_t*)pageBuffer + pageFill, src, chunk);
+        src += chunk;
+        remaining -= chunk;
+        pendingBytes -= chunk;
+        pageFill += chunk;
+
+        if (pageFill == PAGE_SIZE && !flushPage()) {
+            return false;
+        }
+    }
+    return true;
+}
+
+bool ImageStore::appendRun(uint16_t value, uint16_t count) {
+    if (!writing || (uint32_t)count * 2 > pendingBytes) {
+        return false;
+    }
+
+    uint16_t* page = (uint16_t*)pageBuffer;
+    while (count-- > 0) {
+        page[pageFill / 2] = value;
+        pageFill += 2;
+        pendingBytes -= 2;
+
+        if (pageFill == PAGE_SIZE && !flushPage()) {
+            return false;
+        }
+    }
+    return true;
+}
+
+bool ImageStore::commitImage() {
+    if (!writing || pendingBytes != 0) {
+        abortImage();
+        return false;
+    }
+
+    // Pad and write out the last page
+    if (pageFill > 0) {
+        memset((uint8_t*)pageBuffer + pageFill, 0xFF, PAGE_SIZE - pageFill);
+        if (!flushPage()) {
+            return false;
+        }
+    }
+
+    // Terminate the log behind the record before the header makes it visible
+    uint32_t end = pageOffset;
+    if (!ensureErased(end)) {
+        abortImage();
+        return false;
+    }
+
+    memcpy(firstPage, &pendingHeader, HEADER_SIZE);
+    if (!programPage(pendingOffset, firstPage)) {
+        abortImage();
+        return false;
+    }
+
+    writing = false;
+    writeOffset = end;
+    indexRecord((const ImageRecord*)at(pendingOffset));
+    return true;
+}
+
+void ImageStore::abortImage() {
+    // Pages already programmed sit behind the end of the log and are rewritten later
+    writing = false;
+}
+
+bool ImageStore::writeTombstone(const char* id) {
+    if (!reserve(PAGE_SIZE)) {
+        return false;
+    }
+    if (!ensureErased(writeOffset + PAGE_SIZE)) {
+        return false;
+    }
+
+    ImageRecord* record = (ImageRecord*)pageBuffer;
+    memset(pageBuffer, 0xFF, PAGE_SIZE);
+    record->magic = ImageRecord::MAGIC;
+    memset(record->id, 0, sizeof(record->id));
+    strncpy(record->id, id, ImageRecord::MAX_ID_LENGTH);
+    record->width = 0;
+    record->height = 0;
+
+    if (!programPage(writeOffset, pageBuffer)) {
+        return false;
+    }
+    writeOffset += PAGE_SIZE;
+    return true;
+}
+
+bool ImageStore::remove(const char* id) {
+    if (!available || writing || !find(id)) {
+        return false;
+    }
+
+    // Without room for a tombstone, compaction drops the record instead
+    if (writeOffset + PAGE_SIZE > IMAGE_STORE_SIZE) {
+        const StoredImage* image = find(id);
+        liveBytes -= recordSize(image->getWidth(), image->getHeight());
+        imageCount--;
+        for (uint8_t i = image - images; i < imageCount; i++) {
+            images[i] = images[i + 1];
+        }
+        return compact();
+    }
+
+    if (!writeTombstone(id)) {
+        return false;
+    }
+    indexRecord((const ImageRecord*)at(writeOffset - PAGE_SIZE));
+    return true;
+}
+
+bool ImageStore::eraseAll() {
+    if (!available) {
+        return false;
+    }
+    abortImage();
+
+    for (uint32_t offset = 0; offset < writeOffset; offset += PAGE_SIZE) {
+        if (!erasePage(offset)) {
+            scan();
+            return false;
+        }
+    }
+    return scan();
+}
+
+void ImageStore::listImages(Stream& serial) {
+    serial.println("Stored images:");
+    for (uint8_t i = 0; i < imageCount; i++) {
+        serial.print("  ");
+        serial.print(images[i].getId());
+        serial.print(" - ");
+        serial.print(images[i].getWidth());
+        serial.print("x");
+        serial.println(images[i].getHeight());
+    }
+    serial.print("Free: ");
+    serial.print(getFreeBytes());
+    serial.print(" of ");
+    serial.print(getCapacity());
+    serial.println(" bytes");
+}
@@ -0,0 +1,144 @@
+/*
+ * ImageStore.h
+ * Persistent store of RGB565 images in on-chip flash (Arduino Due, SAM3X8E)
+ *
+ * Images are kept in a reserved region at the top of flash bank 1 as an
+ * append-only log of records:
+ *   [ImageRecord header][width * height pixels, display (big-endian) byte order]
+ * each padded to a whole flash page. Storing an id again appends a new record
+ * that supersedes the old one; deleting appends a tombstone (zero size).
+ * An index of live images is rebuilt from the log by begin(). When the region
+ * runs out, live records are compacted towards its start before a new one is
+ * written.
+ *
+ * Flash is memory-mapped, so stored pixels are handed out as plain pointers
+ * and can be blitted (or DMA'd) straight to a panel.
+ *
+ * The record header is programmed last, so an interrupted write leaves no
+ * trace in the index (compaction, which moves records, is not power-fail
+ * safe). Uploading new firmware with a full chip erase clears the store.
+ *
+ * Define IMAGE_STORE_DISABLE_FLASH to keep the store in RAM instead (contents
+ * are lost at reset); non-SAM3X targets always do. IMAGE_STORE_SIZE sets the
+ * region size in bytes (multiple of IMAGE_STORE_PAGE_SIZE).
+ */
+
+#ifndef IMAGE_STORE_H
+#define IMAGE_STORE_H
+
+#include <Arduino.h>
+
+#if defined(__SAM3X8E__) && !defined(IMAGE_STORE_DISABLE_FLASH)
+#define IMAGE_STORE_FLASH 1
+#else
+#define IMAGE_STORE_FLASH 0
+#endif
+
+#define IMAGE_STORE_PAGE_SIZE 256       // SAM3X flash page (write unit)
+
+#ifndef IMAGE_STORE_SIZE
+#if IMAGE_STORE_FLASH
+#define IMAGE_STORE_SIZE (128UL * 1024UL)   // Top 128 KB of the 512 KB flash
+#else
+#define IMAGE_STORE_SIZE (8UL * 1024UL)
+#endif
+#endif
+
+// Record header at the start of every log entry (programmed last)
+struct ImageRecord {
+    static const uint32_t MAGIC = 0x31474D49;  // "IMG1"
+    static const uint8_t MAX_ID_LENGTH = 15;
+
+    uint32_t magic;
+    char id[MAX_ID_LENGTH + 1];
+    uint16_t width;         // 0 x 0 marks a tombstone
+    uint16_t height;
+    uint32_t reserved[2];   // Erased (0xFF); pads the header to 32 bytes
+};
+
+// Index entry for one live image
+struct StoredImage {
+    const ImageRecord* record;
+    const uint16_t* pixels;  // width * height pixels, row-major, big-endian
+
+    const char* getId() const { return record->id; }
+    uint16_t getWidth() const { return record->width; }
+    uint16_t getHeight() const { return record->height; }
+};
+
+class ImageStore {
+public:
+    static const uint8_t MAX_IMAGES = 32;
+
+    ImageStore();
+
+    // Locate the region and rebuild the index. Returns false if unavailable
+    // (for example when the firmware image reaches into the region).
+    bool begin();
+    bool isAvailable() const { return available; }
+
+    // Lookup
+    const StoredImage* find(const char* id) const;
+    const StoredImage* getImage(uint8_t index) const;
+    uint8_t getImageCount() const { return imageCount; }
+
+    // Capacity (bytes); free space counts what compaction would reclaim
+    uint32_t getCapacity() const { return IMAGE_STORE_SIZE; }
+    uint32_t getFreeBytes() const;
+
+    // Writing: beginImage(), then exactly height rows via appendPixels() /
+    // appendRun(), then commitImage(). The previous image with the same id
+    // stays visible until the commit.
+    bool beginImage(const char* id, uint16_t width, uint16_t height);
+    bool appendPixels(const uint16_t* pixels, uint16_t count);
+    bool appendRun(uint16_t value, uint16_t count);  // value in stored byte order
+    bool commitImage();
+    void abortImage();
+    bool isWriting() const { return writing; }
+
+    // Maintenance
+    bool remove(const char* id);
+    bool eraseAll();
+
+    // Utility
+    void listImages(Stream& serial);
+
+private:
+    static const uint32_t HEADER_SIZE = sizeof(ImageRecord);
+
+    static uint32_t recordSize(uint16_t width, uint16_t height);
+
+    bool scan();
+    bool compact();
+    bool reserve(uint32_t size);
+    bool writeTombstone(const char* id);
+    bool programPage(uint32_t offset, const uint32_t* data);
+    bool erasePage(uint32_t offset);
+    bool ensureErased(uint32_t offset);
+    bool flushPage();
+    void indexRecord(const ImageRecord* record);
+    const uint8_t* at(uint32_t offset) const { return base + offset; }
+
+    const uint8_t* base;            // Start of the region (memory-mapped)
+    bool available;
+    uint32_t writeOffset;           // First free byte of the log (page aligned)
+    uint32_t liveBytes;             // Bytes held by indexed records
+
+    StoredImage images[MAX_IMAGES];
+    uint8_t imageCount;
+
+    // Record being written
+    bool writing;
+    ImageRecord pendingHeader;
+    uint32_t pendingOffset;         // Region offset of the record
+    uint32_t pendingBytes;          // Pixel bytes still expected
+    uint32_t pageOffset;            // Region offset of the page being filled
+    uint16_t pageFill;              // Bytes staged in pageBuffer
+
+    // Staging for the page being filled and for the record's first page,
+    // which also carries the header and is programmed by commitImage()
+    uint32_t pageBuffer[IMAGE_STORE_PAGE_SIZE / 4];
+    uint32_t firstPage[IMAGE_STORE_PAGE_SIZE / 4];
+};
+
+#endif // IMAGE_STORE_H
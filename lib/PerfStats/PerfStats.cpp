@@ -0,0 +1,143 @@
+/*
+ * PerfStats.cpp
+ * On-device performance counters (CMD:STATS)
+ */
+
+#include "PerfStats.h"
+#include <string.h>
+
+#if defined(__SAM3X8E__)
+#include <malloc.h>
+#endif
+
+namespace PerfStats {
+
+Counters counters;
+
+static unsigned long g_resetMillis = 0;
+
+#if PERF_STATS
+static uint32_t g_stallStart = 0;
+static bool g_stalled = false;
+static uint32_t g_lastLoop = 0;
+static bool g_looping = false;
+#endif
+
+static uint32_t toMicros(uint64_t cycleCount) {
+    return (uint32_t)(cycleCount / (PERF_CPU_HZ / 1000000UL));
+}
+
+void begin() {
+#if PERF_STATS && PERF_STATS_DWT
+    CoreDebug->DEMCR |= CoreDebug_DEMCR_TRCENA_Msk;
+    DWT->CYCCNT = 0;
+    DWT->CTRL |= DWT_CTRL_CYCCNTENA_Msk;
+#endif
+    reset();
+}
+
+void reset() {
+    memset(&counters, 0, sizeof(counters));
+    counters.loopMinCycles = UINT32_MAX;
+    g_resetMillis = millis();
+#if PERF_STATS
+    g_stalled = false;
+    g_looping = false;
+#endif
+}
+
+void loopTick() {
+#if PERF_STATS
+    uint32_t now = cycles();
+    if (g_looping) {
+        uint32_t spacing = now - g_lastLoop;
+        if (spacing < counters.loopMinCycles) {
+            counters.loopMinCycles = spacing;
+        }
+        if (spacing > counters.loopMaxCycles) {
+            counters.loopMaxCycles = spacing;
+        }
+        counters.loopCycles += spacing;
+        counters.loops++;
+    }
+    g_lastLoop = now;
+    g_looping = true;
+#endif
+}
+
+void beginStall() {
+#if PERF_STATS
+    if (!g_stalled) {
+        g_stallStart = cycles();
+        g_stalled = true;
+    }
+#endif
+}
+
+void endStall() {
+#if PERF_STATS
+    if (g_stalled) {
+        uint32_t waited = cycles() - g_stallStart;
+        if (waited >= PERF_STALL_MIN_MICROS * (PERF_CPU_HZ / 1000000UL)) {
+            counters.stallCycles += waited;
+            counters.stalls++;
+        }
+        g_stalled = false;
+    }
+#endif
+}
+
+void report(Print& out) {
+    if (!PERF_STATS) {
+        out.println("ERROR:Performance counters are compiled out (PERF_DISABLE_STATS)");
+        return;
+    }
+
+    out.println("OK:STATS");
+    out.print("CpuHz:");
+    out.println((uint32_t)PERF_CPU_HZ);
+    out.print("CycleSource:");
+    out.println(PERF_STATS_DWT ? "DWT" : "micros");
+    out.print("ElapsedMs:");
+    out.println(millis() - g_resetMillis);
+    out.print("UsbBytes:");
+    out.println(counters.usbBytes);
+    out.print("ReceiveMicros:");
+    out.println(toMicros(counters.receiveCycles));
+    out.print("SpiMicros:");
+    out.println(toMicros(counters.spiCycles));
+    out.print("SpiWrites:");
+    out.println(counters.spiWrites);
+    out.print("PixelsClipped:");
+    out.println(counters.pixelsClipped);
+    out.print("Stalls:");
+    out.println(counters.stalls);
+    out.print("StallMicros:");
+    out.println(toMicros(counters.stallCycles));
+    out.print("TileNacks:");
+    out.println(counters.tileNacks);
+    out.print("Loops:");
+    out.println(counters.loops);
+    out.print("LoopMinCycles:");
+    out.println(counters.loops ? counters.loopMinCycles : 0);
+    out.print("LoopAvgCycles:");
+    out.println(counters.loops ? (uint32_t)(counters.loopCycles / counters.loops) : 0);
+    out.print("LoopMaxCycles:");
+    out.println(counters.loopMaxCycles);
+
+    // newlib only trims the heap with more than 128 KB free at the top, more than the
+    // Due's RAM, so the arena it took from sbrk() is the high-water mark
+#if defined(__SAM3X8E__)
+    struct mallinfo heap = mallinfo();
+    out.print("HeapInUse:");
+    out.println((uint32_t)heap.uordblks);
+    out.print("HeapPeak:");
+    out.println((uint32_t)heap.arena);
+#else
+    out.println("HeapInUse:0");
+    out.println("HeapPeak:0");
+#endif
+    out.println("END_STATS");
+}
+
+} // namespace PerfStats
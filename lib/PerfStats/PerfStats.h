@@ -0,0 +1,124 @@
+/*
+ * PerfStats.h
+ * On-device performance counters (CMD:STATS)
+ *
+ * Hot paths add what they do to a set of counters: bytes read from the serial
+ * port, cycles spent receiving pixels and driving the SPI bus, pixels clipped to
+ * the frame bounds, stalls waiting for pixel data, NACKed tiles and the spacing
+ * of loop() iterations. On the Arduino Due times come from the Cortex-M3 DWT
+ * cycle counter (84 MHz, one register read); elsewhere they are derived from
+ * micros().
+ * report() prints the counters as Key:Value lines between OK:STATS and END_STATS.
+ *
+ * Define PERF_DISABLE_STATS to compile the counting out.
+ */
+
+#ifndef PERF_STATS_H
+#define PERF_STATS_H
+
+#include <Arduino.h>
+
+#if defined(PERF_DISABLE_STATS)
+#define PERF_STATS 0
+#else
+#define PERF_STATS 1
+#endif
+
+#if defined(__SAM3X8E__)
+#define PERF_STATS_DWT 1
+#else
+#define PERF_STATS_DWT 0
+#endif
+
+#ifndef PERF_CPU_HZ
+#ifdef F_CPU
+#define PERF_CPU_HZ F_CPU
+#else
+#define PERF_CPU_HZ 84000000UL
+#endif
+#endif
+
+// Waits for pixel data shorter than this are the USB buffer draining between packets,
+// not stalls, and are left out of Stalls/StallMicros
+#ifndef PERF_STALL_MIN_MICROS
+#define PERF_STALL_MIN_MICROS 1000UL
+#endif
+
+namespace PerfStats {
+
+struct Counters {
+    uint32_t usbBytes;          // Bytes read from the serial port
+    uint64_t receiveCycles;     // Pixel reception, including the row blits and their SPI time
+    uint64_t spiCycles;         // Address windows, pixel pushes and DMA completion waits
+    uint32_t spiWrites;         // SPI bursts (one address window each)
+    uint32_t pixelsClipped;     // Received pixels outside the frame bounds (per display)
+    uint32_t stalls;            // Times pixel data ran out mid-rectangle for PERF_STALL_MIN_MICROS or more
+    uint64_t stallCycles;       // Time until the rest of it arrived, those waits only
+    uint32_t tileNacks;         // TILE transfers: tiles NACKed for a bad CRC, stall or gap
+    uint32_t loops;             // loop() iterations timed by loopTick()
+    uint32_t loopMinCycles;
+    uint32_t loopMaxCycles;
+    uint64_t loopCycles;
+};
+
+extern Counters counters;
+
+// Start the cycle counter and clear the counters (call once from setup())
+void begin();
+void reset();
+
+// Print every counter (times in microseconds, loop spacing in cycles)
+void report(Print& out);
+
+// Once per loop() iteration: records the time since the previous call
+void loopTick();
+
+// Pixel data ran out mid-rectangle / arrived again; endStall() counts the wait if it
+// lasted PERF_STALL_MIN_MICROS or more
+void beginStall();
+void endStall();
+
+#if PERF_STATS
+
+inline uint32_t cycles() {
+#if PERF_STATS_DWT
+    return DWT->CYCCNT;
+#else
+    return micros() * (uint32_t)(PERF_CPU_HZ / 1000000UL);
+#endif
+}
+
+inline void countBytes(uint32_t bytes) { counters.usbBytes += bytes; }
+inline void countClipped(uint32_t pixels) { counters.pixelsClipped += pixels; }
+inline void countSpiWrite() { counters.spiWrites++; }
+inline void countTileNack() { counters.tileNacks++; }
+
+// Adds the cycles spent in its scope to total
+class ScopedCycles {
+public:
+    explicit ScopedCycles(uint64_t& total) : total(total), start(cycles()) {}
+    ~ScopedCycles() { total += cycles() - start; }
+
+private:
+    uint64_t& total;
+    uint32_t start;
+};
+
+#else
+
+inline uint32_t cycles() { return 0; }
+inline void countBytes(uint32_t) {}
+inline void countClipped(uint32_t) {}
+inline void countSpiWrite() {}
+inline void countTileNack() {}
+
+class ScopedCycles {
+public:
+    explicit ScopedCycles(uint64_t&) {}
+};
+
+#endif
+
+} // namespace PerfStats
+
+#endif // PERF_STATS_H
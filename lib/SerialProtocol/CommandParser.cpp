@@ -0,0 +1,84 @@
+/*
+ * CommandParser.cpp
+ * Allocation-free tokenizer for CMD: lines
+ */
+
+#include "CommandParser.h"
+#include <ctype.h>
+#include <stdlib.h>
+#include <string.h>
+
+char* trimInPlace(char* s) {
+    while (isspace((unsigned char)*s)) {
+        s++;
+    }
+    char* end = s + strlen(s);
+    while (end > s && isspace((unsigned char)end[-1])) {
+        end--;
+    }
+    *end = '\0';
+    return s;
+}
+
+CommandTokens::CommandTokens(char* line)
+    : commandName(line), cursor(nullptr), hash(0), argsPresent(false) {
+    char* colon = strchr(line, ':');
+    if (colon) {
+        *colon = '\0';
+        cursor = colon + 1;
+        argsPresent = true;
+    }
+    hash = commandHash(commandName);
+}
+
+char* CommandTokens::next(char separator) {
+    if (!cursor) {
+        return nullptr;
+    }
+    char* field = cursor;
+    char* end = strchr(cursor, separator);
+    if (end) {
+        *end = '\0';
+        cursor = end + 1;
+    } else {
+        cursor = nullptr;
+    }
+    return field;
+}
+
+uint8_t CommandTokens::nextInts(int* values, uint8_t maxValues, char separator) {
+    uint8_t count = 0;
+    while (char* field = next(separator)) {
+        if (count == maxValues) {
+            return maxValues + 1;
+        }
+        values[count++] = atoi(field);
+    }
+    return count;
+}
+
+void ReplyCapture::begin() {
+    lineLength = 0;
+    errorKept = false;
+    error[0] = '\0';
+}
+
+size_t ReplyCapture::write(uint8_t c) {
+    if (c == '\r') {
+        return 1;
+    }
+    if (c != '\n') {
+        if (lineLength < MAX_LINE_LENGTH) {
+            line[lineLength++] = c;
+        }
+        return 1;
+    }
+
+    line[lineLength] = '\0';
+    if (!errorKept && strncmp(line, "ERROR:", 6) == 0) {
+        strcpy(error, line + 6);
+        errorKept = true;
+    }
+    lineLength = 0;
+    return 1;
+}
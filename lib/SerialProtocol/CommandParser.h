@@ -0,0 +1,77 @@
+/*
+ * CommandParser.h
+ * Allocation-free tokenizer for CMD: lines
+ *
+ * A CommandTokens splits a command line in place: the name runs up to the first
+ * ':' and everything after it are the arguments, taken one field at a time with
+ * next(). Separators are overwritten with '\0', so tokens point into the line
+ * buffer and nothing is copied or allocated. Command names are looked up by
+ * commandHash(), which is constexpr so command tables are hashed at compile time.
+ * ReplyCapture stands in for the serial port while replies must be held back.
+ */
+
+#ifndef COMMAND_PARSER_H
+#define COMMAND_PARSER_H
+
+#include <Arduino.h>
+
+// 32-bit FNV-1a of a NUL-terminated string
+constexpr uint32_t commandHash(const char* s, uint32_t hash = 2166136261UL) {
+    return *s ? commandHash(s + 1, (hash ^ (uint8_t)*s) * 16777619UL) : hash;
+}
+
+// Strip leading and trailing whitespace in place; returns the first kept character
+char* trimInPlace(char* s);
+
+class CommandTokens {
+public:
+    CommandTokens() : commandName(""), cursor(nullptr), hash(commandHash("")), argsPresent(false) {}
+    explicit CommandTokens(char* line);
+
+    const char* name() const { return commandName; }
+    uint32_t nameHash() const { return hash; }
+
+    // True if a ':' followed the name (the arguments may still be empty)
+    bool hasArgs() const { return argsPresent; }
+
+    // Arguments not yet taken by next() ("" when there are none)
+    const char* rest() const { return cursor ? cursor : ""; }
+    bool hasMore() const { return cursor != nullptr; }
+
+    // Split off the next field up to separator (or the end); nullptr once every field
+    // has been taken. An empty argument list still yields one empty field.
+    char* next(char separator = ',');
+
+    // Parse the remaining fields as integers (as String::toInt() would, "" is 0).
+    // Returns the number of fields, or maxValues + 1 if there are more than maxValues.
+    uint8_t nextInts(int* values, uint8_t maxValues, char separator = ',');
+
+private:
+    const char* commandName;
+    char* cursor;
+    uint32_t hash;
+    bool argsPresent;
+};
+
+// Print sink that swallows replies and keeps the first "ERROR:" line (without the prefix)
+class ReplyCapture : public Print {
+public:
+    static const uint8_t MAX_LINE_LENGTH = 95;
+
+    ReplyCapture() { begin(); }
+
+    void begin();
+    bool hasError() const { return errorKept; }
+    const char* getError() const { return error; }
+
+    size_t write(uint8_t c) override;
+    using Print::write;
+
+private:
+    char line[MAX_LINE_LENGTH + 1];
+    char error[MAX_LINE_LENGTH + 1];
+    uint8_t lineLength;
+    bool errorKept;
+};
+
+#endif // COMMAND_PARSER_H
@@ -4,18 +4,300 @@
  */
 
 #include "SerialProtocol.h"
+#include "PerfStats.h"
+#include "CommandParser.h"
 
-SerialProtocol::SerialProtocol(DisplayManager& displayMgr, Stream& serial)
+namespace {
+
+// CMD: command table. Names are hashed at compile time; a lookup hashes the received
+// name once and confirms the match with one strcmp().
+enum MenuCommandId : uint8_t {
+    MENU_RESET,
+    MENU_LIST,
+    MENU_INFO,
+    MENU_TEST,
+    MENU_TEST_ALL,
+    MENU_FRAME_ON,
+    MENU_FRAME_OFF,
+    MENU_SHADOW_ON,
+    MENU_SHADOW_OFF,
+    MENU_FRAME_COLOR,
+    MENU_FRAME_THICKNESS,
+    MENU_ADJUST_TOP,
+    MENU_ADJUST_BOTTOM,
+    MENU_ADJUST_LEFT,
+    MENU_ADJUST_RIGHT,
+    MENU_CALIBRATE,
+    MENU_UPDATE_CONFIG,
+    MENU_ORIENTATION,
+    MENU_THROUGHPUT,
+    MENU_STATS,
+    MENU_STATS_RESET,
+    MENU_GROUPS,
+    MENU_GROUP,
+    MENU_SNAPSHOTS,
+    MENU_REPAINT,
+    MENU_DEBUG_ON,
+    MENU_DEBUG_OFF,
+    MENU_BATCH,
+    MENU_HELP
+};
+
+enum MenuArgs : uint8_t {
+    ARGS_NONE,      // CMD:NAME
+    ARGS_REQUIRED,  // CMD:NAME:args
+    ARGS_OPTIONAL   // Either form
+};
+
+struct MenuCommand {
+    uint32_t hash;
+    const char* name;
+    MenuCommandId id;
+    MenuArgs args;
+    bool batchable;     // Allowed in CMD:BATCH (only changes state the batch can restore)
+};
+
+constexpr MenuCommand menuCommand(const char* name, MenuCommandId id, MenuArgs args,
+                                  bool batchable = false) {
+    return MenuCommand{commandHash(name), name, id, args, batchable};
+}
+
+constexpr MenuCommand MENU_COMMANDS[] = {
+    menuCommand("RESET",           MENU_RESET,           ARGS_NONE),
+    menuCommand("LIST",            MENU_LIST,            ARGS_NONE),
+    menuCommand("INFO",            MENU_INFO,            ARGS_NONE),
+    menuCommand("TEST",            MENU_TEST,            ARGS_NONE),
+    menuCommand("TEST_ALL",        MENU_TEST_ALL,        ARGS_NONE),
+    menuCommand("FRAME_ON",        MENU_FRAME_ON,        ARGS_NONE),
+    menuCommand("FRAME_OFF",       MENU_FRAME_OFF,       ARGS_NONE),
+    menuCommand("SHADOW_ON",       MENU_SHADOW_ON,       ARGS_NONE),
+    menuCommand("SHADOW_OFF",      MENU_SHADOW_OFF,      ARGS_NONE),
+    menuCommand("FRAME_COLOR",     MENU_FRAME_COLOR,     ARGS_REQUIRED, true),
+    menuCommand("FRAME_THICKNESS", MENU_FRAME_THICKNESS, ARGS_REQUIRED, true),
+    menuCommand("ADJUST_TOP",      MENU_ADJUST_TOP,      ARGS_REQUIRED, true),
+    menuCommand("ADJUST_BOTTOM",   MENU_ADJUST_BOTTOM,   ARGS_REQUIRED, true),
+    menuCommand("ADJUST_LEFT",     MENU_ADJUST_LEFT,     ARGS_REQUIRED, true),
+    menuCommand("ADJUST_RIGHT",    MENU_ADJUST_RIGHT,    ARGS_REQUIRED, true),
+    menuCommand("CALIBRATE",       MENU_CALIBRATE,       ARGS_NONE, true),
+    menuCommand("UPDATE_CONFIG",   MENU_UPDATE_CONFIG,   ARGS_REQUIRED, true),
+    menuCommand("ORIENTATION",     MENU_ORIENTATION,     ARGS_REQUIRED, true),
+    menuCommand("THROUGHPUT",      MENU_THROUGHPUT,      ARGS_NONE),
+    menuCommand("STATS",           MENU_STATS,           ARGS_NONE),
+    menuCommand("STATS_RESET",     MENU_STATS_RESET,     ARGS_NONE),
+    menuCommand("GROUPS",          MENU_GROUPS,          ARGS_NONE),
+    menuCommand("GROUP",           MENU_GROUP,           ARGS_REQUIRED),
+    menuCommand("SNAPSHOTS",       MENU_SNAPSHOTS,       ARGS_NONE),
+    menuCommand("REPAINT",         MENU_REPAINT,         ARGS_OPTIONAL),
+    menuCommand("DEBUG_ON",        MENU_DEBUG_ON,        ARGS_NONE),
+    menuCommand("DEBUG_OFF",       MENU_DEBUG_OFF,       ARGS_NONE),
+    menuCommand("BATCH",           MENU_BATCH,           ARGS_REQUIRED),
+    menuCommand("HELP",            MENU_HELP,            ARGS_NONE)
+};
+
+constexpr uint8_t MENU_COMMAND_COUNT = sizeof(MENU_COMMANDS) / sizeof(MENU_COMMANDS[0]);
+
+constexpr bool hashDiffersFrom(uint8_t i, uint8_t j) {
+    return j >= MENU_COMMAND_COUNT ||
+           (MENU_COMMANDS[i].hash != MENU_COMMANDS[j].hash && hashDiffersFrom(i, j + 1));
+}
+
+constexpr bool hashesUnique(uint8_t i = 0) {
+    return i >= MENU_COMMAND_COUNT || (hashDiffersFrom(i, i + 1) && hashesUnique(i + 1));
+}
+
+static_assert(hashesUnique(), "CMD: names must have distinct hashes");
+
+const MenuCommand* findMenuCommand(const CommandTokens& tokens) {
+    for (uint8_t i = 0; i < MENU_COMMAND_COUNT; i++) {
+        const MenuCommand& command = MENU_COMMANDS[i];
+        if (command.hash != tokens.nameHash()) {
+            continue;
+        }
+        if (strcmp(command.name, tokens.name()) != 0) {
+            return nullptr;
+        }
+        if ((command.args == ARGS_NONE && tokens.hasArgs()) ||
+            (command.args == ARGS_REQUIRED && !tokens.hasArgs())) {
+            return nullptr;
+        }
+        return &command;
+    }
+    return nullptr;
+}
+
+// Frames per second in tenths for frames started over elapsedMicros
+uint32_t frameRateTenths(uint32_t frames, unsigned long elapsedMicros) {
+    return elapsedMicros ? (uint32_t)((uint64_t)frames * 10000000ULL / elapsedMicros) : 0;
+}
+
+// CRC-16/CCITT-FALSE (poly 0x1021) of TILE packets, four bits at a time
+uint16_t crc16Update(uint16_t crc, const uint8_t* data, int length) {
+    static const uint16_t NIBBLE_TABLE[16] = {
+        0x0000, 0x1021, 0x2042, 0x3063, 0x4084, 0x50A5, 0x60C6, 0x70E7,
+        0x8108, 0x9129, 0xA14A, 0xB16B, 0xC18C, 0xD1AD, 0xE1CE, 0xF1EF
+    };
+    for (int i = 0; i < length; i++) {
+        crc = (crc << 4) ^ NIBBLE_TABLE[((crc >> 12) ^ (data[i] >> 4)) & 0x0F];
+        crc = (crc << 4) ^ NIBBLE_TABLE[((crc >> 12) ^ data[i]) & 0x0F];
+    }
+    return crc;
+}
+
+// Expand one row of Bits-per-pixel palette indices (leftmost pixel in the high bits)
+template <int Bits>
+void expandIndices(const uint8_t* packed, const uint16_t* palette, uint16_t* out, int width) {
+    const int perByte = 8 / Bits;
+    const uint8_t mask = (1 << Bits) - 1;
+    for (int x = 0; x < width; x += perByte) {
+        uint8_t byte = *packed++;
+        int count = width - x < perByte ? width - x : perByte;
+        for (int i = 0; i < count; i++) {
+            out[x + i] = palette[(byte >> (8 - Bits * (i + 1))) & mask];
+        }
+    }
+}
+
+int16_t readInt16(const uint8_t* bytes) {
+    return (int16_t)(bytes[0] | (bytes[1] << 8));
+}
+
+// Bytes taken by the DRAW: op at op[0]; 0 if it is unknown or runs past the list
+int drawOpLength(const uint8_t* op, int remaining) {
+    int length;
+    switch (op[0]) {
+        case DRAW_FILL:
+            length = 3;
+            break;
+        case DRAW_RECT:
+        case DRAW_BOX:
+        case DRAW_LINE:
+            length = 11;
+            break;
+        case DRAW_TEXT:
+            length = remaining >= 11 ? 11 + op[10] : 11;
+            break;
+        default:
+            return 0;
+    }
+    return length <= remaining ? length : 0;
+}
+
+// Draw one (validated) op; returns its length
+int drawOp(Adafruit_GFX* gfx, const uint8_t* op) {
+    switch (op[0]) {
+        case DRAW_FILL:
+            gfx->fillScreen((uint16_t)readInt16(op + 1));
+            return 3;
+        case DRAW_RECT:
+            gfx->drawRect(readInt16(op + 1), readInt16(op + 3), readInt16(op + 5), readInt16(op + 7),
+                          (uint16_t)readInt16(op + 9));
+            return 11;
+        case DRAW_BOX:
+            gfx->fillRect(readInt16(op + 1), readInt16(op + 3), readInt16(op + 5), readInt16(op + 7),
+                          (uint16_t)readInt16(op + 9));
+            return 11;
+        case DRAW_LINE:
+            gfx->drawLine(readInt16(op + 1), readInt16(op + 3), readInt16(op + 5), readInt16(op + 7),
+                          (uint16_t)readInt16(op + 9));
+            return 11;
+        default: {
+            // DRAW_TEXT; the same color twice leaves the background untouched
+            uint16_t color = (uint16_t)readInt16(op + 5);
+            uint16_t background = (uint16_t)readInt16(op + 7);
+            gfx->setCursor(readInt16(op + 1), readInt16(op + 3));
+            gfx->setTextSize(op[9]);
+            if (background == color) {
+                gfx->setTextColor(color);
+            } else {
+                gfx->setTextColor(color, background);
+            }
+            gfx->setTextWrap(false);
+            for (uint8_t i = 0; i < op[10]; i++) {
+                gfx->write(op[11 + i]);
+            }
+            gfx->setTextWrap(true);
+            return 11 + op[10];
+        }
+    }
+}
+
+// Print a value in tenths as "<whole>.<tenth>" without float formatting
+void printTenths(Print& out, uint32_t tenths) {
+    out.print(tenths / 10);
+    out.print(".");
+    out.print(tenths % 10);
+}
+
+} // namespace
+
+SerialProtocol::SerialProtocol(DisplayManager& displayMgr, Stream& serial, ImageStore* store)
     : displayManager(displayMgr)
     , serialPort(serial)
+    , imageStore(store)
     , currentState(WAITING_FOR_DISPLAY_SELECT)
     , activeDisplay(nullptr)
     , bitmapWidth(0)
     , bitmapHeight(0)
     , currentRow(0)
-    , currentCol(0)
+    , rowBytesReceived(0)
+    , rowBuffer(rowBuffers[0])
+    , rowBufferIndex(0)
     , offsetX(0)
     , offsetY(0)
+    , rectX(0)
+    , rectY(0)
+    , rectWidth(0)
+    , rectHeight(0)
+    , clipLeft(0)
+    , clipTop(0)
+    , clipRight(-1)
+    , clipBottom(-1)
+    , transferBytes(0)
+    , transferStartMicros(0)
+    , transferMicros(0)
+    , flowControlEnabled(false)
+    , deltaMode(false)
+    , rleEnabled(false)
+    , rlePacketIsRun(false)
+    , rlePacketPixels(0)
+    , rlePacketBytes(0)
+    , rowIsFlat(false)
+    , bitsPerPixel(16)
+    , paletteBytesReceived(0)
+    , paletteNextState(RECEIVING_DATA)
+    , fillY(0)
+    , fillRows(0)
+    , fillColor(0)
+    , multiSlotCount(0)
+    , multiSlot(0)
+    , multiRowsRemaining(0)
+    , multiPreviousDisplay(nullptr)
+    , multiPreviousGroup(nullptr)
+    , activeGroup(nullptr)
+    , streamActive(false)
+    , streamFps(0)
+    , streamInterval(0)
+    , streamDue(0)
+    , streamFirstStart(0)
+    , streamLastStart(0)
+    , streamReportStart(0)
+    , streamFrames(0)
+    , streamReportFrames(0)
+    , streamLateFrames(0)
+    , streamRectsRemaining(0)
+    , streamFrameHeld(false)
+    , tilesEnabled(false)
+    , tileColumns(0)
+    , tileCount(0)
+    , tileSeq(0)
+    , tileCrc(0)
+    , tileBytesReceived(0)
+    , drawBytesExpected(0)
+    , drawBytesReceived(0)
+    , snapshotRequested(false)
+    , frameRotation(NO_FRAME_ROTATION)
+    , lineLength(0)
+    , lineOverflow(false)
     , lastActivity(0)
     , imageFrameEnabled(true)
     , imageFrameColor(ST77XX_WHITE)
@@ -23,741 +305,2725 @@ SerialProtocol::SerialProtocol(DisplayManager& displayMgr, Stream& serial)
     , usableAreaAdjustTop(0)
     , usableAreaAdjustBottom(0)
     , usableAreaAdjustLeft(0)
-    , usableAreaAdjustRight(0) {
+    , usableAreaAdjustRight(0)
+    , binaryStatus(false)
+    , debugText(false)
+    , batchActive(false)
+    , batchRedraw(false)
+    , batchRepaint(false) {
 }
 
 void SerialProtocol::process() {
-    if (!serialPort.available()) {
-        return;
-    }
-    
-    lastActivity = millis();
-    
-    switch (currentState) {
-        case WAITING_FOR_DISPLAY_SELECT:
-            handleDisplaySelect();
-            break;
-            
-        case WAITING_FOR_START:
-            handleStart();
-            break;
-            
-        case WAITING_FOR_SIZE:
-            handleSize();
-            break;
-            
-        case RECEIVING_DATA:
-            handleDataReception();
-            break;
-            
-        case WAITING_FOR_END:
-            handleEnd();
-            break;
-            
-        case BITMAP_COMPLETE:
-            handleComplete();
-            break;
-    }
-}
-
-void SerialProtocol::handleDisplaySelect() {
-    unsigned long startTime = millis();
-    String displayName = "";
-    
-    // Give a short time for a command to arrive
-    while (serialPort.available() || (millis() - startTime < DISPLAY_SELECT_TIMEOUT)) {
-        if (serialPort.available()) {
-            String command = serialPort.readStringUntil('\n');
-            command.trim();
-            
-            // Handle CMD: commands
-            if (command.startsWith("CMD:")) {
-                handleMenuCommand(command.substring(4));
-                return;
-            }
-            
-            // Handle RESET command
-            if (command == "RESET") {
-                reset();
-                serialPort.println("Protocol reset");
-                return;
-            }
-            
-            // Handle FRAME commands
-            if (command.startsWith("FRAME:")) {
-                String frameCmd = command.substring(6);
+    // Consume whatever has arrived and return; nothing here waits for more input.
+    // Text states assemble their line across calls, pixel states take bytes as they come.
+    while (serialPort.available()) {
+        lastActivity = millis();
+        
+        switch (currentState) {
+            case RECEIVING_PALETTE:
+                handlePaletteReception();
+                continue;
                 
-                if (frameCmd == "ON") {
-                    imageFrameEnabled = true;
-                    serialPort.println("Frame enabled");
-                } else if (frameCmd == "OFF") {
-                    imageFrameEnabled = false;
-                    serialPort.println("Frame disabled");
-                } else if (frameCmd.startsWith("COLOR:")) {
-                    // Parse color value (e.g., "COLOR:31" for blue)
-                    String colorStr = frameCmd.substring(6);
-                    imageFrameColor = colorStr.toInt();
-                    serialPort.print("Frame color set to: ");
-                    serialPort.println(imageFrameColor);
-                } else if (frameCmd.startsWith("THICKNESS:")) {
-                    // Parse thickness value (e.g., "THICKNESS:2")
-                    String thickStr = frameCmd.substring(10);
-                    imageFrameThickness = thickStr.toInt();
-                    serialPort.print("Frame thickness set to: ");
-                    serialPort.println(imageFrameThickness);
-                }
-                return;
-            }
-            
-            // Handle DISPLAY: command (bitmap protocol)
-            if (command.startsWith("DISPLAY:")) {
-                displayName = command.substring(8);
-                displayName.trim();
+            case RECEIVING_DATA:
+                handleDataReception();
+                continue;
                 
-                // Look up display by name
-                activeDisplay = displayManager.getDisplay(displayName.c_str());
+            case WAITING_FOR_ROW_TAG:
+                handleRowTag();
+                continue;
                 
-                if (activeDisplay) {
-                    serialPort.print("DISPLAY_READY:");
-                    serialPort.println(displayName);
-                    currentState = WAITING_FOR_START;
-                    lastActivity = millis();
-                    return;
-                } else {
-                    sendError("Display not found: " + displayName);
-                    return;
+            case WAITING_FOR_TILE:
+                handleTileStream();
+                continue;
+                
+            case WAITING_FOR_TILE_CRC:
+                handleTileCrc();
+                continue;
+                
+            case RECEIVING_DRAW_LIST:
+                handleDrawReception();
+                continue;
+                
+            case BITMAP_COMPLETE:
+                handleComplete();
+                continue;
+                
+            case WAITING_FOR_FRAME:
+                // A frame read before its slot waits in the line buffer with its pixels
+                // unread; the host waits on credits meanwhile
+                if (streamFrameHeld) {
+                    if (!streamFrameDue()) {
+                        return;
+                    }
+                    streamFrameHeld = false;
+                    handleStreamFrame(String(lineBuffer));
+                    continue;
                 }
-            }
+                break;
+                
+            default:
+                break;
         }
-        delay(10);
-    }
-    
-    // Timeout waiting for display selection
-    if (displayName.length() == 0) {
-        serialPort.println("Ready for next bitmap");
-    }
-}
-
-void SerialProtocol::handleMenuCommand(const String& command) {
-    // Handle menu/control commands (CMD: prefix already stripped)
-    String cmd = command;
-    cmd.trim();
-    
-    if (cmd == "RESET") {
-        // Reset protocol state
-        reset();
-        serialPort.println("OK:Protocol reset");
-        
-    } else if (cmd == "LIST") {
-        // List all registered displays
-        serialPort.println("OK:DISPLAY_LIST");
-        int count = displayManager.getDisplayCount();
-        serialPort.print("Count:");
-        serialPort.println(count);
         
-        // Use DisplayManager's listDisplays method
-        displayManager.listDisplays(serialPort);
-        
-        serialPort.println("END_LIST");
-        
-    } else if (cmd == "INFO") {
-        // Show active display info
-        if (!activeDisplay) {
-            serialPort.println("ERROR:No active display selected");
+        if (!readLine()) {
             return;
         }
+        char* line = trimInPlace(lineBuffer);
         
-        const DisplayConfig& cfg = activeDisplay->getConfig();
-        serialPort.println("OK:DISPLAY_INFO");
-        serialPort.print("Name:");
-        serialPort.println(cfg.name);
-        serialPort.print("Resolution:");
-        serialPort.print(cfg.usableWidth);
-        serialPort.print("x");
-        serialPort.println(cfg.usableHeight);
-        serialPort.print("Rotation:");
-        serialPort.println(cfg.rotation);
-        serialPort.print("FrameEnabled:");
-        serialPort.println(imageFrameEnabled ? "Yes" : "No");
-        serialPort.print("FrameColor:");
-        serialPort.println(imageFrameColor);
-        serialPort.print("FrameThickness:");
-        serialPort.println(imageFrameThickness);
-        serialPort.print("UsableAreaAdjustTop:");
-        serialPort.println(usableAreaAdjustTop);
-        serialPort.print("UsableAreaAdjustBottom:");
-        serialPort.println(usableAreaAdjustBottom);
-        serialPort.print("UsableAreaAdjustLeft:");
-        serialPort.println(usableAreaAdjustLeft);
-        serialPort.print("UsableAreaAdjustRight:");
-        serialPort.println(usableAreaAdjustRight);
-        serialPort.print("CenterX:");
-        serialPort.println(cfg.centerX);
-        serialPort.print("CenterY:");
-        serialPort.println(cfg.centerY);
-        serialPort.println("END_INFO");
-        
-    } else if (cmd == "TEST") {
-        // Test active display
-        if (!activeDisplay) {
-            serialPort.println("ERROR:No active display selected");
+        // Only the start of a frame is paced: commands and STREAM_END are handled now
+        if (currentState == WAITING_FOR_FRAME && strncmp(line, "FRAME", 5) == 0 &&
+            !streamFrameDue()) {
+            memmove(lineBuffer, line, strlen(line) + 1);
+            streamFrameHeld = true;
             return;
         }
         
-        serialPort.print("OK:Testing display ");
-        serialPort.println(activeDisplay->getName());
-        activeDisplay->showTestPattern();
-        serialPort.println("Test pattern displayed");
-        
-    } else if (cmd == "TEST_ALL") {
-        // Test all displays
-        serialPort.println("OK:Testing all displays");
-        displayManager.showAllTestPatterns();
-        serialPort.println("All test patterns displayed");
-        
-    } else if (cmd == "FRAME_ON") {
-        // Enable frame on active display
-        if (!activeDisplay) {
-            serialPort.println("ERROR:No active display selected");
-            return;
+        // CMD: lines are handled straight from the line buffer, without a String
+        if (strncmp(line, "CMD:", 4) == 0 &&
+            (currentState == WAITING_FOR_DISPLAY_SELECT || currentState == WAITING_FOR_START ||
+             currentState == WAITING_FOR_RECT || currentState == WAITING_FOR_FRAME)) {
+            handleMenuCommand(line + 4);
+            continue;
         }
         
-        activeDisplay->enableImageFrame(true, imageFrameColor, imageFrameThickness,
-                                       usableAreaAdjustTop, usableAreaAdjustBottom,
-                                       usableAreaAdjustLeft, usableAreaAdjustRight);
-        imageFrameEnabled = true;
-        serialPort.println("OK:Frame enabled");
+        String command(line);
         
-    } else if (cmd == "FRAME_OFF") {
-        // Disable frame on active display
-        if (!activeDisplay) {
-            serialPort.println("ERROR:No active display selected");
-            return;
+        switch (currentState) {
+            case WAITING_FOR_DISPLAY_SELECT:
+                handleDisplaySelect(command);
+                break;
+                
+            case WAITING_FOR_START:
+                handleStart(command);
+                break;
+                
+            case WAITING_FOR_SIZE:
+                handleSize(command);
+                break;
+                
+            case WAITING_FOR_RECT:
+                handleRect(command);
+                break;
+                
+            case WAITING_FOR_END:
+                handleEnd(command);
+                break;
+                
+            case WAITING_FOR_FRAME:
+                handleStreamFrame(command);
+                break;
+                
+            default:
+                break;
         }
-        
-        activeDisplay->enableImageFrame(false);
-        imageFrameEnabled = false;
-        serialPort.println("OK:Frame disabled");
-        
-    } else if (cmd.startsWith("FRAME_COLOR:")) {
-        // Set frame color
-        if (!activeDisplay) {
-            serialPort.println("ERROR:No active display selected");
-            return;
+    }
+}
+
+bool SerialProtocol::readLine() {
+    // Take bytes up to and including the next '\n' only: pixel data may follow it
+    while (serialPort.available()) {
+        char c = serialPort.read();
+        PerfStats::countBytes(1);
+        if (c == '\n') {
+            bool complete = !lineOverflow;
+            lineBuffer[lineLength] = '\0';
+            lineLength = 0;
+            lineOverflow = false;
+            if (!complete) {
+                serialPort.print("ERROR:Line longer than ");
+                serialPort.print(MAX_LINE_LENGTH);
+                serialPort.println(" characters ignored");
+            }
+            return complete;
         }
-        
-        String colorStr = cmd.substring(12);
-        uint16_t color = colorStr.toInt();
-        imageFrameColor = color;
-        imageFrameEnabled = true;
-        serialPort.print("OK:Frame color set to ");
-        serialPort.println(color);
-        
-        // Immediately update display with new color
-        activeDisplay->drawCalibrationFrame(usableAreaAdjustTop, usableAreaAdjustBottom,
-                                           usableAreaAdjustLeft, usableAreaAdjustRight,
-                                           color, imageFrameThickness);
-        
-    } else if (cmd.startsWith("FRAME_THICKNESS:")) {
-        // Set frame thickness
-        if (!activeDisplay) {
-            serialPort.println("ERROR:No active display selected");
-            return;
+        if (lineLength < MAX_LINE_LENGTH) {
+            lineBuffer[lineLength++] = c;
+        } else {
+            lineOverflow = true;
         }
-        
-        String thickStr = cmd.substring(16);
-        int thickness = thickStr.toInt();
-        
-        if (thickness < 1 || thickness > 10) {
-            serialPort.println("ERROR:Thickness must be between 1 and 10");
+    }
+    return false;
+}
+
+void SerialProtocol::handleDisplaySelect(const String& command) {
+    String displayName;
+    
+    // Handle RESET command
+    if (command == "RESET") {
+        reset();
+        serialPort.println("Protocol reset");
+        return;
+    }
+    
+    // Handle FRAME commands
+    if (command.startsWith("FRAME:")) {
+        String frameCmd = command.substring(6);
+        
+        if (frameCmd == "ON") {
+            imageFrameEnabled = true;
+            serialPort.println("Frame enabled");
+        } else if (frameCmd == "OFF") {
+            imageFrameEnabled = false;
+            serialPort.println("Frame disabled");
+        } else if (frameCmd.startsWith("COLOR:")) {
+            // Parse color value (e.g., "COLOR:31" for blue)
+            String colorStr = frameCmd.substring(6);
+            imageFrameColor = colorStr.toInt();
+            serialPort.print("Frame color set to: ");
+            serialPort.println(imageFrameColor);
+        } else if (frameCmd.startsWith("THICKNESS:")) {
+            // Parse thickness value (e.g., "THICKNESS:2")
+            String thickStr = frameCmd.substring(10);
+            imageFrameThickness = thickStr.toInt();
+            serialPort.print("Frame thickness set to: ");
+            serialPort.println(imageFrameThickness);
+        }
+        return;
+    }
+    
+    // Handle MULTI: command (multi-display bitmap transfer)
+    if (command.startsWith("MULTI:")) {
+        handleMulti(command.substring(6));
+        return;
+    }
+    
+    // Handle STREAM: command (animation session)
+    if (command.startsWith("STREAM:")) {
+        handleStream(command.substring(7));
+        return;
+    }
+    
+    // Handle IMG: commands (flash image store)
+    if (command.startsWith("IMG:")) {
+        handleImageCommand(command.substring(4));
+        return;
+    }
+    
+    // Handle DISPLAY:GROUP: command (mirrored bitmap)
+    if (command.startsWith("DISPLAY:GROUP:")) {
+        displayName = command.substring(14);
+        displayName.trim();
+        
+        activeGroup = displayManager.getGroup(displayName.c_str());
+        if (activeGroup && activeGroup->memberCount > 0) {
+            activeDisplay = activeGroup->members[0];
+            serialPort.print("DISPLAY_READY:GROUP:");
+            serialPort.println(displayName);
+            currentState = WAITING_FOR_START;
+            lastActivity = millis();
+            return;
+        } else {
+            activeGroup = nullptr;
+            sendError("Display group not found: " + displayName);
             return;
         }
-        
-        imageFrameThickness = thickness;
-        imageFrameEnabled = true;
-        serialPort.print("OK:Frame thickness set to ");
-        serialPort.println(thickness);
-        
-        // Immediately update display with new thickness
-        activeDisplay->drawCalibrationFrame(usableAreaAdjustTop, usableAreaAdjustBottom,
-                                           usableAreaAdjustLeft, usableAreaAdjustRight,
-                                           imageFrameColor, thickness);
-        
-    } else if (cmd.startsWith("ADJUST_TOP:")) {
-        // Adjust usable area top edge
-        if (!activeDisplay) {
-            serialPort.println("ERROR:No active display selected");
+    }
+    
+    // Handle DISPLAY: command (bitmap protocol)
+    if (command.startsWith("DISPLAY:")) {
+        displayName = command.substring(8);
+        displayName.trim();
+        
+        // Look up display by name
+        activeGroup = nullptr;
+        activeDisplay = displayManager.getDisplay(displayName.c_str());
+        
+        if (activeDisplay) {
+            serialPort.print("DISPLAY_READY:");
+            serialPort.println(displayName);
+            currentState = WAITING_FOR_START;
+            lastActivity = millis();
+            return;
+        } else {
+            sendError("Display not found: " + displayName);
             return;
         }
+    }
+}
+
+void SerialProtocol::handleMenuCommand(char* command) {
+    // Handle menu/control commands (CMD: prefix already stripped). The line is split
+    // in place and looked up by hash, so no String is built on this path.
+    CommandTokens tokens(trimInPlace(command));
+    const MenuCommand* spec = findMenuCommand(tokens);
+    if (!spec) {
+        serialPort.print("ERROR:Unknown command: ");
+        serialPort.print(tokens.name());
+        if (tokens.hasArgs()) {
+            serialPort.print(":");
+            serialPort.print(tokens.rest());
+        }
+        serialPort.println();
+        return;
+    }
+    
+    runMenuCommand(spec->id, tokens);
+}
+
+void SerialProtocol::runMenuCommand(uint8_t id, CommandTokens& tokens) {
+    // Inside CMD:BATCH replies are held back; runBatch() answers once for the batch
+    Print& reply = batchActive ? static_cast<Print&>(batchReply) : static_cast<Print&>(serialPort);
+    
+    switch (id) {
+        case MENU_RESET: {
+            // Reset protocol state
+            reset();
+            reply.println("OK:Protocol reset");
+            break;
+        }
         
-        String adjustStr = cmd.substring(11);
-        int8_t adjust = adjustStr.toInt();
-        
-        const DisplayConfig& cfg = activeDisplay->getConfig();
-        // Top is inverted: positive adjustment moves edge UP (decreases Y)
-        int newTop = cfg.usableY - adjust;
-        
-        // Inner bound: center - 10 pixels
-        // Outer bound: -10 pixels (10 pixels beyond published top edge)
-        int innerBound = cfg.centerY - 10;
-        int outerBound = -10;
+        case MENU_LIST: {
+            // List all registered displays
+            reply.println("OK:DISPLAY_LIST");
+            int count = displayManager.getDisplayCount();
+            reply.print("Count:");
+            reply.println(count);
+            
+            // Use DisplayManager's listDisplays method
+            displayManager.listDisplays(serialPort);
+            
+            reply.println("END_LIST");
+            break;
+        }
         
-        if (newTop < outerBound) {
-            serialPort.print("ERROR:Top edge would be beyond limit (maximum adjustment: ");
-            serialPort.print(cfg.usableY - outerBound);
-            serialPort.println(")");
-            return;
+        case MENU_INFO: {
+            // Show active display info
+            if (!activeDisplay) {
+                reply.println("ERROR:No active display selected");
+                return;
+            }
+            
+            const DisplayConfig& cfg = activeDisplay->getConfig();
+            reply.println("OK:DISPLAY_INFO");
+            reply.print("Name:");
+            reply.println(cfg.name);
+            reply.print("Resolution:");
+            reply.print(cfg.usableWidth);
+            reply.print("x");
+            reply.println(cfg.usableHeight);
+            reply.print("Rotation:");
+            reply.println(cfg.rotation);
+            reply.print("FrameEnabled:");
+            reply.println(imageFrameEnabled ? "Yes" : "No");
+            reply.print("FrameColor:");
+            reply.println(imageFrameColor);
+            reply.print("FrameThickness:");
+            reply.println(imageFrameThickness);
+            reply.print("Shadow:");
+            reply.println(activeDisplay->isShadowEnabled() ? "Yes" : "No");
+            reply.print("Bus:");
+            reply.println(activeDisplay->getBusName());
+            reply.print("SpiClock:");
+            reply.println(activeDisplay->getBusClock());
+            reply.print("UsableAreaAdjustTop:");
+            reply.println(usableAreaAdjustTop);
+            reply.print("UsableAreaAdjustBottom:");
+            reply.println(usableAreaAdjustBottom);
+            reply.print("UsableAreaAdjustLeft:");
+            reply.println(usableAreaAdjustLeft);
+            reply.print("UsableAreaAdjustRight:");
+            reply.println(usableAreaAdjustRight);
+            reply.print("CenterX:");
+            reply.println(cfg.centerX);
+            reply.print("CenterY:");
+            reply.println(cfg.centerY);
+            reply.println("END_INFO");
+            break;
         }
         
-        if (newTop > innerBound) {
-            serialPort.print("ERROR:Top edge would be past center-10 (minimum adjustment: ");
-            serialPort.print(cfg.usableY - innerBound);
-            serialPort.println(")");
-            return;
+        case MENU_TEST: {
+            // Test active display
+            if (!activeDisplay) {
+                reply.println("ERROR:No active display selected");
+                return;
+            }
+            
+            reply.print("OK:Testing display ");
+            reply.println(activeDisplay->getName());
+            activeDisplay->showTestPattern();
+            reply.println("Test pattern displayed");
+            break;
         }
         
-        usableAreaAdjustTop = adjust;
-        serialPort.print("OK:Top edge adjusted to ");
-        serialPort.println(adjust);
+        case MENU_TEST_ALL: {
+            // Test all displays
+            reply.println("OK:Testing all displays");
+            displayManager.showAllTestPatterns();
+            reply.println("All test patterns displayed");
+            break;
+        }
         
-        // Notify if at outer limit
-        if (newTop <= -10) {
-            serialPort.println("NOTICE:Top edge at maximum outward position (-10 pixels beyond display)");
+        case MENU_FRAME_ON: {
+            // Enable frame on active display
+            if (!activeDisplay) {
+                reply.println("ERROR:No active display selected");
+                return;
+            }
+            
+            activeDisplay->enableImageFrame(true, imageFrameColor, imageFrameThickness,
+                                           usableAreaAdjustTop, usableAreaAdjustBottom,
+                                           usableAreaAdjustLeft, usableAreaAdjustRight);
+            imageFrameEnabled = true;
+            reply.println("OK:Frame enabled");
+            break;
         }
         
-        // Immediately update display
-        activeDisplay->drawCalibrationFrame(usableAreaAdjustTop, usableAreaAdjustBottom,
-                                           usableAreaAdjustLeft, usableAreaAdjustRight,
-                                           imageFrameColor, imageFrameThickness);
+        case MENU_FRAME_OFF: {
+            // Disable frame on active display
+            if (!activeDisplay) {
+                reply.println("ERROR:No active display selected");
+                return;
+            }
+            
+            activeDisplay->enableImageFrame(false);
+            imageFrameEnabled = false;
+            reply.println("OK:Frame disabled");
+            break;
+        }
         
-    } else if (cmd.startsWith("ADJUST_BOTTOM:")) {
-        // Adjust usable area bottom edge
-        if (!activeDisplay) {
-            serialPort.println("ERROR:No active display selected");
-            return;
+        case MENU_SHADOW_ON:
+        case MENU_SHADOW_OFF: {
+            // Shadow framebuffer on the active display (clears the screen when enabled)
+            if (!activeDisplay) {
+                reply.println("ERROR:No active display selected");
+                return;
+            }
+            
+            bool enable = id == MENU_SHADOW_ON;
+            if (!activeDisplay->enableShadow(enable)) {
+                reply.println("ERROR:Not enough RAM for a shadow framebuffer");
+                return;
+            }
+            reply.println(enable ? "OK:Shadow framebuffer enabled" : "OK:Shadow framebuffer disabled");
+            break;
         }
         
-        String adjustStr = cmd.substring(14);
-        int8_t adjust = adjustStr.toInt();
+        case MENU_FRAME_COLOR: {
+            // Set frame color
+            if (!activeDisplay) {
+                reply.println("ERROR:No active display selected");
+                return;
+            }
+            
+            uint16_t color = atoi(tokens.rest());
+            imageFrameColor = color;
+            imageFrameEnabled = true;
+            reply.print("OK:Frame color set to ");
+            reply.println(color);
+            
+            // Immediately update display with new color
+            redrawCalibrationFrame();
+            break;
+        }
         
-        const DisplayConfig& cfg = activeDisplay->getConfig();
-        int configBottom = cfg.usableY + cfg.usableHeight - 1;
-        int newBottom = configBottom + adjust;
+        case MENU_FRAME_THICKNESS: {
+            // Set frame thickness
+            if (!activeDisplay) {
+                reply.println("ERROR:No active display selected");
+                return;
+            }
+            
+            int thickness = atoi(tokens.rest());
+            
+            if (thickness < 1 || thickness > 10) {
+                reply.println("ERROR:Thickness must be between 1 and 10");
+                return;
+            }
+            
+            imageFrameThickness = thickness;
+            imageFrameEnabled = true;
+            reply.print("OK:Frame thickness set to ");
+            reply.println(thickness);
+            
+            // Immediately update display with new thickness
+            redrawCalibrationFrame();
+            break;
+        }
         
-        // Inner bound: center + 10 pixels
-        // Outer bound: height + 10 - 1 (10 pixels beyond published bottom edge)
-        int innerBound = cfg.centerY + 10;
-        int outerBound = cfg.height + 10 - 1;
+        case MENU_ADJUST_TOP: {
+            // Adjust usable area top edge
+            if (!activeDisplay) {
+                reply.println("ERROR:No active display selected");
+                return;
+            }
+            
+            int8_t adjust = atoi(tokens.rest());
+            
+            const DisplayConfig& cfg = activeDisplay->getConfig();
+            // Top is inverted: positive adjustment moves edge UP (decreases Y)
+            int newTop = cfg.usableY - adjust;
+            
+            // Inner bound: center - 10 pixels
+            // Outer bound: -10 pixels (10 pixels beyond published top edge)
+            int innerBound = cfg.centerY - 10;
+            int outerBound = -10;
+            
+            if (newTop < outerBound) {
+                reply.print("ERROR:Top edge would be beyond limit (maximum adjustment: ");
+                reply.print(cfg.usableY - outerBound);
+                reply.println(")");
+                return;
+            }
+            
+            if (newTop > innerBound) {
+                reply.print("ERROR:Top edge would be past center-10 (minimum adjustment: ");
+                reply.print(cfg.usableY - innerBound);
+                reply.println(")");
+                return;
+            }
+            
+            usableAreaAdjustTop = adjust;
+            reply.print("OK:Top edge adjusted to ");
+            reply.println(adjust);
+            
+            // Notify if at outer limit
+            if (newTop <= -10) {
+                reply.println("NOTICE:Top edge at maximum outward position (-10 pixels beyond display)");
+            }
+            
+            // Immediately update display
+            redrawCalibrationFrame();
+            break;
+        }
         
-        if (newBottom > outerBound) {
-            serialPort.print("ERROR:Bottom edge would be beyond limit (maximum: ");
-            serialPort.print(outerBound - configBottom);
-            serialPort.println(")");
-            return;
+        case MENU_ADJUST_BOTTOM: {
+            // Adjust usable area bottom edge
+            if (!activeDisplay) {
+                reply.println("ERROR:No active display selected");
+                return;
+            }
+            
+            int8_t adjust = atoi(tokens.rest());
+            
+            const DisplayConfig& cfg = activeDisplay->getConfig();
+            int configBottom = cfg.usableY + cfg.usableHeight - 1;
+            int newBottom = configBottom + adjust;
+            
+            // Inner bound: center + 10 pixels
+            // Outer bound: height + 10 - 1 (10 pixels beyond published bottom edge)
+            int innerBound = cfg.centerY + 10;
+            int outerBound = cfg.height + 10 - 1;
+            
+            if (newBottom > outerBound) {
+                reply.print("ERROR:Bottom edge would be beyond limit (maximum: ");
+                reply.print(outerBound - configBottom);
+                reply.println(")");
+                return;
+            }
+            
+            if (newBottom < innerBound) {
+                reply.print("ERROR:Bottom edge would be past center+10 (minimum: ");
+                reply.print(innerBound - configBottom);
+                reply.println(")");
+                return;
+            }
+            
+            usableAreaAdjustBottom = adjust;
+            reply.print("OK:Bottom edge adjusted to ");
+            reply.println(adjust);
+            
+            // Notify if at outer limit
+            if (newBottom >= cfg.height + 10 - 1) {
+                reply.print("NOTICE:Bottom edge at maximum outward position (");
+                reply.print(cfg.height + 10 - 1);
+                reply.println(" pixels, 10 beyond display)");
+            }
+            
+            // Immediately update display
+            redrawCalibrationFrame();
+            break;
+        }
+        
+        case MENU_ADJUST_LEFT: {
+            // Adjust usable area left edge
+            if (!activeDisplay) {
+                reply.println("ERROR:No active display selected");
+                return;
+            }
+            
+            int8_t adjust = atoi(tokens.rest());
+            
+            const DisplayConfig& cfg = activeDisplay->getConfig();
+            // Left is inverted: positive adjustment moves edge LEFT (decreases X)
+            int newLeft = cfg.usableX - adjust;
+            
+            // Inner bound: center - 10 pixels
+            // Outer bound: -10 pixels (10 pixels beyond published left edge)
+            int innerBound = cfg.centerX - 10;
+            int outerBound = -10;
+            
+            if (newLeft < outerBound) {
+                reply.print("ERROR:Left edge would be beyond limit (maximum adjustment: ");
+                reply.print(cfg.usableX - outerBound);
+                reply.println(")");
+                return;
+            }
+            
+            if (newLeft > innerBound) {
+                reply.print("ERROR:Left edge would be past center-10 (minimum adjustment: ");
+                reply.print(cfg.usableX - innerBound);
+                reply.println(")");
+                return;
+            }
+            
+            usableAreaAdjustLeft = adjust;
+            reply.print("OK:Left edge adjusted to ");
+            reply.println(adjust);
+            
+            // Notify if at outer limit
+            if (newLeft <= -10) {
+                reply.println("NOTICE:Left edge at maximum outward position (-10 pixels beyond display)");
+            }
+            
+            // Immediately update display
+            redrawCalibrationFrame();
+            break;
+        }
+        
+        case MENU_ADJUST_RIGHT: {
+            // Adjust usable area right edge
+            if (!activeDisplay) {
+                reply.println("ERROR:No active display selected");
+                return;
+            }
+            
+            int8_t adjust = atoi(tokens.rest());
+            
+            const DisplayConfig& cfg = activeDisplay->getConfig();
+            int configRight = cfg.usableX + cfg.usableWidth - 1;
+            int newRight = configRight + adjust;
+            
+            // Inner bound: center + 10 pixels
+            // Outer bound: width + 10 - 1 (10 pixels beyond published right edge)
+            int innerBound = cfg.centerX + 10;
+            int outerBound = cfg.width + 10 - 1;
+            
+            if (newRight > outerBound) {
+                reply.print("ERROR:Right edge would be beyond limit (maximum: ");
+                reply.print(outerBound - configRight);
+                reply.println(")");
+                return;
+            }
+            
+            if (newRight < innerBound) {
+                reply.print("ERROR:Right edge would be past center+10 (minimum: ");
+                reply.print(innerBound - configRight);
+                reply.println(")");
+                return;
+            }
+            
+            usableAreaAdjustRight = adjust;
+            reply.print("OK:Right edge adjusted to ");
+            reply.println(adjust);
+            
+            // Notify if at outer limit
+            if (newRight >= cfg.width + 10 - 1) {
+                reply.print("NOTICE:Right edge at maximum outward position (");
+                reply.print(cfg.width + 10 - 1);
+                reply.println(" pixels, 10 beyond display)");
+            }
+            
+            // Immediately update display
+            redrawCalibrationFrame();
+            break;
+        }
+        
+        case MENU_CALIBRATE: {
+            // Show calibration pattern on active display
+            if (!activeDisplay) {
+                reply.println("ERROR:No active display selected");
+                return;
+            }
+            
+            reply.print("OK:Showing calibration pattern on ");
+            reply.println(activeDisplay->getName());
+            redrawCalibrationFrame();
+            reply.println("Calibration pattern displayed");
+            break;
+        }
+        
+        case MENU_UPDATE_CONFIG: {
+            // Update base configuration values
+            // Format: UPDATE_CONFIG:left,right,top,bottom,centerX,centerY
+            if (!activeDisplay) {
+                reply.println("ERROR:No active display selected");
+                return;
+            }
+            
+            int values[6];
+            uint8_t idx = tokens.nextInts(values, 6);
+            if (idx > 6) {
+                reply.println("ERROR:Too many parameters");
+                return;
+            }
+            if (idx != 6) {
+                reply.println("ERROR:Expected 6 parameters (left,right,top,bottom,centerX,centerY)");
+                return;
+            }
+            
+            // Update the display's configuration
+            DisplayConfig& cfg = const_cast<DisplayConfig&>(activeDisplay->getConfig());
+            cfg.usableX = values[0];  // left
+            cfg.usableWidth = values[1] - values[0] + 1;  // width from right-left+1
+            cfg.usableY = values[2];  // top
+            cfg.usableHeight = values[3] - values[2] + 1;  // height from bottom-top+1
+            cfg.centerX = values[4];
+            cfg.centerY = values[5];
+            
+            // Reset adjustments since we're committing to new base config
+            usableAreaAdjustTop = 0;
+            usableAreaAdjustBottom = 0;
+            usableAreaAdjustLeft = 0;
+            usableAreaAdjustRight = 0;
+            
+            reply.println("OK:Base configuration updated");
+            reply.print("New usable area: ");
+            reply.print(cfg.usableX);
+            reply.print(",");
+            reply.print(cfg.usableX + cfg.usableWidth - 1);
+            reply.print(",");
+            reply.print(cfg.usableY);
+            reply.print(",");
+            reply.println(cfg.usableY + cfg.usableHeight - 1);
+            reply.print("New center: ");
+            reply.print(cfg.centerX);
+            reply.print(",");
+            reply.println(cfg.centerY);
+            reply.println("NOTE:Changes lost on power cycle - update .config file for permanent storage");
+            break;
+        }
+        
+        case MENU_ORIENTATION: {
+            // Set display orientation/rotation
+            // Format: ORIENTATION:value (0-3)
+            if (!activeDisplay) {
+                reply.println("ERROR:No active display selected");
+                return;
+            }
+            
+            int rotation = atoi(tokens.rest());
+            
+            if (rotation < 0 || rotation > 3) {
+                reply.println("ERROR:Invalid orientation. Use 0-3 (0=Portrait, 1=Landscape, 2=Reverse Portrait, 3=Reverse Landscape)");
+                return;
+            }
+            
+            if (!activeDisplay->getTFT()) {
+                reply.println("ERROR:Display not initialized");
+                return;
+            }
+            
+            // Edge adjustments move with the edges they belong to
+            const DisplayConfig& cfg = activeDisplay->getConfig();
+            const uint8_t from = cfg.rotation;
+            int16_t x = cfg.usableX;
+            int16_t y = cfg.usableY;
+            int16_t w = cfg.usableWidth;
+            int16_t h = cfg.usableHeight;
+            int16_t outerX = x - usableAreaAdjustLeft;
+            int16_t outerY = y - usableAreaAdjustTop;
+            int16_t outerW = w + usableAreaAdjustLeft + usableAreaAdjustRight;
+            int16_t outerH = h + usableAreaAdjustTop + usableAreaAdjustBottom;
+            activeDisplay->mapRect(from, rotation, x, y, w, h);
+            activeDisplay->mapRect(from, rotation, outerX, outerY, outerW, outerH);
+            usableAreaAdjustLeft = x - outerX;
+            usableAreaAdjustTop = y - outerY;
+            usableAreaAdjustRight = (outerX + outerW) - (x + w);
+            usableAreaAdjustBottom = (outerY + outerH) - (y + h);
+            
+            bool shadowKept = activeDisplay->setRotation(rotation);
+            
+            // The kept image is shown again in the new orientation, no re-send needed
+            if (DisplaySnapshot::hasSnapshot(activeDisplay->getTFT())) {
+                if (batchActive) {
+                    batchRepaint = true;
+                    batchRedraw = false;
+                } else {
+                    repaintSnapshot(activeDisplay);
+                }
+            }
+            if (!shadowKept) {
+                reply.println("ERROR:Not enough RAM for the rotated shadow framebuffer (shadow disabled)");
+                return;
+            }
+            reply.print("OK:Orientation set to ");
+            reply.println(rotation);
+            break;
+        }
+        
+        case MENU_THROUGHPUT: {
+            // Report pixel throughput of the most recent transfer
+            uint32_t bytesPerSec = 0;
+            if (transferMicros > 0) {
+                bytesPerSec = (uint32_t)((uint64_t)transferBytes * 1000000ULL / transferMicros);
+            }
+            reply.println("OK:THROUGHPUT");
+            reply.print("Bytes:");
+            reply.println(transferBytes);
+            reply.print("Micros:");
+            reply.println(transferMicros);
+            reply.print("BytesPerSec:");
+            reply.println(bytesPerSec);
+            reply.println("END_THROUGHPUT");
+            break;
+        }
+        
+        case MENU_STATS:
+            PerfStats::report(reply);
+            break;
+        
+        case MENU_STATS_RESET:
+            PerfStats::reset();
+            reply.println("OK:Stats reset");
+            break;
+        
+        case MENU_GROUPS: {
+            reply.println("OK:GROUPS");
+            displayManager.listGroups(serialPort);
+            reply.println("END_GROUPS");
+            break;
+        }
+        
+        case MENU_GROUP: {
+            // Define a display group, replacing any previous members
+            // Format: GROUP:<name>:<display>[,<display>...]
+            const char* groupName = tokens.next(':');
+            if (!groupName || !tokens.hasMore() || groupName[0] == '\0') {
+                reply.println("ERROR:Expected GROUP:<name>:<display>[,<display>...]");
+                return;
+            }
+            if (strcmp(groupName, "ALL") == 0) {
+                reply.println("ERROR:Group ALL is built in");
+                return;
+            }
+            if (activeGroup && strcmp(groupName, activeGroup->name) == 0) {
+                reply.println("ERROR:Group is selected for bitmap transfer");
+                return;
+            }
+            
+            displayManager.removeGroup(groupName);
+            while (char* field = tokens.next(',')) {
+                const char* member = trimInPlace(field);
+                if (!displayManager.addToGroup(groupName, member)) {
+                    displayManager.removeGroup(groupName);
+                    reply.print("ERROR:Cannot add display to group: ");
+                    reply.println(member);
+                    return;
+                }
+            }
+            reply.print("OK:Group ");
+            reply.print(groupName);
+            reply.println(" defined");
+            break;
+        }
+        
+        case MENU_SNAPSHOTS: {
+            // Report snapshot pool usage and what each slot holds
+            SnapshotStats stats;
+            DisplaySnapshot::getStats(stats);
+            reply.println("OK:SNAPSHOTS");
+            reply.print("Arena:");
+            reply.println(stats.arenaSize);
+            reply.print("Used:");
+            reply.println(stats.bytesUsed);
+            reply.print("Slots:");
+            reply.print(stats.slotsUsed);
+            reply.print("/");
+            reply.println(stats.maxSlots);
+            reply.print("Captures:");
+            reply.println(stats.captures);
+            reply.print("Evictions:");
+            reply.println(stats.evictions);
+            reply.print("Failures:");
+            reply.println(stats.failures);
+            
+            static const char* const regionNames[] = {
+                "IMAGE", "FRAME_TOP", "FRAME_BOTTOM", "FRAME_LEFT", "FRAME_RIGHT"
+            };
+            for (uint8_t i = 0; i < DisplaySnapshot::MAX_SLOTS; i++) {
+                const Adafruit_ST7735* owner;
+                uint8_t region;
+                SnapshotHeader header;
+                if (!DisplaySnapshot::getSlot(i, owner, region, header)) {
+                    continue;
+                }
+                const char* ownerName = "?";
+                for (uint8_t d = 0; d < displayManager.getDisplayCount(); d++) {
+                    DisplayInstance* display = displayManager.getDisplay(d);
+                    if (display && display->getTFT() == owner) {
+                        ownerName = display->getName();
+                    }
+                }
+                reply.print("  [");
+                reply.print(i);
+                reply.print("] ");
+                reply.print(ownerName);
+                reply.print(" ");
+                if (region < DisplaySnapshot::REGION_USER) {
+                    reply.print(regionNames[region]);
+                } else {
+                    reply.print("USER");
+                    reply.print(region - DisplaySnapshot::REGION_USER);
+                }
+                reply.print(" ");
+                reply.print(header.width);
+                reply.print("x");
+                reply.print(header.height);
+                reply.print(" @ (");
+                reply.print(header.offsetX);
+                reply.print(", ");
+                reply.print(header.offsetY);
+                reply.println(")");
+            }
+            reply.println("END_SNAPSHOTS");
+            break;
+        }
+        
+        case MENU_REPAINT: {
+            // Redraw the image kept by BMPStart:SNAPSHOT from RAM, e.g. after a test
+            // pattern or calibration overlay; REPAINT:x,y,w,h only redraws that rectangle
+            if (!activeDisplay) {
+                reply.println("ERROR:No active display selected");
+                return;
+            }
+            
+            bool partial = tokens.hasArgs();
+            int values[4] = {0, 0, 0, 0};
+            if (partial && tokens.nextInts(values, 4) != 4) {
+                reply.println("ERROR:Expected CMD:REPAINT[:x,y,w,h]");
+                return;
+            }
+            
+            uint8_t count = activeGroup ? activeGroup->memberCount : 1;
+            uint8_t repainted = 0;
+            for (uint8_t i = 0; i < count; i++) {
+                DisplayInstance* target = activeGroup ? activeGroup->members[i] : activeDisplay;
+                if (!DisplaySnapshot::hasSnapshot(target->getTFT())) {
+                    continue;
+                }
+                if (partial) {
+                    target->restoreSnapshot(values[0], values[1], values[2], values[3]);
+                } else {
+                    repaintSnapshot(target);
+                }
+                repainted++;
+            }
+            
+            if (repainted == 0) {
+                reply.println("ERROR:No snapshot to repaint (send the image with BMPStart:SNAPSHOT)");
+                return;
+            }
+            reply.print("OK:Repainted ");
+            reply.print(repainted);
+            reply.println(repainted == 1 ? " display" : " displays");
+            break;
+        }
+        
+        case MENU_DEBUG_ON: {
+            // BINARY transfers keep printing the text status lines alongside the packets
+            debugText = true;
+            reply.println("OK:Debug text enabled");
+            break;
+        }
+        
+        case MENU_DEBUG_OFF: {
+            debugText = false;
+            reply.println("OK:Debug text disabled");
+            break;
+        }
+        
+        case MENU_BATCH: {
+            runBatch(tokens);
+            break;
+        }
+        
+        case MENU_HELP: {
+            // Show command help
+            reply.println("OK:HELP");
+            reply.println("Available CMD: commands:");
+            reply.println("  CMD:LIST - List all displays");
+            reply.println("  CMD:INFO - Show active display info");
+            reply.println("  CMD:TEST - Test active display");
+            reply.println("  CMD:TEST_ALL - Test all displays");
+            reply.println("  CMD:FRAME_ON - Enable frame");
+            reply.println("  CMD:FRAME_OFF - Disable frame");
+            reply.println("  CMD:SHADOW_ON - Compose in a RAM shadow framebuffer, send only changes");
+            reply.println("  CMD:SHADOW_OFF - Draw straight to the panel");
+            reply.println("  CMD:FRAME_COLOR:value - Set frame color (0-65535)");
+            reply.println("  CMD:FRAME_THICKNESS:value - Set thickness (1-10)");
+            reply.println("  CMD:ADJUST_TOP:value - Adjust top edge (relative to config)");
+            reply.println("  CMD:ADJUST_BOTTOM:value - Adjust bottom edge");
+            reply.println("  CMD:ADJUST_LEFT:value - Adjust left edge");
+            reply.println("  CMD:ADJUST_RIGHT:value - Adjust right edge");
+            reply.println("  CMD:CALIBRATE - Show calibration pattern");
+            reply.println("  CMD:UPDATE_CONFIG:left,right,top,bottom,centerX,centerY - Update base config");
+            reply.println("  CMD:ORIENTATION:value - Set rotation (0=Portrait, 1=Landscape, 2=Rev Portrait, 3=Rev Landscape)");
+            reply.println("  CMD:THROUGHPUT - Show throughput of the last bitmap transfer");
+            reply.println("  CMD:STATS - Show performance counters");
+            reply.println("  CMD:STATS_RESET - Zero the performance counters");
+            reply.println("  CMD:GROUPS - List display groups");
+            reply.println("  CMD:GROUP:name:display[,display...] - Define a display group");
+            reply.println("  CMD:SNAPSHOTS - Show snapshot pool usage");
+            reply.println("  CMD:REPAINT[:x,y,w,h] - Redraw the snapshot image (or part of it)");
+            reply.println("  CMD:DEBUG_ON - Keep text status lines in BINARY transfers");
+            reply.println("  CMD:DEBUG_OFF - BINARY transfers report status packets only");
+            reply.println("  CMD:BATCH:cmd;cmd... - Apply calibration commands together, one reply and redraw");
+            reply.println("  CMD:HELP - Show this help");
+            reply.println();
+            reply.println("Bitmap protocol commands:");
+            reply.println("  DISPLAY:<name> - Select display for bitmap");
+            reply.println("  DISPLAY:GROUP:<name> - Mirror bitmap to a display group");
+            reply.println("  MULTI:<name>,w,h[;<name>,w,h...][;RLE][;BINARY] - Send to several displays at once");
+            reply.println("  STREAM:<name>,w,h,fps[,RLE][,BINARY][,ROT:<n>] - Start an animation session");
+            reply.println("  FRAME / FRAME:<n> - Stream frame: w*h pixels, or n RECTs with pixels");
+            reply.println("  STREAM_END - End the animation session and report the frame rate");
+            reply.println("  BMPStart - Start bitmap transfer");
+            reply.println("  BMPStart:SNAPSHOT - Start a transfer whose image is kept for CMD:REPAINT");
+            reply.println("  SIZE:width,height[,CREDIT][,DELTA][,RLE][,BINARY][,TILE][,BPP:n][,ROT:<n>] - Set bitmap dimensions and options");
+            reply.println("  <pixel data> - Send RGB565 pixel data");
+            reply.println("  ROT:<n> - Frame rendered for rotation n (0-3); not with MULTI, BMPStart:SNAPSHOT or the shadow");
+            reply.println("  BPP:n (1,2,4,8) - 2^n-entry RGB565 palette after READY, then packed indices; not with RLE or TILE");
+            reply.println("  RECT:x,y,w,h - Dirty rectangle (DELTA mode), followed by w*h pixels");
+            reply.println("  0xA5,seq,pixels,CRC - TILE packet (16x16 tile, LE fields); NACK:<seq>/RESEND:<n> -> resend, BMPEnd");
+            reply.println("  BMPEnd - End bitmap transfer");
+            reply.println("  DRAW:<bytes> - Render n bytes of F/R/B/L/T ops (fill, rect, box, line, text)");
+            reply.println();
+            reply.println("Image store commands:");
+            reply.println("  IMG:STORE:<id> - Start a bitmap transfer that is also saved to flash");
+            reply.println("  IMG:SHOW:<id>[,x,y][,ROT:<n>] - Draw a stored image (centered, or at x,y)");
+            reply.println("  IMG:LIST - List stored images");
+            reply.println("  IMG:DELETE:<id> - Remove a stored image");
+            reply.println("  IMG:ERASE - Remove all stored images");
+            reply.println("END_HELP");
+            break;
+        }
+    }
+}
+
+void SerialProtocol::runBatch(CommandTokens& tokens) {
+    // Format: BATCH:<command>[;<command>...], each without the CMD: prefix
+    if (batchActive) {
+        serialPort.println("ERROR:BATCH cannot be nested");
+        return;
+    }
+    if (!activeDisplay) {
+        serialPort.println("ERROR:No active display selected");
+        return;
+    }
+    
+    // Tokenize and check every command before anything is applied
+    CommandTokens commands[MAX_BATCH_COMMANDS];
+    uint8_t ids[MAX_BATCH_COMMANDS];
+    uint8_t count = 0;
+    while (char* field = tokens.next(';')) {
+        if (count == MAX_BATCH_COMMANDS) {
+            serialPort.print("ERROR:BATCH takes at most ");
+            serialPort.print(MAX_BATCH_COMMANDS);
+            serialPort.println(" commands");
+            return;
+        }
+        commands[count] = CommandTokens(trimInPlace(field));
+        const MenuCommand* spec = findMenuCommand(commands[count]);
+        if (!spec || !spec->batchable) {
+            serialPort.print("ERROR:BATCH command ");
+            serialPort.print(count + 1);
+            serialPort.print(" not allowed in a batch: ");
+            serialPort.println(commands[count].name());
+            return;
+        }
+        ids[count++] = spec->id;
+    }
+    
+    // Everything a batchable command can change, for rollback
+    DisplayConfig& cfg = const_cast<DisplayConfig&>(activeDisplay->getConfig());
+    const DisplayConfig savedConfig = cfg;
+    const int8_t savedAdjust[4] = {
+        usableAreaAdjustTop, usableAreaAdjustBottom, usableAreaAdjustLeft, usableAreaAdjustRight
+    };
+    const bool savedFrameEnabled = imageFrameEnabled;
+    const uint16_t savedFrameColor = imageFrameColor;
+    const uint8_t savedFrameThickness = imageFrameThickness;
+    const uint8_t savedRotation = activeDisplay->getTFT()->getRotation();
+    
+    batchActive = true;
+    batchRedraw = false;
+    batchRepaint = false;
+    batchReply.begin();
+    uint8_t applied = 0;
+    while (applied < count && !batchReply.hasError()) {
+        runMenuCommand(ids[applied], commands[applied]);
+        applied++;
+    }
+    batchActive = false;
+    
+    if (batchReply.hasError()) {
+        // Rotate back first: setRotation() maps the geometry the batch left behind
+        if (activeDisplay->getTFT()->getRotation() != savedRotation) {
+            activeDisplay->setRotation(savedRotation);
+        }
+        cfg = savedConfig;
+        usableAreaAdjustTop = savedAdjust[0];
+        usableAreaAdjustBottom = savedAdjust[1];
+        usableAreaAdjustLeft = savedAdjust[2];
+        usableAreaAdjustRight = savedAdjust[3];
+        imageFrameEnabled = savedFrameEnabled;
+        imageFrameColor = savedFrameColor;
+        imageFrameThickness = savedFrameThickness;
+        
+        serialPort.print("ERROR:BATCH command ");
+        serialPort.print(applied);
+        serialPort.print(" failed, nothing applied: ");
+        serialPort.println(batchReply.getError());
+        return;
+    }
+    
+    // One redraw for the whole batch
+    if (batchRepaint) {
+        repaintSnapshot(activeDisplay);
+    } else if (batchRedraw) {
+        redrawCalibrationFrame();
+    }
+    serialPort.print("OK:BATCH applied ");
+    serialPort.print(count);
+    serialPort.println(count == 1 ? " command" : " commands");
+}
+
+void SerialProtocol::repaintSnapshot(DisplayInstance* target) {
+    // Same result as the transfer: black around the image, then the frame
+    target->beginFrame();
+    target->clear();
+    target->restoreSnapshot();
+    if (imageFrameEnabled) {
+        target->drawImageFrame(imageFrameColor, imageFrameThickness);
+    }
+    target->endFrame();
+}
+
+void SerialProtocol::redrawCalibrationFrame() {
+    if (batchActive) {
+        batchRedraw = true;
+        batchRepaint = false;
+        return;
+    }
+    activeDisplay->drawCalibrationFrame(usableAreaAdjustTop, usableAreaAdjustBottom,
+                                       usableAreaAdjustLeft, usableAreaAdjustRight,
+                                       imageFrameColor, imageFrameThickness);
+}
+
+void SerialProtocol::handleImageCommand(const String& command) {
+    // Handle image store commands (IMG: prefix already stripped)
+    String cmd = command;
+    cmd.trim();
+    
+    if (!imageStore || !imageStore->isAvailable()) {
+        serialPort.println("ERROR:Image store not available");
+        return;
+    }
+    
+    if (cmd == "LIST") {
+        serialPort.println("OK:IMAGE_LIST");
+        serialPort.print("Count:");
+        serialPort.println(imageStore->getImageCount());
+        imageStore->listImages(serialPort);
+        serialPort.println("END_LIST");
+        
+    } else if (cmd.startsWith("STORE:")) {
+        // Stands in for BMPStart; the image is written to flash as its rows arrive
+        if (!activeDisplay) {
+            serialPort.println("ERROR:No active display selected");
+            return;
+        }
+        String id = cmd.substring(6);  // Skip "STORE:"
+        id.trim();
+        if (id.length() == 0 || id.length() > ImageRecord::MAX_ID_LENGTH || id.indexOf(',') >= 0) {
+            serialPort.print("ERROR:Image id must be 1-");
+            serialPort.print(ImageRecord::MAX_ID_LENGTH);
+            serialPort.println(" characters without commas");
+            return;
+        }
+        storeImageId = id;
+        serialPort.print("Store marker received: ");
+        serialPort.println(id);
+        currentState = WAITING_FOR_SIZE;
+        
+    } else if (cmd.startsWith("SHOW:")) {
+        showStoredImage(cmd.substring(5));  // Skip "SHOW:"
+        
+    } else if (cmd.startsWith("DELETE:")) {
+        String id = cmd.substring(7);  // Skip "DELETE:"
+        id.trim();
+        if (!imageStore->find(id.c_str())) {
+            serialPort.print("ERROR:Image not found: ");
+            serialPort.println(id);
+            return;
+        }
+        if (!imageStore->remove(id.c_str())) {
+            serialPort.println("ERROR:Image store write failed");
+            return;
+        }
+        serialPort.print("OK:Image ");
+        serialPort.print(id);
+        serialPort.println(" deleted");
+        
+    } else if (cmd == "ERASE") {
+        if (!imageStore->eraseAll()) {
+            serialPort.println("ERROR:Image store write failed");
+            return;
+        }
+        serialPort.println("OK:Image store erased");
+        
+    } else {
+        serialPort.print("ERROR:Unknown image command: ");
+        serialPort.println(cmd);
+    }
+}
+
+void SerialProtocol::showStoredImage(const String& spec) {
+    // Format: <id>[,x,y][,ROT:<n>]
+    if (!activeDisplay) {
+        serialPort.println("ERROR:No active display selected");
+        return;
+    }
+    
+    // Rotation the image was rendered (and stored) for, as SIZE option ROT
+    String params = spec;
+    uint8_t rotation = NO_FRAME_ROTATION;
+    int rotationIndex = spec.indexOf(",ROT:");
+    if (rotationIndex >= 0) {
+        String value = spec.substring(rotationIndex + 5);
+        value.trim();
+        if (value.length() != 1 || value[0] < '0' || value[0] > '3') {
+            serialPort.println("ERROR:ROT must be 0-3");
+            return;
+        }
+        rotation = value[0] - '0';
+        params = spec.substring(0, rotationIndex);
+    }
+    
+    int commaIndex = params.indexOf(',');
+    String id = commaIndex < 0 ? params : params.substring(0, commaIndex);
+    id.trim();
+    
+    const StoredImage* image = imageStore->find(id.c_str());
+    if (!image) {
+        serialPort.print("ERROR:Image not found: ");
+        serialPort.println(id);
+        return;
+    }
+    
+    // Explicit coordinates draw over the current content; otherwise the image
+    // replaces the screen like a bitmap transfer
+    bool placed = commaIndex >= 0;
+    int x = 0;
+    int y = 0;
+    if (placed) {
+        int secondComma = params.indexOf(',', commaIndex + 1);
+        if (secondComma < 0) {
+            serialPort.println("ERROR:Expected IMG:SHOW:<id>[,x,y][,ROT:<n>]");
+            return;
+        }
+        x = params.substring(commaIndex + 1, secondComma).toInt();
+        y = params.substring(secondComma + 1).toInt();
+    }
+    
+    const int width = image->getWidth();
+    const int height = image->getHeight();
+    uint8_t count = activeGroup ? activeGroup->memberCount : 1;
+    
+    for (uint8_t i = 0; i < count; i++) {
+        DisplayInstance* target = activeGroup ? activeGroup->members[i] : activeDisplay;
+        if (rotation != NO_FRAME_ROTATION && !target->beginSourceRotation(rotation)) {
+            serialPort.print("ERROR:ROT needs the shadow framebuffer off on ");
+            serialPort.println(target->getName());
+            return;
+        }
+        const bool rotated = target->isSourceRotated();
+        int left = x;
+        int top = y;
+        if (!placed) {
+            target->centerInUsableArea(width, height, left, top);
+        }
+        
+        // Clip once against the frame bounds, then burst the block straight out of flash
+        int16_t boundLeft, boundTop, boundRight, boundBottom;
+        target->getFrameBounds(boundLeft, boundTop, boundRight, boundBottom,
+                               usableAreaAdjustTop, usableAreaAdjustBottom,
+                               usableAreaAdjustLeft, usableAreaAdjustRight);
+        int firstX = (left > boundLeft) ? left : boundLeft;
+        int firstY = (top > boundTop) ? top : boundTop;
+        int lastX = left + width - 1;
+        int lastY = top + height - 1;
+        if (lastX > boundRight) {
+            lastX = boundRight;
+        }
+        if (lastY > boundBottom) {
+            lastY = boundBottom;
+        }
+        
+        // With a shadow framebuffer the screen is composed first and sent once
+        target->beginFrame();
+        if (!placed || rotated) {
+            // A rotated sprite cannot be recorded into the snapshot's orientation
+            if (!placed) {
+                target->clear();
+            }
+            target->discardSnapshot();
+        }
+        if (firstX <= lastX && firstY <= lastY) {
+            const uint16_t* first = image->pixels + (firstY - top) * width + (firstX - left);
+            target->writeRect(firstX, firstY, lastX - firstX + 1, lastY - firstY + 1, first, width);
+            
+            // A sprite drawn over a snapshot image becomes part of it
+            for (int row = firstY; placed && !rotated && row <= lastY; row++) {
+                target->recordSpan(firstX, row, first + (row - firstY) * width, lastX - firstX + 1);
+            }
+        }
+        target->endSourceRotation();
+        if (!placed && imageFrameEnabled) {
+            target->drawImageFrame(imageFrameColor, imageFrameThickness);
+        }
+        target->endFrame();
+    }
+    DisplayInstance::waitForTransfer();
+    
+    serialPort.print("OK:Showing ");
+    serialPort.println(id);
+}
+
+void SerialProtocol::handleDraw(const String& params) {
+    // Format: DRAW:<n>, followed by n bytes of ops
+    int length = params.toInt();
+    if (length <= 0) {
+        serialPort.println("ERROR:Expected DRAW:<bytes>");
+        return;
+    }
+    
+    // The list goes into the row buffers, which may still be feeding a DMA transfer.
+    // A list too long for them is read and dropped, so it cannot be taken for commands.
+    DisplayInstance::waitForTransfer();
+    drawBytesExpected = length;
+    drawBytesReceived = 0;
+    currentState = RECEIVING_DRAW_LIST;
+}
+
+void SerialProtocol::handleDrawReception() {
+    uint8_t* list = (uint8_t*)rowBuffers;
+    while (drawBytesReceived < drawBytesExpected && serialPort.available() > 0) {
+        if (drawBytesReceived >= MAX_DRAW_BYTES) {
+            serialPort.read();
+            drawBytesReceived++;
+            PerfStats::countBytes(1);
+            continue;
+        }
+        int wanted = (drawBytesExpected < MAX_DRAW_BYTES ? drawBytesExpected : MAX_DRAW_BYTES) - drawBytesReceived;
+        if (serialPort.available() < wanted) {
+            wanted = serialPort.available();
+        }
+        int received = serialPort.readBytes(list + drawBytesReceived, wanted);
+        if (received <= 0) {
+            return;
+        }
+        PerfStats::countBytes(received);
+        drawBytesReceived += received;
+    }
+    if (drawBytesReceived < drawBytesExpected) {
+        return;
+    }
+    
+    currentState = WAITING_FOR_START;
+    if (drawBytesExpected > MAX_DRAW_BYTES) {
+        serialPort.print("ERROR:DRAW list longer than ");
+        serialPort.print(MAX_DRAW_BYTES);
+        serialPort.println(" bytes dropped");
+        return;
+    }
+    runDisplayList();
+}
+
+void SerialProtocol::runDisplayList() {
+    const uint8_t* list = (const uint8_t*)rowBuffers;
+    
+    // Check the whole list first: a malformed one draws nothing
+    int ops = 0;
+    for (int offset = 0; offset < drawBytesExpected; ops++) {
+        int length = drawOpLength(list + offset, drawBytesExpected - offset);
+        if (length == 0) {
+            serialPort.print("ERROR:Bad DRAW op at byte ");
+            serialPort.println(offset);
+            return;
+        }
+        offset += length;
+    }
+    
+    uint8_t count = activeGroup ? activeGroup->memberCount : 1;
+    for (uint8_t i = 0; i < count; i++) {
+        DisplayInstance* target = activeGroup ? activeGroup->members[i] : activeDisplay;
+        Adafruit_GFX* gfx = target->beginFrame();
+        for (int offset = 0; offset < drawBytesExpected;) {
+            offset += drawOp(gfx, list + offset);
+        }
+        target->endFrame();
+    }
+    DisplayInstance::waitForTransfer();
+    
+    serialPort.print("OK:DRAW:");
+    serialPort.println(ops);
+}
+
+void SerialProtocol::handleStart(const String& command) {
+    // Ensure we have an active display before accepting bitmap
+    if (!activeDisplay) {
+        sendError("No active display selected", STATUS_ERROR_DISPLAY);
+        currentState = WAITING_FOR_DISPLAY_SELECT;
+        return;
+    }
+    
+    if (command.startsWith("MULTI:")) {
+        handleMulti(command.substring(6));
+        return;
+    }
+    
+    if (command.startsWith("STREAM:")) {
+        handleStream(command.substring(7));
+        return;
+    }
+    
+    if (command.startsWith("IMG:")) {
+        handleImageCommand(command.substring(4));
+        return;
+    }
+    
+    if (command.startsWith("DRAW:")) {
+        handleDraw(command.substring(5));
+        return;
+    }
+    
+    if (command == "BMPStart" || command == "BMPStart:SNAPSHOT") {
+        // The SNAPSHOT variant also keeps the drawn image in the snapshot pool
+        snapshotRequested = command.endsWith(":SNAPSHOT");
+        serialPort.println("Start marker received");
+        currentState = WAITING_FOR_SIZE;
+    } else if (command.length() > 0) {
+        sendError("Expected BMPStart, got: " + command);
+    }
+}
+
+void SerialProtocol::handleSize(const String& sizeCommand) {
+    if (sizeCommand.startsWith("SIZE:")) {
+        int commaIndex = sizeCommand.indexOf(',');
+        if (commaIndex > 0) {
+            // Optional transfer options follow the height: SIZE:width,height[,option...]
+            int optionsIndex = sizeCommand.indexOf(',', commaIndex + 1);
+            bitmapWidth = sizeCommand.substring(5, commaIndex).toInt();
+            if (optionsIndex > 0) {
+                bitmapHeight = sizeCommand.substring(commaIndex + 1, optionsIndex).toInt();
+            } else {
+                bitmapHeight = sizeCommand.substring(commaIndex + 1).toInt();
+            }
+            
+            if (!parseSizeOptions(optionsIndex > 0 ? sizeCommand.substring(optionsIndex + 1) : String())) {
+                return;
+            }
+            if (deltaMode && storeImageId.length() > 0) {
+                sendError("DELTA is not supported with IMG:STORE", STATUS_ERROR_OPTION);
+                return;
+            }
+            if (deltaMode && snapshotRequested) {
+                sendError("DELTA cannot start a snapshot (it keeps an existing one current)", STATUS_ERROR_OPTION);
+                return;
+            }
+            if (tilesEnabled && (flowControlEnabled || deltaMode || rleEnabled)) {
+                sendError("TILE cannot be combined with CREDIT, DELTA or RLE", STATUS_ERROR_OPTION);
+                return;
+            }
+            if (tilesEnabled && storeImageId.length() > 0) {
+                sendError("TILE is not supported with IMG:STORE", STATUS_ERROR_OPTION);
+                return;
+            }
+            if (frameRotation != NO_FRAME_ROTATION && snapshotRequested) {
+                sendError("ROT cannot start a snapshot (snapshots keep the display's own rotation)",
+                          STATUS_ERROR_OPTION);
+                return;
+            }
+            
+            // From here on the targets are addressed in the frame's rotation, so the
+            // size is checked against, and centered in, the usable area as seen there
+            if (!beginFrameRotation()) {
+                return;
+            }
+            
+            if (validateDimensions(bitmapWidth, bitmapHeight) && 
+                (activeGroup ? placeGroupMembers()
+                             : calculateOffsets(bitmapWidth, bitmapHeight, offsetX, offsetY))) {
+                
+                if (tilesEnabled) {
+                    tileColumns = (bitmapWidth + TILE_SIZE - 1) / TILE_SIZE;
+                    tileCount = tileColumns * ((bitmapHeight + TILE_SIZE - 1) / TILE_SIZE);
+                    if (tileCount > MAX_TILES) {
+                        sendError("Bitmap needs " + String(tileCount) + " tiles, more than " + String(MAX_TILES),
+                                  STATUS_ERROR_DIMENSIONS);
+                        return;
+                    }
+                }
+                
+                // Reserve room in the store first; this may compact it, which takes a while
+                if (storeImageId.length() > 0) {
+                    if (!imageStore->beginImage(storeImageId.c_str(), bitmapWidth, bitmapHeight)) {
+                        sendError("Image store cannot take " + storeImageId + " (full?)", STATUS_ERROR_STORE);
+                        return;
+                    }
+                    if (textStatus()) {
+                        serialPort.print("Storing image: ");
+                        serialPort.println(storeImageId);
+                    }
+                }
+                
+                // Clear display BEFORE sending READY; a delta update draws over the current image
+                if (activeGroup && !deltaMode) {
+                    if (textStatus()) {
+                        serialPort.println("Clearing group displays...");
+                    }
+                    for (uint8_t i = 0; i < activeGroup->memberCount; i++) {
+                        activeGroup->members[i]->clear();
+                    }
+                } else if (activeDisplay && !deltaMode) {
+                    if (textStatus()) {
+                        serialPort.println("Clearing display...");
+                    }
+                    activeDisplay->clear();
+                }
+                
+                sendReady();
+                if (textStatus()) {
+                    serialPort.print("Receiving bitmap: ");
+                    serialPort.print(bitmapWidth);
+                    serialPort.print("x");
+                    serialPort.println(bitmapHeight);
+                }
+                
+                // Frame adjustments define the visible area regardless of frame visibility;
+                // resolve them once here rather than per pixel
+                activeDisplay->getFrameBounds(clipLeft, clipTop, clipRight, clipBottom,
+                                              usableAreaAdjustTop, usableAreaAdjustBottom,
+                                              usableAreaAdjustLeft, usableAreaAdjustRight);
+                
+                // A full frame replaces the screen: start the snapshot of it, or drop the
+                // now stale one. Delta rectangles update an existing snapshot as they draw.
+                if (!deltaMode) {
+                    if (activeGroup) {
+                        prepareGroupSnapshots();
+                    } else {
+                        MultiSlot slot;
+                        slot.display = activeDisplay;
+                        slot.offsetX = offsetX;
+                        slot.offsetY = offsetY;
+                        slot.clipLeft = clipLeft;
+                        slot.clipTop = clipTop;
+                        slot.clipRight = clipRight;
+                        slot.clipBottom = clipBottom;
+                        prepareSnapshot(slot);
+                    }
+                }
+                
+                transferBytes = 0;
+                transferMicros = 0;
+                
+                if (deltaMode) {
+                    currentState = WAITING_FOR_RECT;
+                    if (textStatus()) {
+                        serialPort.println("Ready to receive dirty rectangles");
+                    }
+                } else if (tilesEnabled) {
+                    memset(tilesVerified, 0, sizeof(tilesVerified));
+                    tileBytesReceived = 0;
+                    currentState = WAITING_FOR_TILE;
+                    if (textStatus()) {
+                        serialPort.print("Ready to receive ");
+                        serialPort.print(tileCount);
+                        serialPort.print(" tiles of ");
+                        serialPort.print(TILE_SIZE);
+                        serialPort.print("x");
+                        serialPort.println(TILE_SIZE);
+                    }
+                } else {
+                    beginRect(0, 0, bitmapWidth, bitmapHeight);
+                    if (textStatus()) {
+                        serialPort.print("Ready to receive ");
+                        serialPort.print(bitmapWidth * bitmapHeight);
+                        serialPort.println(" pixels");
+                    }
+                }
+                if (bitsPerPixel < 16) {
+                    beginPalette();
+                }
+            }
+        } else {
+            sendError("Invalid size format");
+        }
+    }
+}
+
+void SerialProtocol::handleDataReception() {
+    if (!activeDisplay) {
+        sendError("No active display", STATUS_ERROR_DISPLAY);
+        return;
+    }
+    
+    PerfStats::ScopedCycles timer(PerfStats::counters.receiveCycles);
+    if (serialPort.available() > 0) {
+        PerfStats::endStall();
+    }
+    
+    if (rleEnabled) {
+        handleRleReception();
+        return;
+    }
+    
+    // Pull pixel data (RGB565, 2 bytes per pixel) in blocks straight into the row buffer.
+    // RGB565 stays big-endian as received; the panel takes it in that order.
+    // Indexed rows are staged packed and expanded once complete.
+    const bool indexed = bitsPerPixel < 16;
+    const int rowSize = indexed ? (rectWidth * bitsPerPixel + 7) / 8 : rectWidth * 2;
+    
+    while (currentState == RECEIVING_DATA) {
+        int available = serialPort.available();
+        if (available <= 0) {
+            PerfStats::beginStall();
+            break;
+        }
+        
+        if (transferBytes == 0) {
+            transferStartMicros = micros();
+        }
+        
+        // Never ask for more than is buffered, so readBytes() does not block
+        int wanted = rowSize - rowBytesReceived;
+        if (available < wanted) {
+            wanted = available;
+        }
+        uint8_t* rowBytes = indexed ? packedRow : (uint8_t*)rowBuffer;
+        int received = serialPort.readBytes(rowBytes + rowBytesReceived, wanted);
+        if (received <= 0) {
+            break;
+        }
+        PerfStats::countBytes(received);
+        if (tilesEnabled) {
+            tileCrc = crc16Update(tileCrc, rowBytes + rowBytesReceived, received);
+        }
+        rowBytesReceived += received;
+        transferBytes += received;
+        
+        if (rowBytesReceived < rowSize) {
+            continue;
+        }
+        
+        if (indexed) {
+            expandIndexedRow();
+        }
+        completeRow();
+    }
+}
+
+void SerialProtocol::beginPalette() {
+    // The palette comes first, then reception goes on where the transfer setup left it
+    paletteNextState = currentState;
+    paletteBytesReceived = 0;
+    currentState = RECEIVING_PALETTE;
+}
+
+void SerialProtocol::handlePaletteReception() {
+    const int paletteSize = (1 << bitsPerPixel) * 2;
+    int available = serialPort.available();
+    int wanted = paletteSize - paletteBytesReceived;
+    if (available < wanted) {
+        wanted = available;
+    }
+    int received = serialPort.readBytes((uint8_t*)palette + paletteBytesReceived, wanted);
+    if (received <= 0) {
+        return;
+    }
+    PerfStats::countBytes(received);
+    paletteBytesReceived += received;
+    
+    if (paletteBytesReceived == paletteSize) {
+        currentState = paletteNextState;
+    }
+}
+
+void SerialProtocol::expandIndexedRow() {
+    switch (bitsPerPixel) {
+        case 1:
+            expandIndices<1>(packedRow, palette, rowBuffer, rectWidth);
+            break;
+        case 2:
+            expandIndices<2>(packedRow, palette, rowBuffer, rectWidth);
+            break;
+        case 4:
+            expandIndices<4>(packedRow, palette, rowBuffer, rectWidth);
+            break;
+        default:
+            for (int x = 0; x < rectWidth; x++) {
+                rowBuffer[x] = palette[packedRow[x]];
+            }
+            break;
+    }
+}
+
+void SerialProtocol::handleRleReception() {
+    const int rowSize = rectWidth * 2;
+    
+    while (currentState == RECEIVING_DATA) {
+        int available = serialPort.available();
+        if (available <= 0) {
+            PerfStats::beginStall();
+            break;
+        }
+        
+        if (transferBytes == 0) {
+            transferStartMicros = micros();
+        }
+        
+        if (rlePacketPixels == 0) {
+            // Packet header: bit 7 set = run of one pixel, clear = literal pixels
+            uint8_t header = serialPort.read();
+            PerfStats::countBytes(1);
+            transferBytes++;
+            rlePacketIsRun = (header & 0x80) != 0;
+            rlePacketPixels = (header & 0x7F) + 1;
+            rlePacketBytes = 0;
+            
+            if (rowBytesReceived + rlePacketPixels * 2 > rowSize) {
+                sendError("RLE packet crosses end of row " + String(currentRow), STATUS_ERROR_RLE);
+                return;
+            }
+            continue;
+        }
+        
+        // A run carries one pixel; a literal is copied straight into the row buffer
+        int payloadSize = rlePacketIsRun ? 2 : rlePacketPixels * 2;
+        uint8_t* payload = rlePacketIsRun ? rleRunValue : (uint8_t*)rowBuffer + rowBytesReceived;
+        
+        int wanted = payloadSize - rlePacketBytes;
+        if (available < wanted) {
+            wanted = available;
+        }
+        int received = serialPort.readBytes(payload + rlePacketBytes, wanted);
+        if (received <= 0) {
+            break;
+        }
+        PerfStats::countBytes(received);
+        rlePacketBytes += received;
+        transferBytes += received;
+        
+        if (rlePacketBytes < payloadSize) {
+            continue;
+        }
+        
+        if (rlePacketIsRun) {
+            if (rowBytesReceived == 0 && rlePacketPixels == rectWidth) {
+                // The whole row is one color: no need to expand it
+                rowIsFlat = true;
+            } else {
+                uint16_t value;
+                memcpy(&value, rleRunValue, sizeof(value));  // Keep display byte order
+                uint16_t* dest = rowBuffer + rowBytesReceived / 2;
+                for (int i = 0; i < rlePacketPixels; i++) {
+                    dest[i] = value;
+                }
+            }
+        }
+        rowBytesReceived += rlePacketPixels * 2;
+        rlePacketPixels = 0;
+        
+        if (rowBytesReceived == rowSize) {
+            completeRow();
+        }
+    }
+}
+
+void SerialProtocol::completeRow() {
+    if (imageStore && imageStore->isWriting()) {
+        // Save the decoded row before it is drawn; flat rows were never expanded
+        bool stored;
+        if (rowIsFlat) {
+            uint16_t value;
+            memcpy(&value, rleRunValue, sizeof(value));  // Keep display byte order
+            stored = imageStore->appendRun(value, rectWidth);
+        } else {
+            stored = imageStore->appendPixels(rowBuffer, rectWidth);
+        }
+        if (!stored) {
+            sendError("Image store write failed", STATUS_ERROR_STORE);
+            return;
+        }
+    }
+    
+    if (activeGroup) {
+        // Fan the row out to every member with its own placement and clipping.
+        // Flat rows are filled right away: the pending fill covers one display only.
+        for (uint8_t i = 0; i < activeGroup->memberCount; i++) {
+            loadSlot(groupSlots[i]);
+            if (rowIsFlat) {
+                queueFlatRow((uint16_t)((rleRunValue[0] << 8) | rleRunValue[1]));
+                flushFill();
+            } else {
+                blitRow();
+            }
+        }
+        rowIsFlat = false;
+        
+        // Receive the next row into the other buffer while the last member drains
+        rowBufferIndex = (rowBufferIndex + 1) % ROW_BUFFER_COUNT;
+        rowBuffer = rowBuffers[rowBufferIndex];
+    } else if (rowIsFlat) {
+        queueFlatRow((uint16_t)((rleRunValue[0] << 8) | rleRunValue[1]));
+        rowIsFlat = false;
+    } else {
+        flushFill();
+        blitRow();
+        
+        // Receive the next row into the other buffer while this one drains
+        rowBufferIndex = (rowBufferIndex + 1) % ROW_BUFFER_COUNT;
+        rowBuffer = rowBuffers[rowBufferIndex];
+    }
+    rowBytesReceived = 0;
+    currentRow++;
+    
+    // The staging buffer is free again: hand the row's credit back to the host.
+    // Delta and stream rows keep flowing into the next rectangle, so every row returns one.
+    if (flowControlEnabled && (deltaMode || streamActive || multiSlotCount > 0 || currentRow < rectHeight)) {
+        if (binaryStatus) {
+            sendStatus(STATUS_CREDIT, 1);
+        } else {
+            serialPort.println("CREDIT:1");
+        }
+    }
+    
+    if (currentRow >= rectHeight) {
+        flushFill();
+        if (multiSlotCount > 0) {
+            // A MULTI row is a one-row rectangle; the next packet may be for any display
+            multiSlots[multiSlot].row++;
+            if (--multiRowsRemaining > 0) {
+                currentState = WAITING_FOR_ROW_TAG;
+                return;
+            }
+        }
+        DisplayInstance::waitForTransfer();
+        transferMicros = micros() - transferStartMicros;
+        if (streamActive) {
+            // A stream frame ends with its last rectangle; the next FRAME may follow at once
+            currentState = (deltaMode && --streamRectsRemaining > 0) ? WAITING_FOR_RECT : WAITING_FOR_FRAME;
+            return;
+        }
+        if (tilesEnabled) {
+            // The tile is drawn; its CRC decides whether it has to come again
+            currentState = WAITING_FOR_TILE_CRC;
+            tileBytesReceived = 0;
+            return;
+        }
+        currentState = deltaMode ? WAITING_FOR_RECT : WAITING_FOR_END;
+        return;
+    }
+    
+    // Progress indication every PROGRESS_REPORT_INTERVAL rows (credits already report it)
+    if (deltaMode || streamActive || tilesEnabled || currentRow % PROGRESS_REPORT_INTERVAL != 0) {
+        return;
+    }
+    if (binaryStatus && !flowControlEnabled) {
+        sendStatus(STATUS_PROGRESS, currentRow);
+    }
+    if (textStatus()) {
+        // Tenths of a percent, rounded, without float formatting
+        uint32_t permille = ((uint32_t)currentRow * 1000 + rectHeight / 2) / rectHeight;
+        serialPort.print("Progress: ");
+        printTenths(serialPort, permille);
+        serialPort.print("% (Row ");
+        serialPort.print(currentRow);
+        serialPort.print("/");
+        serialPort.print(rectHeight);
+        serialPort.println(")");
+    }
+}
+
+void SerialProtocol::blitRow() {
+    // Clip the completed row once against the frame bounds (acts as cropping guide)
+    int displayY = offsetY + rectY + currentRow;
+    if (displayY < clipTop || displayY > clipBottom) {
+        PerfStats::countClipped(rectWidth);
+        return;
+    }
+    
+    int rowX = offsetX + rectX;
+    int firstX = (rowX > clipLeft) ? rowX : clipLeft;
+    int lastX = rowX + rectWidth - 1;
+    if (lastX > clipRight) {
+        lastX = clipRight;
+    }
+    if (firstX > lastX) {
+        PerfStats::countClipped(rectWidth);
+        return;
+    }
+    PerfStats::countClipped(rectWidth - (lastX - firstX + 1));
+    
+    activeDisplay->writeRowAsync(firstX, displayY, &rowBuffer[firstX - rowX], lastX - firstX + 1);
+    activeDisplay->recordSpan(firstX, displayY, &rowBuffer[firstX - rowX], lastX - firstX + 1);
+}
+
+void SerialProtocol::queueFlatRow(uint16_t color) {
+    // Extend the pending fill if this row continues it, otherwise start a new one
+    int displayY = offsetY + rectY + currentRow;
+    if (fillRows > 0 && color == fillColor && displayY == fillY + fillRows) {
+        fillRows++;
+        return;
+    }
+    
+    flushFill();
+    fillY = displayY;
+    fillRows = 1;
+    fillColor = color;
+}
+
+void SerialProtocol::flushFill() {
+    if (fillRows == 0) {
+        return;
+    }
+    
+    // Same clipping as blitRow, applied to the whole block of flat rows
+    int firstY = (fillY > clipTop) ? fillY : clipTop;
+    int lastY = fillY + fillRows - 1;
+    if (lastY > clipBottom) {
+        lastY = clipBottom;
+    }
+    
+    int rowX = offsetX + rectX;
+    int firstX = (rowX > clipLeft) ? rowX : clipLeft;
+    int lastX = rowX + rectWidth - 1;
+    if (lastX > clipRight) {
+        lastX = clipRight;
+    }
+    
+    uint32_t visible = 0;
+    if (firstX <= lastX && firstY <= lastY) {
+        visible = (uint32_t)(lastX - firstX + 1) * (lastY - firstY + 1);
+        Adafruit_GFX* gfx = activeDisplay->beginFrame();
+        if (activeDisplay->isShadowEnabled()) {
+            // Composed in RAM; endFrame() times the flush
+            gfx->fillRect(firstX, firstY, lastX - firstX + 1, lastY - firstY + 1, fillColor);
+        } else {
+            PerfStats::ScopedCycles spi(PerfStats::counters.spiCycles);
+            PerfStats::countSpiWrite();
+            gfx->fillRect(firstX, firstY, lastX - firstX + 1, lastY - firstY + 1, fillColor);
+        }
+        activeDisplay->endFrame();
+        activeDisplay->recordFill(firstX, firstY, lastX - firstX + 1, lastY - firstY + 1, fillColor);
+    }
+    PerfStats::countClipped((uint32_t)rectWidth * fillRows - visible);
+    fillRows = 0;
+}
+
+bool SerialProtocol::snapshotArea(const MultiSlot& slot, int& x, int& y, int& width, int& height) {
+    // Keep exactly what the transfer leaves visible: the bitmap cut to the frame bounds
+    x = (slot.offsetX > slot.clipLeft) ? slot.offsetX : slot.clipLeft;
+    y = (slot.offsetY > slot.clipTop) ? slot.offsetY : slot.clipTop;
+    int lastX = slot.offsetX + bitmapWidth - 1;
+    int lastY = slot.offsetY + bitmapHeight - 1;
+    if (lastX > slot.clipRight) {
+        lastX = slot.clipRight;
+    }
+    if (lastY > slot.clipBottom) {
+        lastY = slot.clipBottom;
+    }
+    width = lastX - x + 1;
+    height = lastY - y + 1;
+    return width > 0 && height > 0;
+}
+
+void SerialProtocol::prepareGroupSnapshots() {
+    // The pool evicts least recently used slots to make room, so members that do not
+    // fit together would silently drop each other's snapshot; keep none of them instead
+    if (snapshotRequested) {
+        uint32_t bytes = 0;
+        for (uint8_t i = 0; i < activeGroup->memberCount; i++) {
+            int x, y, width, height;
+            if (snapshotArea(groupSlots[i], x, y, width, height)) {
+                bytes += (uint32_t)width * height * sizeof(uint16_t);
+            }
+        }
+        if (bytes > DISPLAY_SNAPSHOT_ARENA_SIZE) {
+            for (uint8_t i = 0; i < activeGroup->memberCount; i++) {
+                groupSlots[i].display->discardSnapshot();
+            }
+            if (textStatus()) {
+                serialPort.print("Snapshot skipped for group ");
+                serialPort.print(activeGroup->name);
+                serialPort.print(" (members need ");
+                serialPort.print(bytes);
+                serialPort.print(" bytes, snapshot pool holds ");
+                serialPort.print(DISPLAY_SNAPSHOT_ARENA_SIZE);
+                serialPort.println(")");
+            }
+            return;
+        }
+    }
+    for (uint8_t i = 0; i < activeGroup->memberCount; i++) {
+        prepareSnapshot(groupSlots[i]);
+    }
+}
+
+void SerialProtocol::prepareSnapshot(const MultiSlot& slot) {
+    if (!snapshotRequested) {
+        slot.display->discardSnapshot();
+        return;
+    }
+    
+    int x, y, width, height;
+    if (!snapshotArea(slot, x, y, width, height) ||
+        !slot.display->beginSnapshot(x, y, width, height)) {
+        slot.display->discardSnapshot();
+        if (textStatus()) {
+            serialPort.print("Snapshot skipped for ");
+            serialPort.print(slot.display->getName());
+            serialPort.println(" (does not fit the snapshot pool)");
+        }
+        return;
+    }
+    if (textStatus()) {
+        serialPort.print("Capturing snapshot on ");
+        serialPort.println(slot.display->getName());
+    }
+}
+
+bool SerialProtocol::beginFrameRotation() {
+    if (frameRotation == NO_FRAME_ROTATION || (!activeGroup && !activeDisplay)) {
+        return true;
+    }
+    uint8_t count = activeGroup ? activeGroup->memberCount : 1;
+    for (uint8_t i = 0; i < count; i++) {
+        DisplayInstance* target = activeGroup ? activeGroup->members[i] : activeDisplay;
+        if (!target->beginSourceRotation(frameRotation)) {
+            sendError("ROT needs the shadow framebuffer off on " + String(target->getName()),
+                      STATUS_ERROR_OPTION);
+            return false;
+        }
+        // The snapshot stays in the display's own rotation; rotated rows cannot update it
+        if (target->isSourceRotated()) {
+            target->discardSnapshot();
+        }
+    }
+    return true;
+}
+
+void SerialProtocol::endFrameRotation() {
+    for (uint8_t i = 0; i < displayManager.getDisplayCount(); i++) {
+        displayManager.getDisplay(i)->endSourceRotation();
+    }
+}
+
+void SerialProtocol::beginRect(int x, int y, int width, int height) {
+    rectX = x;
+    rectY = y;
+    rectWidth = width;
+    rectHeight = height;
+    currentRow = 0;
+    rowBytesReceived = 0;
+    rlePacketPixels = 0;
+    rowIsFlat = false;
+    fillRows = 0;
+    currentState = RECEIVING_DATA;
+}
+
+void SerialProtocol::sendReady() {
+    // Host may send FLOW_CONTROL_CREDITS rows ahead; one credit returns per row consumed
+    if (binaryStatus) {
+        sendStatus(STATUS_READY, flowControlEnabled ? FLOW_CONTROL_CREDITS : 0);
+        return;
+    }
+    serialPort.println("READY");
+    if (flowControlEnabled) {
+        serialPort.print("CREDITS:");
+        serialPort.println(FLOW_CONTROL_CREDITS);
+    }
+}
+
+void SerialProtocol::handleRect(const String& command) {
+    // A stream frame ends after its announced rectangles, not with BMPEnd
+    if (command == "BMPEnd" && !streamActive) {
+        finishBitmap();
+        return;
+    }
+    
+    if (!command.startsWith("RECT:")) {
+        if (command.length() > 0) {
+            sendError("Expected RECT or BMPEnd, got: " + command, STATUS_ERROR_RECT);
+        }
+        return;
+    }
+    
+    // Format: RECT:x,y,w,h in bitmap coordinates
+    String params = command.substring(5);  // Skip "RECT:"
+    int values[4];
+    int idx = 0;
+    int start = 0;
+    
+    for (int i = 0; i <= params.length(); i++) {
+        if (i == params.length() || params.charAt(i) == ',') {
+            if (idx >= 4) {
+                sendError("Too many RECT parameters", STATUS_ERROR_RECT);
+                return;
+            }
+            values[idx++] = params.substring(start, i).toInt();
+            start = i + 1;
+        }
+    }
+    
+    if (idx != 4) {
+        sendError("Expected RECT:x,y,w,h", STATUS_ERROR_RECT);
+        return;
+    }
+    
+    if (values[0] < 0 || values[1] < 0 || values[2] <= 0 || values[3] <= 0 ||
+        values[0] + values[2] > bitmapWidth || values[1] + values[3] > bitmapHeight) {
+        sendError("RECT outside bitmap: " + params, STATUS_ERROR_RECT);
+        return;
+    }
+    
+    beginRect(values[0], values[1], values[2], values[3]);
+}
+
+void SerialProtocol::handleMulti(const String& spec) {
+    // Format: MULTI:<name>,<w>,<h>[;<name>,<w>,<h>...][;option...]
+    multiPreviousDisplay = activeDisplay;
+    multiPreviousGroup = activeGroup;
+    activeGroup = nullptr;
+    multiSlotCount = 0;
+    multiRowsRemaining = 0;
+    String options;
+    
+    int start = 0;
+    while (start < (int)spec.length()) {
+        int end = spec.indexOf(';', start);
+        if (end < 0) {
+            end = spec.length();
         }
+        String segment = spec.substring(start, end);
+        segment.trim();
+        start = end + 1;
         
-        if (newBottom < innerBound) {
-            serialPort.print("ERROR:Bottom edge would be past center+10 (minimum: ");
-            serialPort.print(innerBound - configBottom);
-            serialPort.println(")");
-            return;
+        if (segment.length() == 0) {
+            continue;
         }
         
-        usableAreaAdjustBottom = adjust;
-        serialPort.print("OK:Bottom edge adjusted to ");
-        serialPort.println(adjust);
-        
-        // Notify if at outer limit
-        if (newBottom >= cfg.height + 10 - 1) {
-            serialPort.print("NOTICE:Bottom edge at maximum outward position (");
-            serialPort.print(cfg.height + 10 - 1);
-            serialPort.println(" pixels, 10 beyond display)");
+        int firstComma = segment.indexOf(',');
+        if (firstComma < 0) {
+            // No comma: a transfer option, as in SIZE
+            options += segment;
+            options += ',';
+            continue;
         }
         
-        // Immediately update display
-        activeDisplay->drawCalibrationFrame(usableAreaAdjustTop, usableAreaAdjustBottom,
-                                           usableAreaAdjustLeft, usableAreaAdjustRight,
-                                           imageFrameColor, imageFrameThickness);
-        
-    } else if (cmd.startsWith("ADJUST_LEFT:")) {
-        // Adjust usable area left edge
-        if (!activeDisplay) {
-            serialPort.println("ERROR:No active display selected");
+        int secondComma = segment.indexOf(',', firstComma + 1);
+        if (secondComma < 0) {
+            sendError("Invalid MULTI slot: " + segment);
             return;
         }
-        
-        String adjustStr = cmd.substring(12);
-        int8_t adjust = adjustStr.toInt();
-        
-        const DisplayConfig& cfg = activeDisplay->getConfig();
-        // Left is inverted: positive adjustment moves edge LEFT (decreases X)
-        int newLeft = cfg.usableX - adjust;
-        
-        // Inner bound: center - 10 pixels
-        // Outer bound: -10 pixels (10 pixels beyond published left edge)
-        int innerBound = cfg.centerX - 10;
-        int outerBound = -10;
-        
-        if (newLeft < outerBound) {
-            serialPort.print("ERROR:Left edge would be beyond limit (maximum adjustment: ");
-            serialPort.print(cfg.usableX - outerBound);
-            serialPort.println(")");
+        if (multiSlotCount >= MAX_MULTI_SLOTS) {
+            sendError("Too many MULTI slots (max " + String(MAX_MULTI_SLOTS) + ")");
             return;
         }
         
-        if (newLeft > innerBound) {
-            serialPort.print("ERROR:Left edge would be past center-10 (minimum adjustment: ");
-            serialPort.print(cfg.usableX - innerBound);
-            serialPort.println(")");
+        String name = segment.substring(0, firstComma);
+        DisplayInstance* display = displayManager.getDisplay(name.c_str());
+        if (!display) {
+            sendError("Display not found: " + name);
             return;
         }
-        
-        usableAreaAdjustLeft = adjust;
-        serialPort.print("OK:Left edge adjusted to ");
-        serialPort.println(adjust);
-        
-        // Notify if at outer limit
-        if (newLeft <= -10) {
-            serialPort.println("NOTICE:Left edge at maximum outward position (-10 pixels beyond display)");
+        for (uint8_t i = 0; i < multiSlotCount; i++) {
+            if (multiSlots[i].display == display) {
+                sendError("Display listed twice: " + name);
+                return;
+            }
         }
         
-        // Immediately update display
-        activeDisplay->drawCalibrationFrame(usableAreaAdjustTop, usableAreaAdjustBottom,
-                                           usableAreaAdjustLeft, usableAreaAdjustRight,
-                                           imageFrameColor, imageFrameThickness);
+        MultiSlot& slot = multiSlots[multiSlotCount];
+        slot.display = display;
+        slot.width = segment.substring(firstComma + 1, secondComma).toInt();
+        slot.height = segment.substring(secondComma + 1).toInt();
+        slot.row = 0;
         
-    } else if (cmd.startsWith("ADJUST_RIGHT:")) {
-        // Adjust usable area right edge
-        if (!activeDisplay) {
-            serialPort.println("ERROR:No active display selected");
+        // Validation and placement work on the active display
+        activeDisplay = display;
+        if (!validateDimensions(slot.width, slot.height) ||
+            !calculateOffsets(slot.width, slot.height, slot.offsetX, slot.offsetY)) {
             return;
         }
+        display->getFrameBounds(slot.clipLeft, slot.clipTop, slot.clipRight, slot.clipBottom,
+                                usableAreaAdjustTop, usableAreaAdjustBottom,
+                                usableAreaAdjustLeft, usableAreaAdjustRight);
         
-        String adjustStr = cmd.substring(13);
-        int8_t adjust = adjustStr.toInt();
-        
-        const DisplayConfig& cfg = activeDisplay->getConfig();
-        int configRight = cfg.usableX + cfg.usableWidth - 1;
-        int newRight = configRight + adjust;
-        
-        // Inner bound: center + 10 pixels
-        // Outer bound: width + 10 - 1 (10 pixels beyond published right edge)
-        int innerBound = cfg.centerX + 10;
-        int outerBound = cfg.width + 10 - 1;
-        
-        if (newRight > outerBound) {
-            serialPort.print("ERROR:Right edge would be beyond limit (maximum: ");
-            serialPort.print(outerBound - configRight);
-            serialPort.println(")");
-            return;
+        multiSlotCount++;
+        multiRowsRemaining += slot.height;
+    }
+    
+    if (multiSlotCount == 0) {
+        sendError("MULTI needs at least one display");
+        return;
+    }
+    
+    if (!parseSizeOptions(options)) {
+        return;
+    }
+    if (deltaMode || tilesEnabled) {
+        sendError(String(deltaMode ? "DELTA" : "TILE") + " is not supported with MULTI", STATUS_ERROR_OPTION);
+        return;
+    }
+    if (frameRotation != NO_FRAME_ROTATION) {
+        sendError("ROT is not supported with MULTI", STATUS_ERROR_OPTION);
+        return;
+    }
+    flowControlEnabled = true;
+    
+    if (textStatus()) {
+        serialPort.println("Clearing displays...");
+    }
+    for (uint8_t i = 0; i < multiSlotCount; i++) {
+        multiSlots[i].display->clear();
+        multiSlots[i].display->discardSnapshot();
+    }
+    
+    sendReady();
+    if (textStatus()) {
+        serialPort.print("Receiving ");
+        serialPort.print(multiSlotCount);
+        serialPort.println(" bitmaps");
+    }
+    
+    transferBytes = 0;
+    transferMicros = 0;
+    currentState = WAITING_FOR_ROW_TAG;
+    if (bitsPerPixel < 16) {
+        beginPalette();
+    }
+}
+
+void SerialProtocol::handleStream(const String& spec) {
+    // Format: STREAM:<name>,<w>,<h>,<fps>[,option...]
+    int widthIndex = spec.indexOf(',');
+    int heightIndex = spec.indexOf(',', widthIndex + 1);
+    int fpsIndex = spec.indexOf(',', heightIndex + 1);
+    if (widthIndex <= 0 || heightIndex < 0 || fpsIndex < 0) {
+        sendError("Expected STREAM:<name>,w,h,fps[,option...]");
+        return;
+    }
+    int optionsIndex = spec.indexOf(',', fpsIndex + 1);
+    
+    String name = spec.substring(0, widthIndex);
+    name.trim();
+    DisplayInstance* display = displayManager.getDisplay(name.c_str());
+    if (!display) {
+        sendError("Display not found: " + name, STATUS_ERROR_DISPLAY);
+        return;
+    }
+    activeGroup = nullptr;
+    activeDisplay = display;
+    
+    if (!parseSizeOptions(optionsIndex > 0 ? spec.substring(optionsIndex + 1) : String())) {
+        return;
+    }
+    if (deltaMode) {
+        sendError("DELTA is not a STREAM option (send FRAME:<n> rectangles)", STATUS_ERROR_OPTION);
+        return;
+    }
+    if (tilesEnabled) {
+        sendError("TILE is not supported with STREAM", STATUS_ERROR_OPTION);
+        return;
+    }
+    if (!beginFrameRotation()) {
+        return;
+    }
+    int fps = (optionsIndex > 0 ? spec.substring(fpsIndex + 1, optionsIndex) : spec.substring(fpsIndex + 1)).toInt();
+    if (fps < 0 || fps > MAX_STREAM_FPS) {
+        sendError("STREAM fps must be 0-" + String(MAX_STREAM_FPS), STATUS_ERROR_OPTION);
+        return;
+    }
+    
+    bitmapWidth = spec.substring(widthIndex + 1, heightIndex).toInt();
+    bitmapHeight = spec.substring(heightIndex + 1, fpsIndex).toInt();
+    if (!validateDimensions(bitmapWidth, bitmapHeight) ||
+        !calculateOffsets(bitmapWidth, bitmapHeight, offsetX, offsetY)) {
+        return;
+    }
+    display->getFrameBounds(clipLeft, clipTop, clipRight, clipBottom,
+                            usableAreaAdjustTop, usableAreaAdjustBottom,
+                            usableAreaAdjustLeft, usableAreaAdjustRight);
+    flowControlEnabled = true;
+    
+    if (textStatus()) {
+        serialPort.println("Clearing display...");
+    }
+    display->clear();
+    display->discardSnapshot();
+    
+    streamActive = true;
+    streamFps = fps;
+    streamInterval = fps > 0 ? 1000000UL / fps : 0;
+    streamDue = micros();
+    streamFrames = 0;
+    streamReportFrames = 0;
+    streamLateFrames = 0;
+    streamRectsRemaining = 0;
+    streamFrameHeld = false;
+    
+    sendReady();
+    if (textStatus()) {
+        serialPort.print("Streaming ");
+        serialPort.print(bitmapWidth);
+        serialPort.print("x");
+        serialPort.print(bitmapHeight);
+        if (fps > 0) {
+            serialPort.print(" at ");
+            serialPort.print(fps);
+            serialPort.println(" fps");
+        } else {
+            serialPort.println(" unpaced");
         }
-        
-        if (newRight < innerBound) {
-            serialPort.print("ERROR:Right edge would be past center+10 (minimum: ");
-            serialPort.print(innerBound - configRight);
-            serialPort.println(")");
+    }
+    
+    transferBytes = 0;
+    transferMicros = 0;
+    currentState = WAITING_FOR_FRAME;
+    if (bitsPerPixel < 16) {
+        beginPalette();
+    }
+}
+
+bool SerialProtocol::streamFrameDue() const {
+    return streamInterval == 0 || (long)(micros() - streamDue) >= 0;
+}
+
+void SerialProtocol::startStreamFrame() {
+    unsigned long now = micros();
+    if (streamFrames == 0) {
+        streamFirstStart = now;
+        streamReportStart = now;
+        streamDue = now;
+    } else if (streamInterval > 0 && now - streamDue >= streamInterval) {
+        // A whole slot behind: restart the schedule here rather than rushing the next frames
+        streamLateFrames++;
+        streamDue = now;
+    }
+    streamDue += streamInterval;
+    streamLastStart = now;
+    streamFrames++;
+    streamReportFrames++;
+    
+    if (now - streamReportStart < FPS_REPORT_INTERVAL) {
+        return;
+    }
+    // Rate over the frames started in the window; this frame opens the next one
+    uint32_t fpsTenths = frameRateTenths(streamReportFrames - 1, now - streamReportStart);
+    streamReportStart = now;
+    streamReportFrames = 1;
+    if (binaryStatus) {
+        sendStatus(STATUS_FPS, fpsTenths > 0xFFFF ? 0xFFFF : fpsTenths);
+    }
+    if (textStatus()) {
+        serialPort.print("FPS:");
+        printTenths(serialPort, fpsTenths);
+        serialPort.println();
+    }
+}
+
+void SerialProtocol::handleStreamFrame(const String& command) {
+    if (command == "FRAME") {
+        startStreamFrame();
+        deltaMode = false;
+        beginRect(0, 0, bitmapWidth, bitmapHeight);
+        return;
+    }
+    
+    if (command.startsWith("FRAME:")) {
+        // Rectangles are drawn over the previous frame; FRAME:0 leaves it on screen
+        int rects = command.substring(6).toInt();
+        if (rects < 0) {
+            sendError("Invalid FRAME rectangle count: " + command.substring(6), STATUS_ERROR_RECT);
             return;
         }
-        
-        usableAreaAdjustRight = adjust;
-        serialPort.print("OK:Right edge adjusted to ");
-        serialPort.println(adjust);
-        
-        // Notify if at outer limit
-        if (newRight >= cfg.width + 10 - 1) {
-            serialPort.print("NOTICE:Right edge at maximum outward position (");
-            serialPort.print(cfg.width + 10 - 1);
-            serialPort.println(" pixels, 10 beyond display)");
+        startStreamFrame();
+        deltaMode = true;
+        streamRectsRemaining = rects;
+        if (rects > 0) {
+            currentState = WAITING_FOR_RECT;
         }
-        
-        // Immediately update display
-        activeDisplay->drawCalibrationFrame(usableAreaAdjustTop, usableAreaAdjustBottom,
-                                           usableAreaAdjustLeft, usableAreaAdjustRight,
-                                           imageFrameColor, imageFrameThickness);
-        
-    } else if (cmd == "CALIBRATE") {
-        // Show calibration pattern on active display
-        if (!activeDisplay) {
-            serialPort.println("ERROR:No active display selected");
-            return;
+        return;
+    }
+    
+    if (command == "STREAM_END") {
+        uint32_t fpsTenths = streamFrames > 1
+            ? frameRateTenths(streamFrames - 1, streamLastStart - streamFirstStart) : 0;
+        if (binaryStatus) {
+            sendStatus(STATUS_FPS, fpsTenths > 0xFFFF ? 0xFFFF : fpsTenths);
         }
-        
-        serialPort.print("OK:Showing calibration pattern on ");
-        serialPort.println(activeDisplay->getName());
-        activeDisplay->drawCalibrationFrame(usableAreaAdjustTop, usableAreaAdjustBottom,
-                                           usableAreaAdjustLeft, usableAreaAdjustRight,
-                                           imageFrameColor, imageFrameThickness);
-        serialPort.println("Calibration pattern displayed");
-        
-    } else if (cmd.startsWith("UPDATE_CONFIG:")) {
-        // Update base configuration values
-        // Format: UPDATE_CONFIG:left,right,top,bottom,centerX,centerY
-        if (!activeDisplay) {
-            serialPort.println("ERROR:No active display selected");
-            return;
+        if (textStatus()) {
+            serialPort.print("Stream: ");
+            serialPort.print(streamFrames);
+            serialPort.print(" frames, ");
+            printTenths(serialPort, fpsTenths);
+            serialPort.print(" fps (target ");
+            serialPort.print(streamFps);
+            serialPort.print("), ");
+            serialPort.print(streamLateFrames);
+            serialPort.println(" late");
         }
-        
-        String params = cmd.substring(14);  // Skip "UPDATE_CONFIG:"
-        int values[6];
-        int idx = 0;
-        int start = 0;
-        
-        // Parse comma-separated values
-        for (int i = 0; i <= params.length(); i++) {
-            if (i == params.length() || params.charAt(i) == ',') {
-                if (idx >= 6) {
-                    serialPort.println("ERROR:Too many parameters");
-                    return;
+        streamActive = false;
+        deltaMode = false;
+        finishBitmap();
+        return;
+    }
+    
+    if (command.length() > 0) {
+        sendError("Expected FRAME, FRAME:<n> or STREAM_END, got: " + command);
+    }
+}
+
+bool SerialProtocol::placeGroupMembers() {
+    // Each member centers the bitmap in its own usable area (in its own rotation);
+    // a bitmap larger than a member's area is cropped by that member's frame bounds
+    for (uint8_t i = 0; i < activeGroup->memberCount; i++) {
+        DisplayInstance* member = activeGroup->members[i];
+        MultiSlot& slot = groupSlots[i];
+        
+        slot.display = member;
+        slot.width = bitmapWidth;
+        slot.height = bitmapHeight;
+        member->centerInUsableArea(bitmapWidth, bitmapHeight, slot.offsetX, slot.offsetY);
+        slot.row = 0;
+        member->getFrameBounds(slot.clipLeft, slot.clipTop, slot.clipRight, slot.clipBottom,
+                               usableAreaAdjustTop, usableAreaAdjustBottom,
+                               usableAreaAdjustLeft, usableAreaAdjustRight);
+        
+        if (textStatus()) {
+            serialPort.print("Group member ");
+            serialPort.print(member->getName());
+            serialPort.print(" offset: (");
+            serialPort.print(slot.offsetX);
+            serialPort.print(", ");
+            serialPort.print(slot.offsetY);
+            serialPort.println(")");
+        }
+    }
+    
+    offsetX = groupSlots[0].offsetX;
+    offsetY = groupSlots[0].offsetY;
+    return true;
+}
+
+void SerialProtocol::loadSlot(const MultiSlot& slot) {
+    activeDisplay = slot.display;
+    bitmapWidth = slot.width;
+    bitmapHeight = slot.height;
+    offsetX = slot.offsetX;
+    offsetY = slot.offsetY;
+    clipLeft = slot.clipLeft;
+    clipTop = slot.clipTop;
+    clipRight = slot.clipRight;
+    clipBottom = slot.clipBottom;
+}
+
+void SerialProtocol::handleRowTag() {
+    // Each row packet starts with the slot index of the display it belongs to
+    uint8_t tag = serialPort.read();
+    PerfStats::countBytes(1);
+    if (transferBytes == 0) {
+        transferStartMicros = micros();
+    }
+    transferBytes++;
+    
+    if (tag >= multiSlotCount) {
+        sendError("Invalid MULTI slot index: " + String(tag), STATUS_ERROR_MULTI);
+        return;
+    }
+    MultiSlot& slot = multiSlots[tag];
+    if (slot.row >= slot.height) {
+        sendError("Too many rows for MULTI slot " + String(tag), STATUS_ERROR_MULTI);
+        return;
+    }
+    
+    // Switch the reception state over to this slot's display and placement
+    multiSlot = tag;
+    loadSlot(slot);
+    
+    beginRect(0, slot.row, slot.width, 1);
+    handleDataReception();
+}
+
+void SerialProtocol::handleTileStream() {
+    // Between tiles: a tile header, a text line (BMPEnd, CMD:) or the rest of a
+    // damaged tile, which is skipped up to the next TILE_SYNC
+    while (currentState == WAITING_FOR_TILE && serialPort.available()) {
+        uint8_t c = serialPort.read();
+        PerfStats::countBytes(1);
+        
+        if (tileBytesReceived > 0) {
+            tileBytes[tileBytesReceived++ - 1] = c;
+            if (tileBytesReceived == 3) {
+                tileBytesReceived = 0;
+                uint16_t seq = tileBytes[0] | (tileBytes[1] << 8);
+                if (seq < tileCount) {
+                    startTile(seq);
                 }
-                values[idx++] = params.substring(start, i).toInt();
-                start = i + 1;
             }
+            continue;
         }
         
-        if (idx != 6) {
-            serialPort.println("ERROR:Expected 6 parameters (left,right,top,bottom,centerX,centerY)");
-            return;
+        if (c == TILE_SYNC) {
+            tileBytesReceived = 1;
+            lineLength = 0;
+            lineOverflow = false;
+            continue;
         }
         
-        // Update the display's configuration
-        DisplayConfig& cfg = const_cast<DisplayConfig&>(activeDisplay->getConfig());
-        cfg.usableX = values[0];  // left
-        cfg.usableWidth = values[1] - values[0] + 1;  // width from right-left+1
-        cfg.usableY = values[2];  // top
-        cfg.usableHeight = values[3] - values[2] + 1;  // height from bottom-top+1
-        cfg.centerX = values[4];
-        cfg.centerY = values[5];
-        
-        // Reset adjustments since we're committing to new base config
-        usableAreaAdjustTop = 0;
-        usableAreaAdjustBottom = 0;
-        usableAreaAdjustLeft = 0;
-        usableAreaAdjustRight = 0;
-        
-        serialPort.println("OK:Base configuration updated");
-        serialPort.print("New usable area: ");
-        serialPort.print(cfg.usableX);
-        serialPort.print(",");
-        serialPort.print(cfg.usableX + cfg.usableWidth - 1);
-        serialPort.print(",");
-        serialPort.print(cfg.usableY);
-        serialPort.print(",");
-        serialPort.println(cfg.usableY + cfg.usableHeight - 1);
-        serialPort.print("New center: ");
-        serialPort.print(cfg.centerX);
-        serialPort.print(",");
-        serialPort.println(cfg.centerY);
-        serialPort.println("NOTE:Changes lost on power cycle - update .config file for permanent storage");
-        
-    } else if (cmd.startsWith("ORIENTATION:")) {
-        // Set display orientation/rotation
-        // Format: ORIENTATION:value (0-3)
-        if (!activeDisplay) {
-            serialPort.println("ERROR:No active display selected");
-            return;
+        if (c != '\n') {
+            if (lineLength < MAX_LINE_LENGTH) {
+                lineBuffer[lineLength++] = c;
+            } else {
+                lineOverflow = true;
+            }
+            continue;
         }
         
-        int rotation = cmd.substring(12).toInt();  // Skip "ORIENTATION:"
-        
-        if (rotation < 0 || rotation > 3) {
-            serialPort.println("ERROR:Invalid orientation. Use 0-3 (0=Portrait, 1=Landscape, 2=Reverse Portrait, 3=Reverse Landscape)");
-            return;
+        bool complete = !lineOverflow;
+        lineBuffer[lineLength] = '\0';
+        lineLength = 0;
+        lineOverflow = false;
+        char* line = trimInPlace(lineBuffer);
+        if (!complete) {
+            continue;
         }
-        
-        Adafruit_ST7735* tft = activeDisplay->getTFT();
-        if (!tft) {
-            serialPort.println("ERROR:Display not initialized");
-            return;
+        if (strcmp(line, "BMPEnd") == 0) {
+            finishTiles();
+        } else if (strncmp(line, "CMD:", 4) == 0) {
+            handleMenuCommand(line + 4);
         }
-        
-        tft->setRotation(rotation);
-        serialPort.print("OK:Orientation set to ");
-        serialPort.println(rotation);
-        
-    } else if (cmd == "HELP") {
-        // Show command help
-        serialPort.println("OK:HELP");
-        serialPort.println("Available CMD: commands:");
-        serialPort.println("  CMD:LIST - List all displays");
-        serialPort.println("  CMD:INFO - Show active display info");
-        serialPort.println("  CMD:TEST - Test active display");
-        serialPort.println("  CMD:TEST_ALL - Test all displays");
-        serialPort.println("  CMD:FRAME_ON - Enable frame");
-        serialPort.println("  CMD:FRAME_OFF - Disable frame");
-        serialPort.println("  CMD:FRAME_COLOR:value - Set frame color (0-65535)");
-        serialPort.println("  CMD:FRAME_THICKNESS:value - Set thickness (1-10)");
-        serialPort.println("  CMD:ADJUST_TOP:value - Adjust top edge (relative to config)");
-        serialPort.println("  CMD:ADJUST_BOTTOM:value - Adjust bottom edge");
-        serialPort.println("  CMD:ADJUST_LEFT:value - Adjust left edge");
-        serialPort.println("  CMD:ADJUST_RIGHT:value - Adjust right edge");
-        serialPort.println("  CMD:CALIBRATE - Show calibration pattern");
-        serialPort.println("  CMD:UPDATE_CONFIG:left,right,top,bottom,centerX,centerY - Update base config");
-        serialPort.println("  CMD:ORIENTATION:value - Set rotation (0=Portrait, 1=Landscape, 2=Rev Portrait, 3=Rev Landscape)");
-        serialPort.println("  CMD:HELP - Show this help");
-        serialPort.println();
-        serialPort.println("Bitmap protocol commands:");
-        serialPort.println("  DISPLAY:<name> - Select display for bitmap");
-        serialPort.println("  BMPStart - Start bitmap transfer");
-        serialPort.println("  SIZE:width,height - Set bitmap dimensions");
-        serialPort.println("  <pixel data> - Send RGB565 pixel data");
-        serialPort.println("  BMPEnd - End bitmap transfer");
-        serialPort.println("END_HELP");
-        
-    } else {
-        serialPort.print("ERROR:Unknown command: ");
-        serialPort.println(cmd);
     }
 }
 
-void SerialProtocol::handleStart() {
-    // Ensure we have an active display before accepting bitmap
-    if (!activeDisplay) {
-        sendError("No active display selected");
-        currentState = WAITING_FOR_DISPLAY_SELECT;
-        return;
+void SerialProtocol::handleTileCrc() {
+    while (tileBytesReceived < 2 && serialPort.available()) {
+        tileBytes[tileBytesReceived++] = serialPort.read();
+        PerfStats::countBytes(1);
     }
-    
-    String command = serialPort.readStringUntil('\n');
-    command.trim();
-    
-    // Handle CMD: commands in any state
-    if (command.startsWith("CMD:")) {
-        handleMenuCommand(command.substring(4));
+    if (tileBytesReceived < 2) {
         return;
     }
     
-    if (command == "BMPStart") {
-        serialPort.println("Start marker received");
-        currentState = WAITING_FOR_SIZE;
-    } else if (command.length() > 0) {
-        sendError("Expected BMPStart, got: " + command);
+    tileBytesReceived = 0;
+    currentState = WAITING_FOR_TILE;
+    if ((uint16_t)(tileBytes[0] | (tileBytes[1] << 8)) == tileCrc) {
+        tilesVerified[tileSeq / 8] |= 1 << (tileSeq % 8);
+    } else {
+        sendNack(tileSeq);
     }
 }
 
-void SerialProtocol::handleSize() {
-    String sizeCommand = serialPort.readStringUntil('\n');
-    sizeCommand.trim();
+void SerialProtocol::startTile(uint16_t seq) {
+    // Until its CRC checks out the tile counts as missing, even if an earlier copy was good:
+    // this one is drawn over it
+    tileSeq = seq;
+    tileCrc = crc16Update(0xFFFF, tileBytes, 2);
+    tilesVerified[seq / 8] &= ~(1 << (seq % 8));
     
-    if (sizeCommand.startsWith("SIZE:")) {
-        int commaIndex = sizeCommand.indexOf(',');
-        if (commaIndex > 0) {
-            bitmapWidth = sizeCommand.substring(5, commaIndex).toInt();
-            bitmapHeight = sizeCommand.substring(commaIndex + 1).toInt();
-            
-            if (validateDimensions(bitmapWidth, bitmapHeight) && 
-                calculateOffsets(bitmapWidth, bitmapHeight, offsetX, offsetY)) {
-                
-                // Clear display BEFORE sending READY
-                if (activeDisplay) {
-                    serialPort.println("Clearing display...");
-                    activeDisplay->getTFT()->fillScreen(ST77XX_BLACK);
-                    delay(50);  // Brief delay to ensure clear completes
-                }
-                
-                serialPort.println("READY");
-                serialPort.print("Receiving bitmap: ");
-                serialPort.print(bitmapWidth);
-                serialPort.print("x");
-                serialPort.println(bitmapHeight);
-                
-                currentRow = 0;
-                currentCol = 0;
-                currentState = RECEIVING_DATA;
-                
-                serialPort.print("Ready to receive ");
-                serialPort.print(bitmapWidth * bitmapHeight);
-                serialPort.println(" pixels");
-            }
-        } else {
-            sendError("Invalid size format");
-        }
+    int x = (seq % tileColumns) * TILE_SIZE;
+    int y = (seq / tileColumns) * TILE_SIZE;
+    int width = bitmapWidth - x;
+    int height = bitmapHeight - y;
+    beginRect(x, y, width < TILE_SIZE ? width : TILE_SIZE, height < TILE_SIZE ? height : TILE_SIZE);
+}
+
+void SerialProtocol::abandonTile() {
+    // Bytes of the tile were lost; whatever arrives next is scanned for a header
+    bool tileStarted = currentState != WAITING_FOR_TILE;
+    DisplayInstance::waitForTransfer();
+    PerfStats::endStall();
+    currentState = WAITING_FOR_TILE;
+    tileBytesReceived = 0;
+    if (tileStarted) {
+        sendNack(tileSeq);
     }
 }
 
-void SerialProtocol::handleDataReception() {
-    if (!activeDisplay) {
-        sendError("No active display");
+void SerialProtocol::finishTiles() {
+    int missing = 0;
+    for (int seq = 0; seq < tileCount; seq++) {
+        if ((tilesVerified[seq / 8] & (1 << (seq % 8))) == 0) {
+            sendNack(seq);
+            missing++;
+        }
+    }
+    if (missing == 0) {
+        finishBitmap();
         return;
     }
     
-    Adafruit_ST7735* tft = activeDisplay->getTFT();
+    // The host resends the NACKed tiles and BMPEnd again
+    if (binaryStatus) {
+        sendStatus(STATUS_RESEND, missing);
+    } else {
+        serialPort.print("RESEND:");
+        serialPort.println(missing);
+    }
+}
+
+void SerialProtocol::sendNack(uint16_t seq) {
+    PerfStats::countTileNack();
+    if (binaryStatus) {
+        sendStatus(STATUS_NACK, seq);
+    } else {
+        serialPort.print("NACK:");
+        serialPort.println(seq);
+    }
+}
+
+void SerialProtocol::handleEnd(const String& endCommand) {
+    if (endCommand == "BMPEnd") {
+        finishBitmap();
+    }
+}
+
+void SerialProtocol::finishBitmap() {
+    // The frame borders are drawn in each display's own rotation
+    endFrameRotation();
     
-    // Read pixel data (2 bytes per pixel for RGB565)
-    while (serialPort.available() >= 2 && currentState == RECEIVING_DATA) {
-        if (currentRow >= bitmapHeight) {
-            currentState = WAITING_FOR_END;
-            break;
+    if (multiSlotCount > 0) {
+        if (imageFrameEnabled) {
+            for (uint8_t i = 0; i < multiSlotCount; i++) {
+                multiSlots[i].display->drawImageFrame(imageFrameColor, imageFrameThickness);
+            }
         }
-        
-        // Read RGB565 pixel data (big-endian)
-        uint8_t highByte = serialPort.read();
-        uint8_t lowByte = serialPort.read();
-        uint16_t pixelColor = (highByte << 8) | lowByte;
-        
-        // Calculate pixel position
-        int displayX = currentCol + offsetX;
-        int displayY = currentRow + offsetY;
-        
-        // Draw pixel with frame bounds checking (acts as cropping guide)
-        // Frame adjustments define the visible area regardless of frame visibility
-        if (activeDisplay->isWithinFrameBounds(displayX, displayY,
-                                              usableAreaAdjustTop, usableAreaAdjustBottom,
-                                              usableAreaAdjustLeft, usableAreaAdjustRight)) {
-            tft->drawPixel(displayX, displayY, pixelColor);
-        }
-        
-        // Advance to next pixel
-        currentCol++;
-        if (currentCol >= bitmapWidth) {
-            currentCol = 0;
-            currentRow++;
-            
-            // Progress indication every PROGRESS_REPORT_INTERVAL rows
-            if (currentRow % PROGRESS_REPORT_INTERVAL == 0 && currentRow < bitmapHeight) {
-                float progress = (float)currentRow / bitmapHeight * 100.0f;
-                serialPort.print("Progress: ");
-                serialPort.print(progress, 1);
-                serialPort.print("% (Row ");
-                serialPort.print(currentRow);
-                serialPort.print("/");
-                serialPort.print(bitmapHeight);
-                serialPort.println(")");
+        activeDisplay = multiPreviousDisplay;
+        activeGroup = multiPreviousGroup;
+        multiSlotCount = 0;
+    } else if (activeGroup) {
+        if (imageFrameEnabled) {
+            for (uint8_t i = 0; i < activeGroup->memberCount; i++) {
+                activeGroup->members[i]->drawImageFrame(imageFrameColor, imageFrameThickness);
             }
         }
+        loadSlot(groupSlots[0]);
+    } else if (imageFrameEnabled && activeDisplay) {
+        // Draw frame if enabled
+        activeDisplay->drawImageFrame(imageFrameColor, imageFrameThickness);
     }
-}
-
-void SerialProtocol::handleEnd() {
-    String endCommand = serialPort.readStringUntil('\n');
-    endCommand.trim();
     
-    if (endCommand == "BMPEnd") {
-        // Draw frame if enabled
-        if (imageFrameEnabled && activeDisplay) {
-            activeDisplay->drawImageFrame(imageFrameColor, imageFrameThickness);
+    if (storeImageId.length() > 0) {
+        if (!imageStore->commitImage()) {
+            sendError("Image store write failed", STATUS_ERROR_STORE);
+            return;
         }
-        
-        currentState = BITMAP_COMPLETE;
+        if (binaryStatus) {
+            sendStatus(STATUS_STORED, 0);
+        }
+        if (textStatus()) {
+            serialPort.print("STORED:");
+            serialPort.println(storeImageId);
+        }
+        storeImageId = "";
+    }
+    
+    snapshotRequested = false;
+    currentState = BITMAP_COMPLETE;
+    if (binaryStatus) {
+        uint32_t millisTaken = transferMicros / 1000;
+        sendStatus(STATUS_COMPLETE, millisTaken > 0xFFFF ? 0xFFFF : millisTaken);
+    }
+    if (textStatus()) {
         serialPort.println("COMPLETE");
         serialPort.println("Bitmap display completed successfully!");
     }
 }
 
 void SerialProtocol::handleComplete() {
-    // Ready for next bitmap - stay in display selected mode
-    currentState = WAITING_FOR_START;
+    // Ready for next bitmap - stay in display selected mode (if one was selected before MULTI)
+    currentState = activeDisplay ? WAITING_FOR_START : WAITING_FOR_DISPLAY_SELECT;
     bitmapWidth = 0;
     bitmapHeight = 0;
     currentRow = 0;
-    currentCol = 0;
+    rowBytesReceived = 0;
     offsetX = 0;
     offsetY = 0;
-    serialPort.println("Ready for next bitmap");
+    if (textStatus()) {
+        serialPort.println("Ready for next bitmap");
+    }
+    binaryStatus = false;
+    tilesEnabled = false;
+    bitsPerPixel = 16;
+}
+
+bool SerialProtocol::parseSizeOptions(const String& options) {
+    // Options are comma-separated tokens after SIZE:width,height
+    flowControlEnabled = false;
+    deltaMode = false;
+    rleEnabled = false;
+    binaryStatus = false;
+    tilesEnabled = false;
+    bitsPerPixel = 16;
+    frameRotation = NO_FRAME_ROTATION;
+    
+    int start = 0;
+    while (start < (int)options.length()) {
+        int end = options.indexOf(',', start);
+        if (end < 0) {
+            end = options.length();
+        }
+        String option = options.substring(start, end);
+        option.trim();
+        start = end + 1;
+        
+        if (option.length() == 0) {
+            continue;
+        }
+        
+        if (option == "CREDIT") {
+            flowControlEnabled = true;
+        } else if (option == "DELTA") {
+            deltaMode = true;
+        } else if (option == "RLE") {
+            rleEnabled = true;
+        } else if (option == "BINARY") {
+            binaryStatus = true;
+        } else if (option == "TILE") {
+            tilesEnabled = true;
+        } else if (option.startsWith("BPP:")) {
+            int bits = option.substring(4).toInt();
+            if (bits != 1 && bits != 2 && bits != 4 && bits != 8 && bits != 16) {
+                sendError("BPP must be 1, 2, 4, 8 or 16: " + option, STATUS_ERROR_OPTION);
+                return false;
+            }
+            bitsPerPixel = bits;
+        } else if (option.startsWith("ROT:")) {
+            String value = option.substring(4);
+            if (value.length() != 1 || value[0] < '0' || value[0] > '3') {
+                sendError("ROT must be 0-3: " + option, STATUS_ERROR_OPTION);
+                return false;
+            }
+            frameRotation = value[0] - '0';
+        } else {
+            sendError("Unknown SIZE option: " + option, STATUS_ERROR_OPTION);
+            return false;
+        }
+    }
+    
+    // RLE and tile packets carry RGB565 pixels
+    if (bitsPerPixel < 16 && (rleEnabled || tilesEnabled)) {
+        sendError("BPP cannot be combined with RLE or TILE", STATUS_ERROR_OPTION);
+        return false;
+    }
+    return true;
 }
 
 bool SerialProtocol::validateDimensions(int width, int height) {
     if (!activeDisplay) {
-        sendError("No active display selected");
+        sendError("No active display selected", STATUS_ERROR_DISPLAY);
         return false;
     }
     
@@ -765,30 +3031,38 @@ bool SerialProtocol::validateDimensions(int width, int height) {
     
     // Check for negative or zero dimensions
     if (width <= 0 || height <= 0) {
-        sendError("Invalid dimensions: width=" + String(width) + ", height=" + String(height));
+        sendError("Invalid dimensions: width=" + String(width) + ", height=" + String(height), STATUS_ERROR_DIMENSIONS);
         return false;
     }
     
     // Check against maximum allowed dimensions
     if (width > MAX_DIMENSION || height > MAX_DIMENSION) {
-        sendError("Dimensions too large: width=" + String(width) + ", height=" + String(height));
+        sendError("Dimensions too large: width=" + String(width) + ", height=" + String(height), STATUS_ERROR_DIMENSIONS);
+        return false;
+    }
+    
+    // Group members crop to their own usable area instead
+    if (!activeGroup && width > cfg.usableWidth) {
+        sendError("Width " + String(width) + " exceeds usable width " + String(cfg.usableWidth), STATUS_ERROR_DIMENSIONS);
         return false;
     }
     
-    if (width > cfg.usableWidth) {
-        sendError("Width " + String(width) + " exceeds usable width " + String(cfg.usableWidth));
+    if (!activeGroup && height > cfg.usableHeight) {
+        sendError("Height " + String(height) + " exceeds usable height " + String(cfg.usableHeight), STATUS_ERROR_DIMENSIONS);
         return false;
     }
     
-    if (height > cfg.usableHeight) {
-        sendError("Height " + String(height) + " exceeds usable height " + String(cfg.usableHeight));
+    if (width > MAX_ROW_PIXELS) {
+        sendError("Width " + String(width) + " exceeds row buffer " + String(MAX_ROW_PIXELS), STATUS_ERROR_DIMENSIONS);
         return false;
     }
     
-    serialPort.print("Dimensions validated: ");
-    serialPort.print(width);
-    serialPort.print("x");
-    serialPort.println(height);
+    if (textStatus()) {
+        serialPort.print("Dimensions validated: ");
+        serialPort.print(width);
+        serialPort.print("x");
+        serialPort.println(height);
+    }
     return true;
 }
 
@@ -797,16 +3071,12 @@ bool SerialProtocol::calculateOffsets(int bmpWidth, int bmpHeight, int& offsetX,
         return false;
     }
     
-    const DisplayConfig& cfg = activeDisplay->getConfig();
-    
     // Calculate centering offsets within usable area
-    int usableCenterX = cfg.usableX + cfg.usableWidth / 2;
-    int usableCenterY = cfg.usableY + cfg.usableHeight / 2;
+    activeDisplay->centerInUsableArea(bmpWidth, bmpHeight, offsetX, offsetY);
     int bitmapCenterX = bmpWidth / 2;
     int bitmapCenterY = bmpHeight / 2;
-    
-    offsetX = usableCenterX - bitmapCenterX;
-    offsetY = usableCenterY - bitmapCenterY;
+    int usableCenterX = offsetX + bitmapCenterX;
+    int usableCenterY = offsetY + bitmapCenterY;
     
     // Verify bounds
     int minX = offsetX;
@@ -816,10 +3086,14 @@ bool SerialProtocol::calculateOffsets(int bmpWidth, int bmpHeight, int& offsetX,
     
     if (!activeDisplay->isWithinBounds(minX, minY) || 
         !activeDisplay->isWithinBounds(maxX, maxY)) {
-        sendError("Calculated bitmap position exceeds bounds");
+        sendError("Calculated bitmap position exceeds bounds", STATUS_ERROR_DIMENSIONS);
         return false;
     }
     
+    if (!textStatus()) {
+        return true;
+    }
+    
     serialPort.print("Usable center: (");
     serialPort.print(usableCenterX);
     serialPort.print(", ");
@@ -851,37 +3125,80 @@ bool SerialProtocol::calculateOffsets(int bmpWidth, int bmpHeight, int& offsetX,
     return true;
 }
 
-void SerialProtocol::sendError(const String& message) {
-    serialPort.print("ERROR: ");
-    serialPort.println(message);
+void SerialProtocol::sendError(const String& message, uint16_t code) {
+    if (binaryStatus) {
+        sendStatus(STATUS_ERROR, code);
+    }
+    if (textStatus()) {
+        serialPort.print("ERROR: ");
+        serialPort.println(message);
+    }
     
     // Display error on active display
+    endFrameRotation();
     if (activeDisplay && activeDisplay->getTFT()) {
-        Adafruit_ST7735* tft = activeDisplay->getTFT();
-        tft->fillScreen(ST77XX_RED);
-        tft->setTextColor(ST77XX_WHITE);
-        tft->setTextSize(1);
-        tft->setCursor(5, 10);
-        tft->println("ERROR:");
-        tft->setCursor(5, 25);
-        tft->println(message);
+        Adafruit_GFX* gfx = activeDisplay->beginFrame();
+        gfx->fillScreen(ST77XX_RED);
+        gfx->setTextColor(ST77XX_WHITE);
+        gfx->setTextSize(1);
+        gfx->setCursor(5, 10);
+        gfx->println("ERROR:");
+        gfx->setCursor(5, 25);
+        gfx->println(message);
+        activeDisplay->endFrame();
     }
     
     reset();
 }
 
+void SerialProtocol::sendStatus(uint8_t type, uint16_t value) {
+    uint8_t packet[4] = { STATUS_SYNC, type, (uint8_t)(value & 0xFF), (uint8_t)(value >> 8) };
+    serialPort.write(packet, sizeof(packet));
+}
+
 void SerialProtocol::reset() {
+    endFrameRotation();
+    frameRotation = NO_FRAME_ROTATION;
+    
+    // A snapshot of an unfinished transfer is incomplete
+    if (snapshotRequested) {
+        uint8_t count = activeGroup ? activeGroup->memberCount : (activeDisplay ? 1 : 0);
+        for (uint8_t i = 0; i < count; i++) {
+            (activeGroup ? activeGroup->members[i] : activeDisplay)->discardSnapshot();
+        }
+        snapshotRequested = false;
+    }
+    
     currentState = WAITING_FOR_DISPLAY_SELECT;
+    binaryStatus = false;
+    streamActive = false;
+    streamFrameHeld = false;
+    tilesEnabled = false;
+    bitsPerPixel = 16;
     activeDisplay = nullptr;
+    activeGroup = nullptr;
+    multiSlotCount = 0;
+    if (imageStore) {
+        imageStore->abortImage();
+    }
+    storeImageId = "";
     bitmapWidth = 0;
     bitmapHeight = 0;
     currentRow = 0;
-    currentCol = 0;
+    rowBytesReceived = 0;
     offsetX = 0;
     offsetY = 0;
 }
 
 void SerialProtocol::checkTimeout() {
+    // A tile that stops arriving lost bytes on the way: NACK it and resynchronize
+    if (tilesEnabled &&
+        (currentState == RECEIVING_DATA || currentState == WAITING_FOR_TILE_CRC ||
+         (currentState == WAITING_FOR_TILE && tileBytesReceived > 0)) &&
+        millis() - lastActivity > TILE_TIMEOUT_MS) {
+        abandonTile();
+    }
+    
     // Only apply timeout to states where data transmission is in progress
     // Do NOT timeout on WAITING_FOR_DISPLAY_SELECT, WAITING_FOR_START, or BITMAP_COMPLETE
     // This allows users unlimited time to select displays and browse for image files
@@ -889,8 +3206,11 @@ void SerialProtocol::checkTimeout() {
         currentState != WAITING_FOR_START &&
         currentState != BITMAP_COMPLETE && 
         (millis() - lastActivity > TIMEOUT_MS)) {
-        sendError("Timeout waiting for data");
-        serialPort.println("Timeout - resetting protocol");
+        bool text = textStatus();
+        sendError("Timeout waiting for data", STATUS_ERROR_TIMEOUT);
+        if (text) {
+            serialPort.println("Timeout - resetting protocol");
+        }
         reset();  // Actually reset the protocol state
         lastActivity = millis();  // Reset timeout counter
     }
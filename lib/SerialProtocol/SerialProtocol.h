@@ -11,22 +11,160 @@
  *   CMD:TEST_ALL - Test all displays
  *   CMD:FRAME_ON - Enable frame
  *   CMD:FRAME_OFF - Disable frame
+ *   CMD:SHADOW_ON - Shadow framebuffer for the active display: drawing is
+ *                   composed in RAM and only changed tiles are sent (40 KB)
+ *   CMD:SHADOW_OFF - Draw straight to the panel again
  *   CMD:FRAME_COLOR:value - Set frame color (0-65535)
  *   CMD:FRAME_THICKNESS:value - Set frame thickness (1-10)
+ *   CMD:ORIENTATION:value - Rotate the active display (0-3). Calibration and
+ *                 the snapshot follow, so frames sized for the configured
+ *                 orientation are shown upright (and the snapshot repainted)
+ *                 without re-rendering; after a quarter turn a frame must fit
+ *                 the rotated usable area, or be sent with SIZE option ROT
+ *   CMD:THROUGHPUT - Show pixel throughput of the last transfer (bytes/s)
+ *   CMD:STATS - Performance counters since boot or CMD:STATS_RESET
+ *               (PerfStats.h): serial bytes, receive/SPI time, clipped
+ *               pixels, data stalls, heap and loop() spacing
+ *   CMD:STATS_RESET - Zero the performance counters
+ *   CMD:GROUPS - List display groups
+ *   CMD:GROUP:<name>:<display>[,<display>...] - Define (replace) a display group
+ *   CMD:SNAPSHOTS - Show snapshot pool usage and slots
+ *   CMD:REPAINT - Redraw the image kept by BMPStart:SNAPSHOT (with black
+ *                 surround and frame) from RAM, no re-send needed
+ *   CMD:REPAINT:x,y,w,h - Redraw only that rectangle (display coordinates)
+ *   CMD:BATCH:<cmd>;<cmd>... - Apply up to 16 calibration commands (FRAME_COLOR,
+ *                 FRAME_THICKNESS, ADJUST_*, UPDATE_CONFIG, ORIENTATION, CALIBRATE;
+ *                 no CMD: prefix) as one: the frame is redrawn once at the end and
+ *                 a single OK:/ERROR: line is returned. If any command fails, the
+ *                 settings are restored to what they were before the batch.
+ *   CMD:DEBUG_ON / CMD:DEBUG_OFF - Keep the text status lines in BINARY transfers
  *   CMD:HELP - Show command help
  *   Responses: OK:<data> or ERROR:<message>
  * 
  * DISPLAY: - Bitmap protocol (existing)
  * 1. Client: "DISPLAY:<device_name>"  -> Select target display
+ *    or "DISPLAY:GROUP:<group_name>" -> Mirror the bitmap to every member;
+ *    each member centers it in its own usable area and clips to its own frame
  * 2. Arduino: "DISPLAY_READY" or "DISPLAY_ERROR"
- * 3. Client: "BMPStart"
+ * 3. Client: "BMPStart", or "BMPStart:SNAPSHOT" to also keep the visible part of
+ *    the image in the snapshot pool while it is drawn (for CMD:REPAINT). DELTA
+ *    updates keep such a snapshot current; other transfers discard it.
  * 4. Arduino: "Start marker received"
- * 5. Client: "SIZE:width,height"
+ * 5. Client: "SIZE:width,height[,option...]"
  * 6. Arduino: "READY" (after validation)
  * 7. Client: Raw pixel data (RGB565, 2 bytes per pixel)
  * 8. Arduino: Progress updates
  * 9. Client: "BMPEnd"
  * 10. Arduino: "COMPLETE"
+ * 
+ * SIZE options:
+ *   CREDIT - Credit-based flow control. After READY the Arduino sends
+ *            "CREDITS:<n>"; the client may send that many rows ahead and
+ *            gets "CREDIT:1" back for each row the Arduino has consumed.
+ *   DELTA  - Dirty-rectangle update of the bitmap already on screen. The
+ *            display is not cleared; instead of a full frame the client
+ *            sends any number of "RECT:x,y,w,h" lines (bitmap coordinates),
+ *            each followed by w*h pixels, then "BMPEnd".
+ *   RLE    - Run-length encoded pixel data. Each row (of the bitmap or of a
+ *            RECT) is a sequence of packets that never span rows:
+ *              header 0x80|(n-1), then 1 pixel   -> n copies of that pixel
+ *              header (n-1), then n pixels       -> n literal pixels
+ *            with 1 <= n <= 128. Credits still count rows.
+ *   BINARY - Binary status channel for the rest of the transfer: instead of
+ *            text lines the Arduino sends 4-byte packets
+ *              0xFF, type, value (uint16, little-endian)
+ *            'R' READY (value = credits, 0 without CREDIT), 'C' CREDIT (rows
+ *            consumed), 'P' PROGRESS (rows received, without CREDIT only),
+ *            'S' STORED, 'K' COMPLETE (transfer time in ms), 'F' achieved
+ *            frame rate * 10 (STREAM), 'E' ERROR (a StatusError code). Text lines appear only in debug mode
+ *            (CMD:DEBUG_ON); 0xFF never starts a text line.
+ *   TILE   - Checked tiles with selective retransmit (not with CREDIT, DELTA,
+ *            RLE or IMG:STORE). The bitmap is cut into TILE_SIZE x TILE_SIZE
+ *            tiles numbered row by row (edge tiles are smaller); each is sent
+ *            as one packet in any order:
+ *              0xA5, seq (uint16 LE), tile pixels row by row, CRC (uint16 LE)
+ *            with the CRC-16/CCITT-FALSE (poly 0x1021, init 0xFFFF) of the seq
+ *            bytes and pixels. A tile is drawn as it arrives; one with a bad CRC,
+ *            or stalled for TILE_TIMEOUT_MS, returns "NACK:<seq>" (binary 'N')
+ *            and the receiver looks for the next 0xA5 header. On BMPEnd every
+ *            tile not received intact is NACKed again, followed by
+ *            "RESEND:<n>" (binary 'M', n tiles); the client sends those tiles
+ *            and BMPEnd again. COMPLETE follows once every tile has arrived.
+ *            CMD: lines may be sent between tiles.
+ *   BPP:<n> - Indexed color with n = 1, 2, 4 or 8 bits per pixel (16, the
+ *            default, is RGB565). Right after READY the client sends the
+ *            palette, 2^n RGB565 entries (big-endian, not counted by credits).
+ *            Every row (of the bitmap, a RECT, a MULTI row or a STREAM frame) is
+ *            then ceil(w * n / 8) bytes of palette indices, leftmost pixel in the
+ *            most significant bits. Rows are expanded to RGB565 as they arrive.
+ *            Not with RLE or TILE.
+ *   ROT:<n> - The frame was rendered for rotation n (0-3, as CMD:ORIENTATION)
+ *            instead of the display's current one, e.g. a cached or stored asset
+ *            after CMD:ORIENTATION. For the transfer the panel is addressed in
+ *            rotation n (MADCTL) and the frame is centered in the usable area as
+ *            seen in rotation n, so its rows burst out unchanged and it lands on
+ *            the panel pixels it would have had there. The size is checked
+ *            against the usable area in rotation n. Not with BMPStart:SNAPSHOT,
+ *            MULTI or the shadow framebuffer (CMD:SHADOW_ON).
+ * 
+ * MULTI: - Several displays in one transfer, no per-display handshake
+ * 1. Client: "MULTI:<name>,<w>,<h>[;<name>,<w>,<h>...][;RLE][;BINARY][;BPP:<n>]"
+ * 2. Arduino: "READY", "CREDITS:<n>" (flow control is always on)
+ * 3. Client: Row packets, interleaved in any order across displays: one
+ *    byte slot index (position in the MULTI list) followed by one row of
+ *    that display's bitmap (raw or RLE). Rows of a slot arrive in order;
+ *    each consumed row returns "CREDIT:1".
+ * 4. Client: "BMPEnd" after the last row of every slot
+ * 5. Arduino: "COMPLETE"; the previously selected display stays active
+ * 
+ * STREAM: - Animation session on one display, no handshake per frame
+ * 1. Client: "STREAM:<name>,<w>,<h>,<fps>[,RLE][,BINARY][,BPP:<n>][,ROT:<n>]" (fps 1-60, or 0 to
+ *    draw frames as fast as they arrive)
+ * 2. Arduino: clears the display, "READY", "CREDITS:<n>" (flow control is
+ *    always on and every consumed row returns "CREDIT:1")
+ * 3. Client, per frame: "FRAME" followed by w*h pixels, or "FRAME:<n>" followed
+ *    by n "RECT:x,y,w,h" rectangles with their pixels as in DELTA (n = 0
+ *    repeats the frame on screen). Frames may follow each other without
+ *    waiting for a reply.
+ * 4. The Arduino starts a frame no earlier than its slot (1/fps after the
+ *    previous one), which holds the client back through the credits. A frame
+ *    starting a whole slot late is counted as late and the schedule restarts
+ *    from it instead of hurrying the following frames. Once a second it
+ *    reports the achieved rate: "FPS:<x.y>" (binary: 'F', fps * 10).
+ * 5. Client: "STREAM_END" between frames
+ * 6. Arduino: "Stream: <n> frames, <x.y> fps (target <fps>), <l> late",
+ *    'F' with the achieved rate in BINARY, then "COMPLETE"; the display stays
+ *    selected. Like any transfer the session ends after TIMEOUT_MS of silence.
+ * 
+ * IMG: - Flash image store (needs a selected display or group for STORE/SHOW)
+ *   IMG:STORE:<id> - Use in place of BMPStart: the following SIZE / pixels /
+ *                    BMPEnd transfer is drawn and also saved under <id>
+ *                    (up to 15 characters; DELTA is not allowed). "STORED:<id>"
+ *                    precedes COMPLETE once the image is in flash.
+ *   IMG:SHOW:<id>  - Clear and draw a stored image centered, as a transfer would
+ *   IMG:SHOW:<id>,x,y - Draw it with its top-left corner at (x, y) over the
+ *                    current content (sprites); both clip to the frame bounds
+ *   IMG:SHOW:<id>[,x,y],ROT:<n> - Either form for an image stored with SIZE
+ *                    option ROT:<n> (x, y in rotation n's coordinates)
+ *   IMG:LIST       - List stored images and free space
+ *   IMG:DELETE:<id> - Remove a stored image
+ *   IMG:ERASE      - Remove all stored images
+ * 
+ * DRAW: - Primitives drawn on the device (needs a selected display or group)
+ * 1. Client: "DRAW:<n>" followed by n bytes (up to MAX_DRAW_BYTES) of ops, each
+ *    an op byte and int16 little-endian fields in display coordinates, colors
+ *    as RGB565 values:
+ *      'F' color                       - Fill the screen
+ *      'R' x, y, w, h, color           - Rectangle outline
+ *      'B' x, y, w, h, color           - Filled box
+ *      'L' x0, y0, x1, y1, color       - Line
+ *      'T' x, y, color, background, size (uint8), length (uint8), characters
+ *                                      - Text in the 6x8 GFX font times size,
+ *                                        no wrapping; background = color for none
+ * 2. Arduino: "OK:DRAW:<ops>" once everything is drawn, or "ERROR:..." (a
+ *    malformed list draws nothing). With a shadow framebuffer the result goes
+ *    out in one burst. Snapshots are not updated: CMD:REPAINT restores the image
+ *    under the primitives.
  */
 
 #ifndef SERIAL_PROTOCOL_H
@@ -34,21 +172,79 @@
 
 #include <Arduino.h>
 #include "DisplayManager.h"
+#include "ImageStore.h"
+#include "CommandParser.h"
 
 // Protocol states
 enum ProtocolState {
     WAITING_FOR_DISPLAY_SELECT,
     WAITING_FOR_START,
     WAITING_FOR_SIZE,
+    RECEIVING_PALETTE,
     RECEIVING_DATA,
+    WAITING_FOR_RECT,
+    WAITING_FOR_ROW_TAG,
     WAITING_FOR_END,
+    WAITING_FOR_FRAME,
+    WAITING_FOR_TILE,
+    WAITING_FOR_TILE_CRC,
+    RECEIVING_DRAW_LIST,
     BITMAP_COMPLETE
 };
 
+// Binary status packets (SIZE option BINARY): STATUS_SYNC, type, uint16 value (LE)
+enum StatusType : uint8_t {
+    STATUS_READY = 'R',
+    STATUS_CREDIT = 'C',
+    STATUS_PROGRESS = 'P',
+    STATUS_STORED = 'S',
+    STATUS_COMPLETE = 'K',
+    STATUS_FPS = 'F',
+    STATUS_NACK = 'N',
+    STATUS_RESEND = 'M',
+    STATUS_ERROR = 'E'
+};
+
+// Display-list ops (DRAW:)
+enum DrawOp : uint8_t {
+    DRAW_FILL = 'F',
+    DRAW_RECT = 'R',
+    DRAW_BOX = 'B',
+    DRAW_LINE = 'L',
+    DRAW_TEXT = 'T'
+};
+
+// Value of a STATUS_ERROR packet
+enum StatusError : uint16_t {
+    STATUS_ERROR_PROTOCOL = 1,      // Unexpected command for the state
+    STATUS_ERROR_OPTION = 2,        // Unknown or conflicting transfer option
+    STATUS_ERROR_DIMENSIONS = 3,    // Bitmap does not fit the display or row buffer
+    STATUS_ERROR_DISPLAY = 4,       // No (such) display
+    STATUS_ERROR_RLE = 5,           // Malformed RLE packet
+    STATUS_ERROR_RECT = 6,          // Malformed or out-of-bounds RECT
+    STATUS_ERROR_MULTI = 7,         // Bad MULTI slot or row tag
+    STATUS_ERROR_STORE = 8,         // Image store full or write failed
+    STATUS_ERROR_TIMEOUT = 9        // No data within TIMEOUT_MS
+};
+
+// Placement of one display in a MULTI transfer or display group
+struct MultiSlot {
+    DisplayInstance* display;
+    int width;
+    int height;
+    int offsetX;
+    int offsetY;
+    int16_t clipLeft;
+    int16_t clipTop;
+    int16_t clipRight;
+    int16_t clipBottom;
+    int row;                // Next row expected for this slot (MULTI)
+};
+
 // Protocol handler class
 class SerialProtocol {
 public:
-    SerialProtocol(DisplayManager& displayMgr, Stream& serial);
+    SerialProtocol(DisplayManager& displayMgr, Stream& serial, ImageStore* imageStore = nullptr);
     
     // Main processing
     void process();
@@ -66,13 +262,28 @@ public:
 private:
     // Protocol constants
     static const unsigned long TIMEOUT_MS = 15000;         // 15 second timeout
-    static const unsigned long DISPLAY_SELECT_TIMEOUT = 3000;  // 3 second timeout for display selection
     static const unsigned long READY_TIMEOUT = 5000;       // 5 second timeout for READY response
     static const int MAX_DIMENSION = 1000;                 // Maximum bitmap dimension
     static const int PROGRESS_REPORT_INTERVAL = 10;        // Report progress every N rows
+    static const uint8_t STATUS_SYNC = 0xFF;               // First byte of a binary status packet
+    static const int MAX_ROW_PIXELS = 256;                 // Row burst buffer capacity (pixels)
+    static const int ROW_BUFFER_COUNT = 2;                 // Double-buffered: fill one while DMA drains the other
+    static const int FLOW_CONTROL_CREDITS = 4;             // Rows the host may send ahead (row buffers + USB FIFO)
+    static const int MAX_MULTI_SLOTS = 8;                  // Displays per MULTI transfer (registry capacity)
+    static const int MAX_LINE_LENGTH = 255;                // Longest command line (MULTI specs, groups)
+    static const int MAX_BATCH_COMMANDS = 16;              // Commands in one CMD:BATCH
+    static const int MAX_STREAM_FPS = 60;                  // Highest STREAM target frame rate
+    static const unsigned long FPS_REPORT_INTERVAL = 1000000UL;  // STREAM rate report period (us)
+    static const int TILE_SIZE = 16;                       // TILE transfers: tile edge (pixels)
+    static const int MAX_TILES = 256;                      // Tiles per TILE transfer (256x256 pixels)
+    static const uint8_t TILE_SYNC = 0xA5;                 // First byte of a tile packet
+    static const unsigned long TILE_TIMEOUT_MS = 250;      // Stall that abandons a partly received tile
+    static const int MAX_DRAW_BYTES = ROW_BUFFER_COUNT * MAX_ROW_PIXELS * 2;  // DRAW: list, staged in the row buffers
+    static const uint8_t NO_FRAME_ROTATION = 0xFF;         // Frame rendered for the display's own rotation
     
     DisplayManager& displayManager;
     Stream& serialPort;
+    ImageStore* imageStore;     // Optional; IMG: commands report an error without one
     
     // State
     ProtocolState currentState;
@@ -81,11 +292,115 @@ private:
     // Bitmap reception state
     int bitmapWidth;
     int bitmapHeight;
-    int currentRow;
-    int currentCol;
+    int currentRow;         // Row within the current rectangle
+    int rowBytesReceived;   // Bytes of the current row staged so far
     int offsetX;
     int offsetY;
     
+    // Rectangle (bitmap coordinates) currently being received; the whole
+    // bitmap for a full frame, one dirty rectangle in delta mode
+    int rectX;
+    int rectY;
+    int rectWidth;
+    int rectHeight;
+    
+    // Row burst state: one row is staged, clipped once and blitted in one transaction.
+    // While a finished row is clocked out by DMA, the next one fills the other buffer.
+    uint16_t rowBuffers[ROW_BUFFER_COUNT][MAX_ROW_PIXELS];  // Display (big-endian) byte order
+    uint16_t* rowBuffer;                                    // Buffer currently being filled
+    uint8_t rowBufferIndex;
+    int16_t clipLeft;
+    int16_t clipTop;
+    int16_t clipRight;
+    int16_t clipBottom;
+    
+    // Throughput measurement for the most recent pixel transfer
+    uint32_t transferBytes;
+    unsigned long transferStartMicros;
+    unsigned long transferMicros;
+    
+    // Credit-based flow control (SIZE option CREDIT)
+    bool flowControlEnabled;
+    
+    // Dirty-rectangle updates (SIZE option DELTA)
+    bool deltaMode;
+    
+    // Run-length decoding (SIZE option RLE)
+    bool rleEnabled;
+    bool rlePacketIsRun;
+    int rlePacketPixels;        // Pixels in the current packet, 0 while waiting for a header
+    int rlePacketBytes;         // Payload bytes of the current packet received so far
+    uint8_t rleRunValue[2];     // Run pixel as received (big-endian)
+    bool rowIsFlat;             // Current row is one run; it is filled rather than blitted
+    
+    // Indexed color (SIZE option BPP:<n>): rows arrive as packed indices and are
+    // expanded through the palette into the row buffer
+    uint8_t bitsPerPixel;               // 16 = RGB565
+    uint16_t palette[256];              // Display (big-endian) byte order
+    uint8_t packedRow[MAX_ROW_PIXELS];
+    int paletteBytesReceived;
+    ProtocolState paletteNextState;     // Where reception continues after the palette
+    
+    // Consecutive flat rows of one color, filled with a single fillRect()
+    int fillY;
+    int fillRows;
+    uint16_t fillColor;
+    
+    // Multi-display transfer (MULTI:); multiSlotCount is 0 outside of one
+    MultiSlot multiSlots[MAX_MULTI_SLOTS];
+    uint8_t multiSlotCount;
+    uint8_t multiSlot;                   // Slot of the row being received
+    long multiRowsRemaining;
+    DisplayInstance* multiPreviousDisplay;
+    DisplayGroup* multiPreviousGroup;
+    
+    // Display group target (DISPLAY:GROUP:); every decoded row goes to each member
+    DisplayGroup* activeGroup;
+    MultiSlot groupSlots[DisplayGroup::MAX_MEMBERS];
+    
+    // Animation session (STREAM:); frames start on a 1/fps schedule
+    bool streamActive;
+    uint8_t streamFps;
+    unsigned long streamInterval;       // Microseconds per frame, 0 = unpaced
+    unsigned long streamDue;            // Earliest start of the next frame
+    unsigned long streamFirstStart;     // micros() at the first and latest frame start
+    unsigned long streamLastStart;
+    unsigned long streamReportStart;    // Start of the current FPS report window
+    uint32_t streamFrames;
+    uint32_t streamReportFrames;
+    uint32_t streamLateFrames;
+    int streamRectsRemaining;           // Rectangles left in the current FRAME:<n>
+    bool streamFrameHeld;               // FRAME line waiting in lineBuffer for its slot
+    
+    // Checked tiles (SIZE option TILE)
+    bool tilesEnabled;
+    int tileColumns;
+    int tileCount;
+    uint16_t tileSeq;                   // Tile being received
+    uint16_t tileCrc;                   // CRC of it so far
+    uint8_t tileBytes[2];               // Header seq or trailing CRC as received
+    uint8_t tileBytesReceived;          // 0 while scanning for TILE_SYNC
+    uint8_t tilesVerified[MAX_TILES / 8];
+    
+    // Display list being received (DRAW:); no transfer runs meanwhile, so it is
+    // staged in the row buffers
+    int drawBytesExpected;
+    int drawBytesReceived;
+    
+    // Id the current transfer is saved under (IMG:STORE:); empty otherwise
+    String storeImageId;
+    
+    // Current transfer was started with BMPStart:SNAPSHOT
+    bool snapshotRequested;
+    
+    // Rotation the current frame was rendered for (SIZE option ROT), or NO_FRAME_ROTATION
+    uint8_t frameRotation;
+    
+    // Command line being assembled across process() calls
+    char lineBuffer[MAX_LINE_LENGTH + 1];
+    int lineLength;
+    bool lineOverflow;          // Rest of the current line is dropped
+    
     // Timeout tracking
     unsigned long lastActivity;
     
@@ -100,21 +415,78 @@ private:
     int8_t usableAreaAdjustLeft;
     int8_t usableAreaAdjustRight;
     
+    // Binary status channel for the current transfer (SIZE/MULTI option BINARY)
+    bool binaryStatus;
+    bool debugText;             // CMD:DEBUG_ON: text status as well
+    
+    // CMD:BATCH in progress: replies go to batchReply, frame redraws and
+    // snapshot repaints are deferred (the later of the two wins)
+    ReplyCapture batchReply;
+    bool batchActive;
+    bool batchRedraw;
+    bool batchRepaint;
+    
     // Protocol handlers
-    void handleDisplaySelect();
-    void handleMenuCommand(const String& command);
-    void handleStart();
-    void handleSize();
+    bool readLine();
+    void handleDisplaySelect(const String& command);
+    void handleMenuCommand(char* command);
+    void runMenuCommand(uint8_t id, CommandTokens& tokens);
+    void runBatch(CommandTokens& tokens);
+    void redrawCalibrationFrame();
+    void repaintSnapshot(DisplayInstance* target);
+    void handleImageCommand(const String& command);
+    void showStoredImage(const String& spec);
+    void handleDraw(const String& params);
+    void handleDrawReception();
+    void runDisplayList();
+    void handleStart(const String& command);
+    void handleSize(const String& sizeCommand);
     void handleDataReception();
-    void handleEnd();
+    void handleRleReception();
+    void beginPalette();
+    void handlePaletteReception();
+    void expandIndexedRow();
+    void handleRect(const String& command);
+    void handleMulti(const String& spec);
+    void handleRowTag();
+    void handleTileStream();
+    void handleTileCrc();
+    void startTile(uint16_t seq);
+    void abandonTile();
+    void finishTiles();
+    void sendNack(uint16_t seq);
+    void handleStream(const String& spec);
+    bool streamFrameDue() const;
+    void handleStreamFrame(const String& command);
+    void startStreamFrame();
+    void loadSlot(const MultiSlot& slot);
+    bool placeGroupMembers();
+    void handleEnd(const String& endCommand);
     void handleComplete();
+    void completeRow();
+    void blitRow();
+    void queueFlatRow(uint16_t color);
+    void flushFill();
+    bool snapshotArea(const MultiSlot& slot, int& x, int& y, int& width, int& height);
+    void prepareGroupSnapshots();
+    void prepareSnapshot(const MultiSlot& slot);
+    bool beginFrameRotation();
+    void endFrameRotation();
+    void beginRect(int x, int y, int width, int height);
+    void sendReady();
+    void finishBitmap();
     
     // Validation
+    bool parseSizeOptions(const String& options);
     bool validateDimensions(int width, int height);
     bool calculateOffsets(int bmpWidth, int bmpHeight, int& offsetX, int& offsetY);
     
     // Error handling
-    void sendError(const String& message);
+    void sendError(const String& message, uint16_t code = STATUS_ERROR_PROTOCOL);
+    void sendStatus(uint8_t type, uint16_t value);
+    
+    // Text status lines are sent unless the transfer negotiated BINARY (debug mode keeps them)
+    bool textStatus() const { return !binaryStatus || debugText; }
 };
 
 #endif // SERIAL_PROTOCOL_H
@@ -8,6 +8,7 @@
  * - Runtime display selection via serial protocol
  * - Unified protocol with CMD: and DISPLAY: command routing
  * - Single Native USB port (/dev/ttyACM0) for all communications
+ * - Flash image store for instant recall of stored screens (IMG:)
  * 
  * Configuration:
  * - All displays auto-configured from .config files
@@ -32,9 +33,12 @@
 #include "DisplayConfig.h"
 #include "DisplayManager.h"
 #include "SerialProtocol.h"
+#include "ImageStore.h"
+#include "PerfStats.h"
 
 // Global managers
 DisplayManager displayManager;
+ImageStore imageStore;
 SerialProtocol* protocol = nullptr;
 
 void setup() {
@@ -73,8 +77,22 @@ void setup() {
   displayManager.showAllTestPatterns();
   SerialUSB.println("✓ Test patterns displayed");
   
+  // Load the index of images kept in flash
+  if (imageStore.begin()) {
+    SerialUSB.print("✓ Image store: ");
+    SerialUSB.print(imageStore.getImageCount());
+    SerialUSB.print(" image(s), ");
+    SerialUSB.print(imageStore.getFreeBytes());
+    SerialUSB.println(" bytes free");
+  } else {
+    SerialUSB.println("⚠ Image store unavailable (firmware overlaps the flash region)");
+  }
+  
+  // Start the cycle counter behind CMD:STATS
+  PerfStats::begin();
+  
   // Initialize protocol handler with SerialUSB
-  protocol = new SerialProtocol(displayManager, SerialUSB);
+  protocol = new SerialProtocol(displayManager, SerialUSB, &imageStore);
   
   SerialUSB.println("\n===========================================");
   SerialUSB.println("System ready!");
@@ -86,16 +104,16 @@ void setup() {
   SerialUSB.println("  CMD:HELP - Show all available commands");
   SerialUSB.println("  CMD:LIST - List displays");
   SerialUSB.println("  DISPLAY:<name> - Select display for bitmap");
+  SerialUSB.println("  IMG:LIST - List images stored in flash");
   SerialUSB.println();
 }
 
 void loop() {
+  PerfStats::loopTick();
+  
   // Protocol processing handles all commands (CMD: and DISPLAY:)
   if (protocol) {
     protocol->process();
     protocol->checkTimeout();
   }
-  
-  // Small delay to prevent overwhelming the processor
-  delay(1);
 }
@@ -0,0 +1,133 @@
+"""
+ST7735 Frame Cache
+On-disk cache of images already resized and converted to RGB565 for a display
+"""
+
+import hashlib
+import mmap
+import os
+import struct
+import tempfile
+from pathlib import Path
+from typing import Optional, Tuple
+
+
+# Default cache location (XDG cache directory)
+CACHE_DIR = Path(os.environ.get('XDG_CACHE_HOME', Path.home() / '.cache')) / 'st7735' / 'frames'
+
+# Bump when the conversion (resize, crop, RGB565 packing) changes output
+CACHE_VERSION = 1
+
+# File layout: header followed by width * height big-endian RGB565 pixels
+MAGIC = b'ST7F'
+HEADER = struct.Struct('<4sHHH')  # magic, version, width, height
+
+
+def image_hash(image_path: str) -> str:
+    """
+    Hash the contents of an image file
+
+    Args:
+        image_path: Path to image file
+
+    Returns:
+        SHA-256 hex digest of the file
+    """
+    digest = hashlib.sha256()
+    with open(image_path, 'rb') as f:
+        for block in iter(lambda: f.read(1 << 20), b''):
+            digest.update(block)
+    return digest.hexdigest()
+
+
+def geometry_key(display_size: Tuple[int, int], display_config=None) -> str:
+    """
+    Describe the target geometry a frame was prepared for
+
+    Args:
+        display_size: (width, height) the image was fitted to
+        display_config: DisplayConfig from config_loader (optional)
+
+    Returns:
+        Key fragment covering size, orientation and usable area
+    """
+    parts = [f"{display_size[0]}x{display_size[1]}"]
+    if display_config:
+        cal = display_config.calibration
+        parts.append(display_config.orientation)
+        parts.append(f"{cal['left']},{cal['right']},{cal['top']},{cal['bottom']}")
+    return ';'.join(parts)
+
+
+class FrameCache:
+    """Ready-to-send RGB565 frames keyed by image content and target geometry"""
+
+    def __init__(self, cache_dir: Optional[Path] = None):
+        """
+        Args:
+            cache_dir: Directory for cached frames (default: ~/.cache/st7735/frames)
+        """
+        self.cache_dir = Path(cache_dir) if cache_dir else CACHE_DIR
+
+    def key(self, image_path: str, display_size: Tuple[int, int], display_config=None) -> str:
+        """Cache key for an image prepared for the given display geometry"""
+        material = f"v{CACHE_VERSION};{image_hash(image_path)};{geometry_key(display_size, display_config)}"
+        return hashlib.sha256(material.encode('utf-8')).hexdigest()
+
+    def path(self, key: str) -> Path:
+        """File holding the frame for a key"""
+        return self.cache_dir / f"{key}.rgb565"
+
+    def load(self, key: str) -> Optional[Tuple[int, int, bytes]]:
+        """
+        Read a cached frame
+
+        The file is memory-mapped only while the pixels are copied out, so no
+        mapping or file handle outlives the call.
+
+        Args:
+            key: Cache key from key()
+
+        Returns:
+            (width, height, pixel_bytes), or None if not cached (or the entry
+            is invalid)
+        """
+        try:
+            with open(self.path(key), 'rb') as f:
+                mapped = mmap.mmap(f.fileno(), 0, access=mmap.ACCESS_READ)
+        except (OSError, ValueError):
+            return None
+
+        with mapped:
+            if len(mapped) < HEADER.size:
+                return None
+            magic, version, width, height = HEADER.unpack_from(mapped)
+            if magic != MAGIC or version != CACHE_VERSION or len(mapped) != HEADER.size + width * height * 2:
+                return None
+            return width, height, mapped[HEADER.size:]
+
+    def store(self, key: str, width: int, height: int, pixel_bytes: bytes) -> bool:
+        """
+        Write a frame to the cache
+
+        The file is written under a temporary name and renamed into place, so
+        readers never map a partial entry.
+
+        Returns:
+            True if stored, False on error (the cache is best effort)
+        """
+        try:
+            self.cache_dir.mkdir(parents=True, exist_ok=True)
+            fd, tmp_path = tempfile.mkstemp(dir=self.cache_dir, suffix='.tmp')
+            try:
+                with os.fdopen(fd, 'wb') as f:
+                    f.write(HEADER.pack(MAGIC, CACHE_VERSION, width, height))
+                    f.write(pixel_bytes)
+                os.replace(tmp_path, self.path(key))
+            except BaseException:
+                os.unlink(tmp_path)
+                raise
+            return True
+        except OSError as e:
+            print(f"Warning: Could not write frame cache: {e}")
+            return False